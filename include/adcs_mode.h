@@ -0,0 +1,124 @@
+#ifndef ADCS_MODE_H
+#define ADCS_MODE_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+struct SimulationState;
+
+enum class AdcsMode { DETUMBLE, SUN_ACQUIRE, NADIR };
+
+const char* adcsModeName(AdcsMode mode);
+
+struct AdcsConfig
+{
+    float controlRate { 10.0f };             // Hz, mode logic and control laws run once per cycle
+    AdcsMode initialMode { AdcsMode::DETUMBLE };
+
+    // Detumble (B-dot on magnetorquers)
+    float bdotGain { 5.0e4f };               // A*m^2 per T/s
+    float maxDipole { 0.02f };               // A*m^2 per axis
+    float detumbleExitRate { 0.009f };       // rad/s (~0.5 deg/s)
+    float detumbleEntryRate { 0.15f };       // rad/s (~8.6 deg/s), any mode falls back above this
+
+    // Sun acquisition (reaction wheels), a rate-limited slew
+    glm::vec3 sunAxisBody { 1.0f, 0.0f, 0.0f }; // Body axis pointed at the Sun
+    float sunSlewGain { 0.15f };             // rad/s of commanded rate per rad of error
+    float sunSlewRate { 0.02f };             // rad/s, slew rate limit
+    float sunRateGain { 6.0e-4f };           // N*m/(rad/s)
+    float sunAcquiredAngle { 0.1745f };      // rad (10 deg)
+
+    float torqueLimit { 0.002f };            // N*m, wheel command clamp
+    float wheelSpeedGain { 1.0e-3f };        // N*m per rad/s of error, commanded wheel speeds
+    float dwellTime { 30.0f };               // s a transition condition must hold
+};
+
+struct ActuatorCommand
+{
+    glm::vec3 wheelTorque { 0.0f }; // World frame, same convention as computeNadirTorque
+    glm::vec3 dipole { 0.0f };      // Body frame magnetorquer dipole
+};
+
+// Mode state machine: DETUMBLE -> SUN_ACQUIRE -> NADIR, with a fall back to DETUMBLE
+// if the body rate ever exceeds detumbleEntryRate. Transitions and control laws are
+// evaluated once per control cycle; the command is held between cycles.
+//
+// Ground commands can override two setpoints until cleared: an inertial attitude target,
+// which NADIR mode holds instead of nadir, and per-wheel speeds, which replace the wheel
+// torque of whatever mode is active (the magnetorquers still follow the mode; the body
+// absorbs whatever momentum the wheels gain). Both are dropped if the body rate ever
+// exceeds detumbleEntryRate.
+class ModeManager
+{
+public:
+    ModeManager(const AdcsConfig& config = AdcsConfig {});
+
+    const ActuatorCommand& update(const SimulationState& state, float dt);
+
+    void setMode(AdcsMode mode);
+
+    void setAttitudeTarget(const glm::quat& target); // Body-to-world
+    void clearAttitudeTarget();
+    void setWheelSpeedTarget(const glm::vec3& speeds); // rad/s, wheels 0, 1, 2
+    void clearWheelSpeedTarget();
+
+    AdcsMode getMode() const;
+    double getTime() const; // s of updates since construction, not the simulation clock
+    double getModeEntryTime() const;
+    double getNadirEntryTime() const; // Negative until NADIR is first reached
+    const ActuatorCommand& getCommand() const;
+    const AdcsConfig& getConfig() const;
+    bool hasAttitudeTarget() const;
+    bool hasWheelSpeedTarget() const;
+
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        ar.value(m_config);
+        ar.value(m_mode);
+        ar.value(m_command);
+        ar.value(m_time);
+        ar.value(m_cycleAccum);
+        ar.value(m_modeEntryTime);
+        ar.value(m_nadirEntryTime);
+        ar.value(m_conditionSince);
+        ar.value(m_prevMag);
+        ar.value(m_prevMagTime);
+        ar.value(m_magRate);
+        ar.value(m_attitudeTarget);
+        ar.value(m_hasAttitudeTarget);
+        ar.value(m_wheelSpeedTarget);
+        ar.value(m_hasWheelSpeedTarget);
+    }
+
+private:
+    void runCycle(const SimulationState& state);
+    void evaluateTransitions(float bodyRate, float sunAngle, bool sunVisible);
+    void requestMode(AdcsMode mode, bool condition);
+
+    AdcsConfig m_config;
+    AdcsMode m_mode;
+    ActuatorCommand m_command;
+
+    double m_time { 0.0 };
+    double m_cycleAccum { 0.0 };
+    double m_modeEntryTime { 0.0 };
+    double m_nadirEntryTime { -1.0 };
+    double m_conditionSince { -1.0 };
+
+    glm::vec3 m_prevMag { 0.0f };
+    double m_prevMagTime { -1.0 }; // On the sensors' clock
+    glm::vec3 m_magRate { 0.0f };
+
+    glm::quat m_attitudeTarget { 1.0f, 0.0f, 0.0f, 0.0f };
+    bool m_hasAttitudeTarget { false };
+    glm::vec3 m_wheelSpeedTarget { 0.0f };
+    bool m_hasWheelSpeedTarget { false };
+};
+
+// World-frame torque produced by a body-frame dipole in the local geomagnetic field
+glm::vec3 computeMagnetorquerTorque(const SimulationState& state, const glm::vec3& dipole);
+
+#endif
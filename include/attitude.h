@@ -5,7 +5,8 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
-#include "simulation_state.h"
+
+struct SimulationState;
 
 inline const glm::mat3 CUBESAT_INERTIA = glm::mat3(
     0.0010f, 0.0f,    0.0f,
@@ -0,0 +1,46 @@
+#ifndef CCSDS_H
+#define CCSDS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CCSDS space packets (CCSDS 133.0-B-2), telemetry type, unsegmented, always with a
+// secondary header holding the packet time as a CCSDS unsegmented time code
+// (CCSDS 301.0-B-4): 4 octets of seconds and 2 of binary fraction, P-field implicit.
+// All fields big-endian, as on the wire.
+inline constexpr std::size_t CCSDS_PRIMARY_HEADER_SIZE { 6 };
+inline constexpr std::size_t CCSDS_TIME_CODE_SIZE { 6 };
+inline constexpr std::size_t CCSDS_HEADERS_SIZE { CCSDS_PRIMARY_HEADER_SIZE + CCSDS_TIME_CODE_SIZE };
+inline constexpr std::size_t CCSDS_MAX_PACKET_SIZE { CCSDS_PRIMARY_HEADER_SIZE + 65536 };
+
+inline constexpr std::uint16_t CCSDS_APID_MASK { 0x07FF };
+inline constexpr std::uint16_t CCSDS_IDLE_APID { 0x07FF };
+inline constexpr std::uint16_t CCSDS_SEQUENCE_MASK { 0x3FFF };
+
+struct CcsdsPacketInfo
+{
+    std::uint16_t apid { 0 };
+    std::uint16_t sequenceCount { 0 };
+    double time { 0.0 };              // s, from the secondary header
+    const std::uint8_t* data { nullptr }; // User data after the secondary header
+    std::size_t dataSize { 0 };
+    std::size_t packetSize { 0 };     // Headers and data
+};
+
+// Writes headers and `dataSize` bytes of user data into `out` (CCSDS_HEADERS_SIZE +
+// dataSize bytes, which must be at least 1); returns the packet size. `data` may
+// already sit at out + CCSDS_HEADERS_SIZE, in which case nothing is copied.
+std::size_t writeSpacePacket(std::uint8_t* out, std::uint16_t apid, std::uint16_t sequenceCount, double time,
+                             const std::uint8_t* data, std::size_t dataSize);
+
+// Checks version, type, secondary header flag, sequence flags and that the length field
+// fits within `size`; trailing bytes beyond the packet are left to the caller
+bool parseSpacePacket(const std::uint8_t* packet, std::size_t size, CcsdsPacketInfo& info);
+
+// Big-endian field helpers for user data
+void putBigEndian(std::uint8_t* out, std::uint32_t value);
+void putBigEndian(std::uint8_t* out, float value);
+std::uint32_t getBigEndian32(const std::uint8_t* in);
+float getBigEndianFloat(const std::uint8_t* in);
+
+#endif
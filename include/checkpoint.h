@@ -0,0 +1,89 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct SimulationState;
+
+// Bumped whenever the member list of any checkpointed class changes; older snapshots
+// are rejected rather than misread
+inline constexpr std::uint32_t CHECKPOINT_VERSION { 6 };
+
+// Classes with private state define `template <typename Archive> void checkpoint(Archive& ar)`
+// that passes each member to ar.value() (trivially copyable data) or ar.object()
+// (nested checkpointable classes). The one member list then drives both directions.
+class CheckpointWriter
+{
+public:
+    template <typename T>
+    void value(const T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpointed values are copied as raw bytes");
+        const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(&v);
+        m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    // checkpoint() only reads members when handed a writer
+    template <typename T>
+    void object(const T& obj) { const_cast<T&>(obj).checkpoint(*this); }
+
+    std::vector<std::uint8_t>& data() { return m_data; }
+
+private:
+    std::vector<std::uint8_t> m_data;
+};
+
+class CheckpointReader
+{
+public:
+    CheckpointReader(const std::uint8_t* data, std::size_t size) : m_data { data }, m_size { size } {}
+
+    template <typename T>
+    void value(T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpointed values are copied as raw bytes");
+        if (m_pos + sizeof(T) > m_size)
+        {
+            m_ok = false;
+            return;
+        }
+        std::memcpy(&v, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+    }
+
+    template <typename T>
+    void object(T& obj) { obj.checkpoint(*this); }
+
+    bool ok() const { return m_ok; } // False once any read ran past the end
+    bool atEnd() const { return m_pos == m_size; }
+
+private:
+    const std::uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_pos { 0 };
+    bool m_ok { true };
+};
+
+// Snapshot of everything that evolves during a run: the rigid body and orbit, wheels,
+// sensors (noise stream positions, biases, samples still in their delay lines),
+// estimator and ADCS mode manager. The `pil`, `events`, `recorder`, `downlink` and
+// `telecommands` hooks are not part of it; deserializeState leaves the target's hooks as
+// they were. The format is "CSCK",
+// uint32 version, uint32 payload size, payload, then a CRC-32 of the payload, all in
+// host byte order, so snapshots move between machines of the same architecture only.
+std::vector<std::uint8_t> serializeState(const SimulationState& state);
+
+// Returns false, leaving `state` untouched, on a bad magic, version, size or CRC
+bool deserializeState(const std::vector<std::uint8_t>& snapshot, SimulationState& state);
+
+// Written to `path`.tmp and renamed over `path`, so a run preempted mid-write still
+// finds the previous snapshot intact
+bool saveCheckpoint(const std::string& path, const SimulationState& state);
+bool loadCheckpoint(const std::string& path, SimulationState& state);
+
+#endif
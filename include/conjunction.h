@@ -0,0 +1,59 @@
+#ifndef CONJUNCTION_H
+#define CONJUNCTION_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "orbit_math.h"
+
+struct ConjunctionConfig
+{
+    double screeningDistance { 5000.0 }; // m, report approaches closer than this
+    double startTime { 0.0 };            // s
+    double duration { 86400.0 };         // s
+    double step { 30.0 };                // s, broad phase interval
+    double timeTolerance { 1.0e-3 };     // s, TCA refinement
+    int stepsPerTask { 64 };             // Consecutive steps one worker screens, reusing positions
+    unsigned int threads { 0 };          // 0 = all hardware threads
+};
+
+struct Conjunction
+{
+    int first { 0 };
+    int second { 0 };
+    double tca { 0.0 };            // s, time of closest approach
+    double missDistance { 0.0 };   // m
+    double relativeSpeed { 0.0 };  // m/s at TCA
+};
+
+struct ConjunctionStats
+{
+    std::size_t broadPhasePairs { 0 }; // Pairs sharing a grid cell
+    std::size_t shellPairs { 0 };      // Of those, pairs whose perigee/apogee shells overlap
+    std::size_t narrowPhasePairs { 0 }; // Of those, pairs with a range minimum inside the step
+    std::size_t cellChecks { 0 };       // Objects compared with their cells one step earlier
+    std::size_t cellChanges { 0 };      // Of those, objects whose cells had changed
+};
+
+// Screens every pair of `objects` (epoch states, propagated with KeplerPropagator).
+//
+// Broad phase: each step, every object's swept box (both end positions, padded by the
+// arc's bulge and half the screening distance) goes into a uniform grid whose cells
+// are at least one box wide, so an object touches at most eight cells. The grid is a
+// counting sort into a fixed hash table whose storage is reused from step to step, and
+// is rebuilt in full each step since almost every object changes cells between steps.
+// Pairs sharing a cell are then filtered on their perigee/apogee shells.
+//
+// Narrow phase: a range minimum inside the step shows up as r.v changing sign from
+// negative to positive; Brent's method locates it, and the pair is reported if the
+// miss distance is under the screening distance.
+//
+// Steps are screened in parallel; the result is sorted by TCA.
+std::vector<Conjunction> screenConjunctions(const std::vector<OrbitSample>& objects,
+                                            const ConjunctionConfig& config,
+                                            ConjunctionStats* stats = nullptr);
+
+void writeConjunctionCsv(std::ostream& out, const std::vector<Conjunction>& conjunctions);
+
+#endif
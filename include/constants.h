@@ -30,6 +30,9 @@ namespace Physics
 
     inline constexpr float ORBIT_ALTITUDE { 4.0e5f }; // 400 km 
     inline constexpr float ORBIT_ALTITUDE_SCALED { 4.0e5f * SCALE_FACTOR };
+
+    inline constexpr float EARTH_AXIAL_TILT_DEG { 23.5f };
+    inline constexpr float EARTH_DIPOLE_FIELD { 3.12e-5f }; // Tesla, at the equator
 };
 
 namespace RenderSettings
@@ -0,0 +1,51 @@
+#ifndef CONTACT_WINDOWS_H
+#define CONTACT_WINDOWS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "orbit_math.h"
+
+struct GroundStation
+{
+    std::string name;
+    double latitude { 0.0 };     // rad
+    double longitude { 0.0 };    // rad
+    double altitude { 0.0 };     // m
+    double minElevation { 0.0873 }; // rad (5 deg) mask
+};
+
+std::vector<GroundStation> defaultGroundStations();
+
+struct ContactWindow
+{
+    int satellite { 0 };
+    int station { 0 };
+    double aos { 0.0 };             // s, clamped to the search start if already in view
+    double los { 0.0 };             // s, clamped to the search end if still in view
+    double maxElevation { 0.0 };    // rad
+    double maxElevationTime { 0.0 }; // s
+};
+
+struct ContactConfig
+{
+    double startTime { 0.0 };        // s
+    double duration { 7.0 * 86400.0 }; // s
+    double coarseStep { 20.0 };      // s, must be shorter than the briefest pass worth finding
+    double timeTolerance { 0.01 };   // s, AOS/LOS refinement
+    unsigned int threads { 0 };      // 0 = all hardware threads
+};
+
+// Samples every satellite/station elevation margin on a coarse grid, then refines each
+// sign change with Brent's method and each pass maximum with a golden section search.
+// `satellites` are epoch states, propagated with KeplerPropagator. Satellites run in
+// parallel; the result is sorted by AOS.
+std::vector<ContactWindow> computeContactWindows(const std::vector<OrbitSample>& satellites,
+                                                 const std::vector<GroundStation>& stations,
+                                                 const ContactConfig& config);
+
+void writeContactCsv(std::ostream& out, const std::vector<ContactWindow>& windows,
+                     const std::vector<GroundStation>& stations);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef COVERAGE_MAP_H
+#define COVERAGE_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "orbit_math.h"
+
+struct CoverageConfig
+{
+    int width { 720 };                 // Equirectangular cells in longitude, from -180 deg eastwards
+    int height { 360 };                // Cells in latitude, from +90 deg (top row) southwards
+    double startTime { 0.0 };          // s
+    double duration { 86400.0 };       // s
+    double step { 10.0 };              // s between footprint samples
+    double minElevation { 0.1745 };    // rad (10 deg), a cell is covered while a satellite is above this
+    std::size_t stepsPerTask { 512 };  // Time steps per parallel task
+    unsigned int threads { 0 };        // 0 = all hardware threads
+};
+
+// Per-cell layers, row-major from the top row. Covered counts the union over the
+// constellation, so overlapping footprints are not double counted.
+struct CoverageMap
+{
+    int width { 0 };
+    int height { 0 };
+    double startTime { 0.0 };
+    double step { 0.0 };
+    std::uint32_t steps { 0 };
+
+    std::vector<std::uint32_t> groundTrack;  // Sub-satellite point samples landing in the cell
+    std::vector<std::uint32_t> coveredSteps; // Steps with at least one satellite in view
+    std::vector<std::uint32_t> accesses;     // Distinct coverage intervals (revisits)
+
+    double coverageFraction(std::size_t cell) const;
+    double globalCoverage() const;        // Area weighted mean of coverageFraction
+    double meanRevisitInterval() const;   // s, area weighted over cells with at least one access
+};
+
+// Projects every satellite's footprint onto the grid at each step. `satellites` are
+// epoch states, propagated with KeplerPropagator on a spherical rotating Earth. Time
+// is split into blocks that run in parallel, each worker filling its own grids; the
+// grids are summed at the end and accesses that straddle a block edge are joined.
+CoverageMap computeCoverageMap(const std::vector<OrbitSample>& satellites, const CoverageConfig& config);
+
+// Coverage fraction as a colour ramp with the ground track drawn over it
+bool writeCoveragePng(const std::string& path, const CoverageMap& map);
+
+// "CVRG", then uint32 version, width, height, steps, double startTime, step, then the
+// groundTrack, coveredSteps and accesses layers as uint32 arrays. Host byte order.
+bool writeCoverageRaster(const std::string& path, const CoverageMap& map);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include <glm/glm.hpp>
+
+#include "simulation_state.h"
+
+// Unit vector of Earth's spin axis (matches the tilt used by renderEarth)
+glm::vec3 earthSpinAxis();
+
+// Unit vector from Earth towards the Sun (the Sun is treated as infinitely far)
+glm::vec3 sunDirection(const SimulationState& state);
+
+// Cylindrical shadow model, position in meters
+bool isInEclipse(const glm::vec3& posMeters, const glm::vec3& sunDir);
+
+// Tilted dipole aligned with the spin axis, position in meters, result in Tesla
+glm::vec3 magneticField(const glm::vec3& posMeters);
+
+#endif
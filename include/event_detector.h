@@ -0,0 +1,86 @@
+#ifndef EVENT_DETECTOR_H
+#define EVENT_DETECTOR_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "orbit_math.h"
+
+struct SimulationState;
+
+// Cubic Hermite dense output between two propagator steps: position is matched in
+// value and slope at both ends, velocity is the derivative of that polynomial
+OrbitSample interpolateOrbit(const OrbitSample& a, const OrbitSample& b, double time);
+
+enum class EventType
+{
+    ECLIPSE_ENTRY,
+    ECLIPSE_EXIT,
+    PERIAPSIS,
+    APOAPSIS,
+    ASCENDING_NODE,
+    DESCENDING_NODE,
+};
+
+const char* eventTypeName(EventType type);
+
+struct EventRecord
+{
+    double time { 0.0 };  // s of simulated time
+    EventType type { EventType::ECLIPSE_ENTRY };
+    glm::dvec3 posMeters { 0.0 };
+};
+
+// An event fires when g changes sign; which event depends on the direction
+struct SwitchingFunction
+{
+    std::function<double(const OrbitSample&)> g;
+    EventType rising;   // g goes from negative to positive
+    EventType falling;  // g goes from positive to negative
+
+    // Optional filter evaluated at the located root; rejected crossings are not logged
+    std::function<bool(const OrbitSample&)> accept;
+};
+
+struct EventDetectorConfig
+{
+    double timeTolerance { 1.0e-3 };     // s, Brent convergence on the event time
+    double minApsisEccentricity { 1.0e-4 }; // Below this apsides are numerical noise and dropped
+};
+
+// Watches the propagator: after every step the switching functions are compared with
+// the previous step, and each sign change is located on the dense output with Brent's
+// method. The global step is never shortened.
+class EventDetector
+{
+public:
+    EventDetector(const EventDetectorConfig& config = EventDetectorConfig {});
+
+    void addSwitchingFunction(SwitchingFunction function);
+
+    // Eclipse (cylindrical shadow), apsides (r.v) and equator crossings (r.spin axis)
+    void addStandardEvents(const glm::vec3& sunDir);
+
+    // Call once per propagator step, after state.simElapsedTime has been advanced
+    void step(const SimulationState& state);
+
+    const std::vector<EventRecord>& getLog() const;
+    void clear();
+    void writeCsv(std::ostream& out) const;
+
+private:
+    EventDetectorConfig m_config;
+    std::vector<SwitchingFunction> m_functions;
+
+    bool m_hasPrevious { false };
+    OrbitSample m_previous;
+    std::vector<double> m_previousValues;
+
+    std::vector<EventRecord> m_log;
+};
+
+#endif
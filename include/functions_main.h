@@ -9,13 +9,17 @@
 
 extern Camera camera;
 
+class ReplayClock;
+class StripCharts;
+
 void initNadirPointing(SimulationState& state);
+void initTumble(SimulationState& state, const glm::quat& attitude, const glm::vec3& bodyRates);
 void renderSkybox(Shader& skyboxShader, const glm::mat4& view, const glm::mat4& projection,
                   unsigned int skyboxVAO, unsigned int cubemapTexture);
 void renderSun(Shader& sunShader, const glm::mat4& view, const glm::mat4& projection,
                const glm::vec3& lightPos); 
 void renderEarth(Shader& earthShader, const glm::mat4& view, const glm::mat4& projection,
-                 const glm::vec3& lightPos, const glm::vec3& cameraPos, float simSpeed);
+                 const glm::vec3& lightPos, const glm::vec3& cameraPos, float simTime);
 void renderCubesat(Shader& cubesatShader, const glm::mat4& view, const glm::mat4& projection,
                    const glm::vec3& lightPos, const glm::vec3& cameraPos, const glm::vec3& cubesatPos,
                    const glm::quat& cubesatOrientation); 
@@ -23,15 +27,16 @@ glm::vec3 calculateCubesatVel();
 void updateDeltaTime(SimulationState& state);
 void updateAttitudeControl(SimulationState& state, float dt);
 void propagateOrbit(SimulationState& state, float dt);
+int stepSimulation(SimulationState& state, float simDeltaTime, int subSteps);
 void declareHints();
 GLFWwindow *initWindow(SimulationState& state);
 void processInput(GLFWwindow *window, [[maybe_unused]] SimulationState& state);
+void processReplayInput(GLFWwindow *window, ReplayClock& clock);
+void processChartInput(GLFWwindow *window, StripCharts& charts);
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void mouse_callback(GLFWwindow *window, double xposIn, double yposIn);
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 unsigned int loadTexture(char const * path);
 unsigned int loadCubemap(const std::array<std::string_view, 6>& faces);
-void ignoreLine();
-float getSimSpeed();
 
 #endif
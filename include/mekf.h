@@ -0,0 +1,102 @@
+#ifndef MEKF_H
+#define MEKF_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "sensors.h"
+#include "small_matrix.h"
+
+struct EstimatorConfig
+{
+    float rate { 10.0f };              // Hz, independent of the dynamics sub-step
+    bool closedLoop { true };          // Controller uses the estimate instead of truth
+
+    double gyroNoise { 1.5e-4 };       // rad/s/sqrt(Hz)
+    double gyroBiasWalk { 2.0e-6 };    // rad/s^2/sqrt(Hz)
+    double magBiasWalk { 1.0e-10 };    // T/sqrt(s), only used by the 9-state filter
+
+    double starTrackerSigma { 1.0e-4 }; // rad
+    double sunSensorSigma { 0.0087 };   // rad
+    double magSigma { 1.0e-7 };         // T
+
+    double initialAttitudeSigma { 0.05 }; // rad
+    double initialBiasSigma { 1.0e-3 };   // rad/s
+    double initialMagBiasSigma { 1.0e-6 }; // T, per axis; bounds the bias the 6-state filter ignores
+};
+
+// Multiplicative EKF: the attitude is carried as a reference quaternion and the filter
+// state is a small-angle error about it. N = 6 estimates attitude error and gyro bias,
+// N = 9 additionally estimates magnetometer bias. N = 6 leaves that bias unmodelled and
+// instead widens the magnetometer noise to sqrt(magSigma^2 + initialMagBiasSigma^2), so a
+// biased field reading is weighted for the error it can actually carry.
+template <int N>
+class MultiplicativeEkf
+{
+    static_assert(N == 6 || N == 9, "State is attitude error + gyro bias [+ magnetometer bias]");
+
+public:
+    using StateVector = Vector<N>;
+    using Covariance = Matrix<N, N>;
+
+    explicit MultiplicativeEkf(const EstimatorConfig& config = EstimatorConfig {});
+
+    // Runs predict/update when a filter tick is due; a no-op otherwise.
+    // References are world-frame sun direction and magnetic field.
+    void step(const SensorReadings& readings, const glm::vec3& sunRef, const glm::vec3& magRef, float dt);
+
+    void predict(const glm::dvec3& gyroRate, double dt);
+    void updateAttitude(const glm::dquat& measured, double sigma);
+    void updateVector(const glm::dvec3& measuredBody, const glm::dvec3& reference, double sigma,
+                      bool magnetometer);
+
+    bool isInitialized() const;
+    glm::quat getAttitude() const;        // body-to-world
+    glm::vec3 getAngularVelocity() const; // world frame, bias removed
+    glm::vec3 getGyroBias() const;
+    const Covariance& getCovariance() const;
+    const EstimatorConfig& getConfig() const;
+
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        ar.value(m_config);
+        ar.value(m_q);
+        ar.value(m_gyroBias);
+        ar.value(m_magBias);
+        ar.value(m_lastGyro);
+        ar.value(m_P);
+        ar.value(m_initialized);
+        ar.value(m_tickAccum);
+        ar.value(m_sinceTick);
+        ar.value(m_lastStarTrackerTime);
+        ar.value(m_lastSunTime);
+        ar.value(m_lastMagTime);
+    }
+
+private:
+    template <int M>
+    void applyUpdate(const Matrix<M, N>& H, const Vector<M>& residual, const Matrix<M, M>& measCov);
+    void reset(const StateVector& dx);
+
+    EstimatorConfig m_config;
+
+    glm::dquat m_q { 1.0, 0.0, 0.0, 0.0 };
+    glm::dvec3 m_gyroBias { 0.0 };
+    glm::dvec3 m_magBias { 0.0 };
+    glm::dvec3 m_lastGyro { 0.0 };
+    Covariance m_P {};
+
+    bool m_initialized { false };
+    double m_tickAccum { 0.0 };
+    double m_sinceTick { 0.0 };
+    double m_lastStarTrackerTime { -1.0 }; // Measurement times, on the sensors' clock
+    double m_lastSunTime { -1.0 };
+    double m_lastMagTime { -1.0 };
+};
+
+using AttitudeEstimator = MultiplicativeEkf<6>;
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include <cstdint>
+#include <ostream>
+
+#include "simulation_state.h"
+#include "streaming_stats.h"
+
+struct DispersionConfig
+{
+    int runs { 1000 };
+    std::uint64_t seed { 1 };
+    unsigned int threads { 0 };       // 0 = all hardware threads
+    float duration { 8000.0f };       // s of simulated time per run
+    float dt { 0.1f };                // s, physics step
+
+    float maxBodyRate { 0.17f };      // rad/s, tumble magnitude drawn uniformly up to this
+    float inertiaSigma { 0.05f };     // fractional, per principal axis
+    float wheelInertiaSigma { 0.05f };
+    float wheelTorqueSigma { 0.10f };
+
+    float settleAngle { 0.0349f };    // rad (2 deg) nadir error that counts as settled
+    float steadyStateFraction { 0.25f }; // Trailing part of each run pooled into pointing error stats
+};
+
+struct RunMetrics
+{
+    float settlingTime { -1.0f };     // Last time the error exceeded settleAngle; negative if never settled
+    float nadirEntryTime { -1.0f };
+    float peakWheelSpeed { 0.0f };    // rad/s
+    float finalPointingError { 0.0f }; // rad
+};
+
+struct MonteCarloSummary
+{
+    int runs { 0 };
+    int settledRuns { 0 };
+    StreamingStats settlingTime { 1.0, 1.0e6 };
+    StreamingStats timeToNadir { 1.0, 1.0e6 };
+    StreamingStats peakWheelSpeed { 1.0e-4, 1.0e3 };
+    StreamingStats pointingErrorDeg { 1.0e-4, 180.0 }; // Pooled steady-state samples
+    double wallSeconds { 0.0 };
+};
+
+// Draws run `runIdx` from its own counter-based stream, so results do not depend on
+// thread count or scheduling
+void sampleDispersedState(const DispersionConfig& config, std::uint64_t runIdx, SimulationState& state);
+
+// Runs one dispersed case to completion; steady-state pointing error samples are added
+// to `pointingErrorDeg` if given
+RunMetrics runDispersedCase(const DispersionConfig& config, std::uint64_t runIdx,
+                            StreamingStats* pointingErrorDeg = nullptr);
+
+// Steps `state` for config.duration at config.dt and scores the run; times in the
+// metrics are measured from the state's starting clock
+RunMetrics simulateAndScore(SimulationState& state, const DispersionConfig& config,
+                            StreamingStats* pointingErrorDeg = nullptr);
+
+MonteCarloSummary runMonteCarlo(const DispersionConfig& config);
+void printMonteCarloSummary(const MonteCarloSummary& summary, std::ostream& out);
+
+#endif
@@ -10,4 +10,17 @@
 
 glm::vec3 computeNadirTorque(const SimulationState& state);
 
+// True angle (rad) between the body +Z axis and the nadir direction
+float nadirPointingError(const SimulationState& state);
+
+// Same law driven by an externally supplied attitude (body-to-world) and world-frame rate,
+// e.g. the estimator output
+glm::vec3 computeNadirTorque(const SimulationState& state, const glm::quat& attitude,
+                             const glm::vec3& angularVel);
+
+// The law behind both: drives `attitude` to `desired` (body-to-world) and the world-frame
+// rate to `desiredAngVel`
+glm::vec3 computeTrackingTorque(const glm::quat& attitude, const glm::vec3& angularVel,
+                                const glm::quat& desired, const glm::vec3& desiredAngVel);
+
 #endif
@@ -0,0 +1,51 @@
+#ifndef ORBIT_DECAY_H
+#define ORBIT_DECAY_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "orbit_math.h"
+
+// Static exponential atmosphere, piecewise from the standard 0-1000 km table; kg/m^3
+double atmosphericDensity(double altitude);
+
+struct DecaySatellite
+{
+    OrbitalElements elements;  // Mean elements at t = 0
+    double ballisticCoefficient { 2.2 * 0.01 / static_cast<double>(Physics::CUBESAT_MASS) }; // Cd A / m, m^2/kg
+};
+
+struct DecayConfig
+{
+    double maxDuration { 25.0 * 365.25 * 86400.0 }; // s, give up and report the satellite still in orbit
+    double switchAltitude { 180.0e3 };  // m, perigee altitude below which numerical propagation takes over
+    double reentryAltitude { 120.0e3 }; // m, lifetime ends when the altitude drops below this
+    double numericalStep { 5.0 };       // s, RK4 step of the numerical phase
+    int maxOrbitsPerStep { 50 };        // Averaged steps span a whole number of orbits, at most this many
+    double maxApsisDropPerStep { 1000.0 }; // m, limits the averaged step while decay is fast
+    unsigned int threads { 0 };         // 0 = all hardware threads
+};
+
+struct DecayResult
+{
+    bool reentered { false };
+    double lifetime { 0.0 };         // s, time of reentry or maxDuration
+    OrbitalElements finalElements;   // Mean elements, or osculating after the numerical switch
+    int averagedSteps { 0 };
+    std::size_t numericalSteps { 0 };
+};
+
+// Semi-analytic decay: while the perigee is above switchAltitude the mean a and e are
+// advanced a whole number of orbits at a time (midpoint rule) using drag rates averaged
+// over one orbit in eccentric anomaly, and RAAN, argument of perigee and mean anomaly
+// with the J2 secular rates. Below it the osculating state is integrated with RK4 under
+// point mass gravity, J2 and drag until reentry. The atmosphere does not rotate and
+// the Earth is spherical apart from J2. Satellites run in parallel.
+std::vector<DecayResult> estimateOrbitLifetimes(const std::vector<DecaySatellite>& satellites,
+                                                const DecayConfig& config);
+
+void writeDecayCsv(std::ostream& out, const std::vector<DecaySatellite>& satellites,
+                   const std::vector<DecayResult>& results);
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef ORBIT_DETERMINATION_H
+#define ORBIT_DETERMINATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "contact_windows.h"
+#include "orbit_stm.h"
+
+struct SimulationState;
+
+struct MeasurementSigmas
+{
+    double range { 10.0 };      // m
+    double rangeRate { 0.01 };  // m/s
+    double angle { 1.0e-3 };    // rad, azimuth and elevation
+};
+
+// One pass sample from one station; all four measurement types are taken together
+struct TrackingObservation
+{
+    double time { 0.0 };  // s
+    int station { 0 };
+    double range { 0.0 };      // m
+    double rangeRate { 0.0 };  // m/s
+    double azimuth { 0.0 };    // rad, from north towards east
+    double elevation { 0.0 };  // rad
+};
+
+struct TrackingConfig
+{
+    double duration { 6.0 * 3600.0 }; // s
+    double interval { 10.0 };         // s between samples while a station has the satellite in view
+    float truthStep { 1.0f };         // s, propagateOrbit step for the truth trajectory
+    MeasurementSigmas sigmas;
+    std::uint64_t seed { 1 };
+};
+
+// Flies `initial` with propagateOrbit (the simulator's own float trajectory) and
+// samples noisy measurements from every station above its elevation mask
+std::vector<TrackingObservation> simulateTracking(const SimulationState& initial,
+                                                  const std::vector<GroundStation>& stations,
+                                                  const TrackingConfig& config);
+
+struct OdConfig
+{
+    int maxIterations { 10 };
+    double convergence { 1.0e-3 };     // m, stop when the position correction is below this
+    double step { 1.0 };               // s, reference trajectory step
+    std::size_t chunkSize { 256 };     // Observations per parallel chunk
+    unsigned int threads { 0 };        // 0 = all hardware threads
+    bool useRange { true };
+    bool useRangeRate { true };
+    bool useAngles { true };
+    MeasurementSigmas sigmas;
+    double aprioriPositionSigma { 1.0e4 }; // m, weak prior on the initial guess
+    double aprioriVelocitySigma { 10.0 };  // m/s
+};
+
+struct OdSolution
+{
+    OrbitSample estimate;          // At the epoch of the initial guess
+    StateMatrix covariance;        // Formal, from the final normal matrix
+    int iterations { 0 };
+    bool converged { false };
+    std::size_t measurements { 0 };
+    double rmsRange { 0.0 };       // Residuals of the last iteration
+    double rmsRangeRate { 0.0 };
+    double rmsAngle { 0.0 };
+};
+
+// Batch weighted least squares for the epoch state. Each iteration propagates the
+// reference state plainly to the chunk boundaries. Chunks then run in parallel: each
+// carries its own STM from its boundary and accumulates a 6x6 normal matrix in its
+// own coordinates. The chunks are mapped back to the epoch by chaining the boundary
+// STMs. No design matrix is ever stored.
+//
+// The reference trajectory takes whole `step`s from the epoch, and chunk boundaries
+// fall on those steps, so the result depends on the chunk size only through rounding.
+OdSolution estimateInitialState(const OrbitSample& initialGuess,
+                                const std::vector<TrackingObservation>& observations,
+                                const std::vector<GroundStation>& stations,
+                                const OdConfig& config);
+
+void printOdSolution(const OdSolution& solution, const OrbitSample* truth, std::ostream& out);
+
+#endif
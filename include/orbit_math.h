@@ -0,0 +1,94 @@
+#ifndef ORBIT_MATH_H
+#define ORBIT_MATH_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "constants.h"
+
+struct SimulationState;
+
+// Double precision counterparts of the float physics constants
+namespace Orbit
+{
+    inline constexpr double EARTH_MU { static_cast<double>(Physics::G) * static_cast<double>(Physics::EARTH_MASS) }; // m^3/s^2
+    inline constexpr double EARTH_RADIUS { static_cast<double>(Physics::EARTH_RADIUS) }; // m
+    inline constexpr double EARTH_ROTATION_RATE { 6.283185307179586 / static_cast<double>(SECS_IN_DAY) }; // rad/s
+    inline constexpr double EARTH_J2 { 1.08262668e-3 };
+}
+
+// Translational state at one instant, in meters and m/s (unscaled, double precision)
+struct OrbitSample
+{
+    double time { 0.0 };
+    glm::dvec3 pos { 0.0 };
+    glm::dvec3 vel { 0.0 };
+};
+
+OrbitSample orbitSampleFromState(const SimulationState& state);
+
+// Point mass gravity, the force model of propagateOrbit
+glm::dvec3 gravityAcceleration(const glm::dvec3& pos);
+
+// Double precision counterpart of propagateOrbit: velocity Verlet on unscaled meters
+void propagateOrbitMeters(OrbitSample& sample, double dt);
+
+// Steps of dt up to `time`; a remainder shorter than dt/2 is merged into the last step
+// so the final step lands exactly on `time`
+void propagateOrbitMetersTo(OrbitSample& sample, double time, double dt);
+
+// Step length propagateOrbitMetersTo takes next; 0 once `time` is reached
+double nextStepTo(double from, double time, double dt);
+
+// Classical elements referenced to the equator (earthSpinAxis) and, within it, to
+// world +Z, which is also the prime meridian at t = 0. Angles in radians.
+struct OrbitalElements
+{
+    double semiMajorAxis { 0.0 }; // m
+    double eccentricity { 0.0 };
+    double inclination { 0.0 };
+    double raan { 0.0 };
+    double argPeriapsis { 0.0 };
+    double trueAnomaly { 0.0 };
+};
+
+OrbitalElements stateToElements(const OrbitSample& sample);
+OrbitSample elementsToState(const OrbitalElements& elements, double time = 0.0);
+
+// Copies of `nominal` spread over about sqrt(n) planes in RAAN and evenly phased
+// within each plane
+std::vector<OrbitSample> spreadConstellation(const OrbitalElements& nominal, int satellites, double time = 0.0);
+
+// Closed form two-body propagation, exact for the point mass gravity in propagateOrbit.
+// Elliptic orbits only.
+class KeplerPropagator
+{
+public:
+    explicit KeplerPropagator(const OrbitSample& epoch);
+
+    glm::dvec3 position(double time) const;
+    OrbitSample state(double time) const;
+    double getPeriod() const;
+
+private:
+    double eccentricAnomaly(double time) const;
+
+    double m_epochTime;
+    double m_a;
+    double m_e;
+    double m_meanMotion;
+    double m_meanAnomalyAtEpoch;
+    glm::dvec3 m_p; // Unit vector towards periapsis (or the epoch position if circular)
+    glm::dvec3 m_q; // In plane, 90 deg ahead of m_p
+};
+
+// Earth-fixed frame: z along the spin axis, x through the prime meridian, rotating at
+// EARTH_ROTATION_RATE about z. Inertial vectors are in world axes.
+glm::dvec3 inertialToEarthFixed(const glm::dvec3& pos, double time);
+glm::dvec3 earthFixedToInertial(const glm::dvec3& pos, double time);
+
+// Spherical Earth, matching the rendered sphere
+glm::dvec3 geodeticToEarthFixed(double latitude, double longitude, double altitude);
+
+#endif
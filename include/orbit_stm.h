@@ -0,0 +1,75 @@
+#ifndef ORBIT_STM_H
+#define ORBIT_STM_H
+
+#include <ostream>
+#include <vector>
+
+#include "orbit_math.h"
+#include "small_matrix.h"
+
+// State ordering throughout: x, y, z (m), vx, vy, vz (m/s)
+using StateMatrix = Matrix<6, 6>;
+using StateVector = Vector<6>;
+
+StateVector toStateVector(const OrbitSample& sample);
+
+// d(accel)/d(pos) for point mass gravity
+Matrix<3, 3> gravityGradient(const glm::dvec3& pos);
+
+// Exact Jacobian of one velocity Verlet step of length dt from pos0 to pos1, so the
+// STM is consistent with the discrete trajectory rather than the continuous one
+StateMatrix verletTangentMap(const glm::dvec3& pos0, const glm::dvec3& pos1, double dt);
+
+// Propagates an orbit with propagateOrbitMeters and carries the state transition
+// matrix d(state)/d(epoch state) alongside it.
+//
+// With stmInterval = 1 the STM takes the tangent map of every step and matches finite
+// differences of the trajectory to round-off. Cost, measured with --covariance: about
+// 9x plain propagation (one gravity gradient and a block 6x6 product per step). With
+// stmInterval = N the STM is advanced once per N steps by the tangent map of a single
+// N*dt Verlet step through the same end points: roughly 1 + 8/N times plain
+// propagation (2x at N = 10, where the STM is good to ~1e-3 relative after an orbit).
+// The trajectory itself is unaffected.
+class StmPropagator
+{
+public:
+    explicit StmPropagator(const OrbitSample& epoch, int stmInterval = 1);
+
+    void step(double dt);
+
+    // Steps as propagateOrbitMetersTo does, then syncs the STM
+    void propagateTo(double time, double dt);
+
+    // Closes a partial block so getStm() matches the current state
+    void syncStm();
+
+    const OrbitSample& getState() const;
+    const StateMatrix& getStm() const; // As of the last completed block or syncStm()
+    int getStmInterval() const;
+
+private:
+    OrbitSample m_state;
+    Matrix<3, 3> m_blockStartGradient;
+    double m_blockTime { 0.0 };
+    int m_stepsInBlock { 0 };
+    int m_stmInterval;
+    StateMatrix m_stm { StateMatrix::identity() };
+};
+
+struct CovarianceSample
+{
+    double time { 0.0 };
+    OrbitSample state;
+    StateMatrix covariance;
+};
+
+// P(t) = Phi(t) P0 Phi(t)^T at each requested epoch (s, ascending, after epoch.time).
+// Steps of `dt` are shortened only to land exactly on an epoch.
+std::vector<CovarianceSample> propagateCovariance(const OrbitSample& epoch, const StateMatrix& initialCovariance,
+                                                  const std::vector<double>& epochs, double dt,
+                                                  int stmInterval = 1);
+
+// One row per epoch: time, position/velocity sigmas, then the 21 upper-triangle terms
+void writeCovarianceCsv(std::ostream& out, const std::vector<CovarianceSample>& samples);
+
+#endif
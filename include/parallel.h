@@ -0,0 +1,46 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+inline unsigned int resolveThreadCount(unsigned int requested)
+{
+    if (requested > 0) { return requested; }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs fn(index, worker) for every index in [0, count) on a pool of worker threads.
+// Indices are handed out dynamically, so uneven job lengths still balance. `worker`
+// is in [0, threads) and lets callers keep one accumulator per thread without locks.
+template <typename Fn>
+void parallelFor(std::size_t count, unsigned int threads, Fn&& fn)
+{
+    threads = static_cast<unsigned int>(std::min<std::size_t>(resolveThreadCount(threads),
+                                                              std::max<std::size_t>(count, 1)));
+
+    std::atomic<std::size_t> next { 0 };
+    auto work = [&](unsigned int worker) {
+        for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            fn(i, worker);
+    };
+
+    if (threads == 1)
+    {
+        work(0);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned int t = 0; t < threads; ++t)
+        pool.emplace_back(work, t);
+
+    for (auto& thread : pool)
+        thread.join();
+}
+
+#endif
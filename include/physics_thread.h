@@ -0,0 +1,64 @@
+#ifndef PHYSICS_THREAD_H
+#define PHYSICS_THREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "telemetry_recorder.h"
+#include "triple_buffer.h"
+
+struct SimulationState;
+
+// Physics steps the interactive view assumes it gets per second of wall time at
+// `subSteps` per frame; with the frame rate out of the loop this fixes the step size
+inline constexpr float NOMINAL_FRAME_RATE { 60.0f };
+
+// Runs stepSimulation for the interactive view on its own thread, so a slow frame never
+// stalls the physics and a burst of physics never stalls presentation. The thread keeps
+// simulated time at `simSpeed` times wall time (or the speed a telecommand set) in
+// fixed steps of simSpeed / (NOMINAL_FRAME_RATE * subSteps) s, which is the step the
+// sequential loop took at 60 fps. When it falls more than MAX_DELTA_TIME of wall time
+// behind, the backlog is dropped, as the sequential loop clamped long frames.
+//
+// After every step the thread publishes a TelemetryFrame through a triple buffer; that
+// frame is all the renderer reads of the state (see applyTelemetryFrame), so the render
+// thread never touches the SimulationState while this runs.
+class PhysicsThread
+{
+public:
+    // `afterStep` runs on the physics thread after each step, e.g. periodic checkpoints
+    PhysicsThread(SimulationState& state, float simSpeed, int subSteps, std::function<void()> afterStep = {});
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    void start();
+    void stop(); // Joins; the state belongs to the caller again afterwards
+
+    // Render thread: the newest published frame; true if it changed since the last call
+    bool update();
+    const TelemetryFrame& latest() const;
+
+    std::uint64_t getSteps() const;
+    std::uint64_t getDroppedBacklogs() const; // Times the physics could not keep up
+
+private:
+    void run();
+    float currentSpeed() const;
+
+    SimulationState& m_state;
+    float m_simSpeed;
+    int m_subSteps;
+    std::function<void()> m_afterStep;
+
+    TripleBuffer<TelemetryFrame> m_snapshots;
+    std::thread m_thread;
+    std::atomic<bool> m_running { false };
+    std::atomic<std::uint64_t> m_steps { 0 };
+    std::atomic<std::uint64_t> m_droppedBacklogs { 0 };
+};
+
+#endif
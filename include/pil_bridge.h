@@ -0,0 +1,113 @@
+#ifndef PIL_BRIDGE_H
+#define PIL_BRIDGE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "adcs_mode.h"
+#include "streaming_stats.h"
+
+struct SimulationState;
+
+// Wire format for the processor-in-the-loop link. Native byte order: both ends run on
+// the same host. The flight software echoes `sequence` so replies can be matched.
+#pragma pack(push, 1)
+struct PilSensorPacket
+{
+    std::uint32_t magic;
+    std::uint32_t sequence;
+    double simTime;          // s
+    float gyro[3];           // rad/s, body
+    float starTracker[4];    // w, x, y, z
+    float sunVector[3];      // unit, body
+    float magField[3];       // T, body
+    float wheelSpeed[3];     // rad/s
+    std::uint8_t validFlags; // PIL_VALID_* bits
+    std::uint8_t reserved[3];
+};
+
+struct PilActuatorPacket
+{
+    std::uint32_t magic;
+    std::uint32_t sequence;  // Sequence of the sensor packet this command answers
+    float wheelTorque[3];    // N*m, same convention as computeNadirTorque
+    float dipole[3];         // A*m^2, body
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PilSensorPacket) == 84, "PIL sensor packet layout changed");
+static_assert(sizeof(PilActuatorPacket) == 32, "PIL actuator packet layout changed");
+
+inline constexpr std::uint32_t PIL_SENSOR_MAGIC { 0x50494C53 };   // "PILS"
+inline constexpr std::uint32_t PIL_ACTUATOR_MAGIC { 0x50494C41 }; // "PILA"
+
+inline constexpr std::uint8_t PIL_VALID_GYRO { 1 << 0 };
+inline constexpr std::uint8_t PIL_VALID_STAR_TRACKER { 1 << 1 };
+inline constexpr std::uint8_t PIL_VALID_SUN { 1 << 2 };
+inline constexpr std::uint8_t PIL_VALID_MAG { 1 << 3 };
+
+enum class PilSyncMode
+{
+    LOCKSTEP,     // Physics waits for the reply to every sensor packet
+    FREE_RUNNING, // Physics never waits; the latest reply received is applied
+};
+
+// Replaces the on-board ADCS with an external process over a Unix-domain socket.
+// The simulator is the server; flight software connects to `socketPath`.
+class PilBridge
+{
+public:
+    PilBridge(std::string socketPath, PilSyncMode mode, float controlRate = 10.0f,
+              int timeoutMs = 1000);
+    ~PilBridge();
+
+    PilBridge(const PilBridge&) = delete;
+    PilBridge& operator=(const PilBridge&) = delete;
+
+    // Blocks until the flight software connects
+    bool open();
+    void close();
+    bool isConnected() const;
+
+    // Same contract as ModeManager::update: one exchange per control cycle, command held between
+    const ActuatorCommand& update(const SimulationState& state, float dt);
+
+    const StreamingStats& getLatencyStats() const; // Round trip, microseconds
+    std::uint64_t getTimeouts() const;
+    std::uint64_t getStaleCycles() const;
+
+private:
+    PilSensorPacket buildPacket(const SimulationState& state) const;
+    bool sendAll(const void* data, std::size_t size);
+    bool receiveReplies(int timeoutMs, std::uint32_t waitFor);
+    // False, leaving the command as it was, for a stale, duplicate or unsent sequence
+    bool applyReply(const PilActuatorPacket& reply);
+
+    std::string m_socketPath;
+    PilSyncMode m_mode;
+    float m_controlRate;
+    int m_timeoutMs;
+
+    int m_listenFd { -1 };
+    int m_fd { -1 };
+
+    ActuatorCommand m_command;
+    float m_cycleAccum { 0.0f };
+    std::uint32_t m_sequence { 0 };
+    std::uint32_t m_lastReplySequence { 0 };
+
+    // Send time of recent packets, indexed by sequence, for round-trip measurement
+    static constexpr int SEND_HISTORY { 256 };
+    std::array<std::chrono::steady_clock::time_point, SEND_HISTORY> m_sendTimes {};
+
+    std::array<std::uint8_t, 64 * sizeof(PilActuatorPacket)> m_rxBuffer {};
+    std::size_t m_rxFill { 0 };
+
+    StreamingStats m_latencyUs { 0.1, 1.0e7 };
+    std::uint64_t m_timeouts { 0 };
+    std::uint64_t m_staleCycles { 0 };
+};
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Writes 8-bit RGB pixels (row-major, top row first, 3 bytes per pixel) as a PNG.
+// Uses zlib, which the build already links for assimp. Returns false on I/O failure.
+bool writePngRgb(const std::string& path, int width, int height, const std::vector<std::uint8_t>& rgb);
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+// Scoped timing zones for the hot paths, exported as Chrome trace JSON. The file opens
+// in chrome://tracing and ui.perfetto.dev.
+//
+// PROFILE_ZONE("name") times the rest of the enclosing scope. While no trace is being
+// taken a zone costs one relaxed atomic load. A build without CUBESAT_PROFILING (the
+// CMake option of that name) compiles zones out entirely.
+//
+// Each thread appends to its own buffer, so zones on the physics thread, the render
+// thread and worker pools never contend. A thread takes a lock only once, when it
+// records its first zone, and again each time it fills a block of zones.
+//
+// Timestamps are raw TSC reads on x86-64, which assumes an invariant TSC as on any
+// recent CPU; other targets read steady_clock. Ticks are converted to microseconds at
+// export, against steady_clock readings taken when tracing starts and stops.
+//
+// Zone names must outlive the trace (string literals), as only the pointer is kept.
+
+#ifdef CUBESAT_PROFILING
+inline constexpr bool PROFILING_COMPILED_IN { true };
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__) { name }
+#else
+inline constexpr bool PROFILING_COMPILED_IN { false };
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+// Zones a thread keeps before dropping (and counting) the rest
+inline constexpr std::size_t MAX_ZONES_PER_THREAD { std::size_t { 1 } << 21 };
+
+namespace ProfilerDetail
+{
+    inline std::atomic<bool> active { false };
+}
+
+inline bool isProfiling()
+{
+    return ProfilerDetail::active.load(std::memory_order_relaxed);
+}
+
+inline std::uint64_t readProfileClock()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+void recordProfileZone(const char* name, std::uint64_t start, std::uint64_t end);
+
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name)
+        : m_name { name }, m_start { isProfiling() ? readProfileClock() : 0 }
+    {
+    }
+
+    ~ProfileZone()
+    {
+        if (m_start != 0) { recordProfileZone(m_name, m_start, readProfileClock()); }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    std::uint64_t m_start;
+};
+
+// One trace per process: zones from start to stop
+void startProfiling();
+void stopProfiling();
+
+// Shown as the thread's track name; call on the thread, before or after its first zone
+void setProfileThreadName(const char* name);
+
+// Call once every traced thread is done (joined, or past its last zone)
+bool writeChromeTrace(const std::string& path);
+
+std::uint64_t getProfileZoneCount();
+std::uint64_t getProfileZonesDropped();
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Counter-based generator (Philox4x32-10). Every number is a pure function of
+// (seed, stream, counter), so a spacecraft's noise sequence is independent of how
+// many other spacecraft are simulated or in which order they are stepped.
+// Numbers are produced a block at a time so the round function vectorizes.
+class RandomStream
+{
+public:
+    static constexpr int BLOCK_SIZE { 64 };
+
+    RandomStream(std::uint64_t seed = 0, std::uint64_t streamId = 0);
+
+    float uniform(); // [0, 1)
+    float normal();  // N(0, 1)
+
+    void fillUniform(float* out, std::size_t count);
+    void fillNormal(float* out, std::size_t count);
+
+    std::uint64_t getSeed() const;
+    std::uint64_t getStreamId() const;
+
+    // The buffered block is saved too, so a restored stream continues mid-block
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        ar.value(m_seed);
+        ar.value(m_streamId);
+        ar.value(m_counter);
+        ar.value(m_uniforms);
+        ar.value(m_normals);
+        ar.value(m_uniformIdx);
+        ar.value(m_normalIdx);
+    }
+
+private:
+    void generateBlock(std::array<std::uint32_t, BLOCK_SIZE>& bits);
+    void refillUniforms();
+    void refillNormals();
+
+    std::uint64_t m_seed;
+    std::uint64_t m_streamId;
+    std::uint64_t m_counter { 0 };
+
+    std::array<float, BLOCK_SIZE> m_uniforms {};
+    std::array<float, BLOCK_SIZE> m_normals {};
+    int m_uniformIdx { BLOCK_SIZE };
+    int m_normalIdx { BLOCK_SIZE };
+};
+
+#endif
@@ -3,10 +3,14 @@
 
 #include <glm/glm.hpp>
 
+inline constexpr float WHEEL_MAX_TORQUE { 0.00005f }; // N*m; value is typical for CubeSat wheels
+inline constexpr float WHEEL_MAX_SPEED { 6000.0f * 2.0f * 3.14159f / 60.0f }; // 6000 rpm
+
 class ReactionWheel
 {
 public:
-    ReactionWheel(glm::vec3 axis, float inertia);
+    ReactionWheel(glm::vec3 axis, float inertia, float maxTorque = WHEEL_MAX_TORQUE,
+                  float maxSpeed = WHEEL_MAX_SPEED);
 
     void applyTorque(float torque, float dt);
     void update(float dt);
@@ -15,9 +19,26 @@ public:
     glm::vec3 getAngularMomentum() const;
 
     glm::vec3 getAxis() const;
+    float getInertia() const;
+    float getMaxTorque() const;
+    float getMaxSpeed() const;
+
+    // Lists every member for CheckpointWriter/CheckpointReader (checkpoint.h)
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        ar.value(m_axis);
+        ar.value(m_inertia);
+        ar.value(m_maxTorque);
+        ar.value(m_maxSpeed);
+        ar.value(m_angularVel);
+    }
+
 private:
     glm::vec3 m_axis;
     float m_inertia;
+    float m_maxTorque;
+    float m_maxSpeed;
     float m_angularVel;
 };
 
@@ -7,10 +7,13 @@
 
 inline constexpr int numWheels { 3 };
 
+inline constexpr float WHEEL_INERTIA { 0.01f }; // kg*m^2
+
 class ReactionWheelSystem
 {
 public:
-    ReactionWheelSystem();
+    ReactionWheelSystem(float wheelInertia = WHEEL_INERTIA, float maxTorque = WHEEL_MAX_TORQUE,
+                        float maxSpeed = WHEEL_MAX_SPEED);
 
     void applyTorqueCommands(const glm::vec3& torques, float dt);
     void update(float dt);
@@ -25,9 +28,19 @@ public:
 
     glm::vec3 getWheelAxis(int idx) const;
 
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        for (ReactionWheel& wheel : m_wheels)
+            ar.object(wheel);
+        ar.value(m_lastReactionTorque);
+        ar.value(m_prevMomentum);
+    }
+
 private:
     std::array<ReactionWheel, numWheels> m_wheels;
     glm::vec3 m_lastReactionTorque { 0.0f };
+    glm::vec3 m_prevMomentum { 0.0f };
 };
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef ROOT_FINDING_H
+#define ROOT_FINDING_H
+
+#include <cmath>
+#include <utility>
+
+// Brent's method on a bracket [a, b] with f(a) and f(b) of opposite sign (already
+// evaluated by the caller). Combines bisection, secant and inverse quadratic steps,
+// so it never does worse than bisection. Returns the root to within `tol`.
+template <typename Fn>
+double brentRoot(Fn&& f, double a, double b, double fa, double fb, double tol, int maxIter = 100)
+{
+    if (fa == 0.0) { return a; }
+    if (fb == 0.0) { return b; }
+
+    double c { a };
+    double fc { fa };
+    double d { b - a };
+    double e { d };
+
+    for (int iter = 0; iter < maxIter; ++iter)
+    {
+        // Keep b as the best estimate and c on the other side of the root
+        if ((fb > 0.0) == (fc > 0.0))
+        {
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (std::abs(fc) < std::abs(fb))
+        {
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+
+        double tol1 { 2.0 * 1e-16 * std::abs(b) + 0.5 * tol };
+        double m { 0.5 * (c - b) };
+        if (std::abs(m) <= tol1 || fb == 0.0) { return b; }
+
+        if (std::abs(e) >= tol1 && std::abs(fa) > std::abs(fb))
+        {
+            double s { fb / fa };
+            double p;
+            double q;
+            if (a == c)
+            {
+                // Secant
+                p = 2.0 * m * s;
+                q = 1.0 - s;
+            }
+            else
+            {
+                // Inverse quadratic interpolation
+                double qa { fa / fc };
+                double r { fb / fc };
+                p = s * (2.0 * m * qa * (qa - r) - (b - a) * (r - 1.0));
+                q = (qa - 1.0) * (r - 1.0) * (s - 1.0);
+            }
+            if (p > 0.0) { q = -q; } else { p = -p; }
+
+            if (2.0 * p < std::min(3.0 * m * q - std::abs(tol1 * q), std::abs(e * q)))
+            {
+                e = d;
+                d = p / q;
+            }
+            else
+            {
+                d = m;
+                e = m;
+            }
+        }
+        else
+        {
+            d = m;
+            e = m;
+        }
+
+        a = b;
+        fa = fb;
+        b += (std::abs(d) > tol1) ? d : (m > 0.0 ? tol1 : -tol1);
+        fb = f(b);
+    }
+    return b;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "adcs_mode.h"
+#include "attitude.h"
+#include "mekf.h"
+#include "orbit_math.h"
+#include "reaction_wheel_system.h"
+#include "sensors.h"
+#include "telemetry_columns.h"
+#include "telemetry_downlink.h"
+
+struct SimulationState;
+
+// Everything needed to start a run. Defaults reproduce the built-in scenario: 400 km
+// circular orbit, nadir mode from a 20/30/10 deg attitude offset.
+struct Scenario
+{
+    // [simulation]
+    double epoch { 0.0 };              // s, initial simulation clock
+    float simSpeed { 60.0f };          // Simulated seconds per wall second (interactive)
+    int subSteps { 15 };               // Physics steps per rendered frame
+    bool headless { false };           // Run `duration` without a window, then exit
+    float duration { 8000.0f };        // s, headless only
+    float headlessStep { 0.1f };       // s, headless physics step
+    std::uint64_t seed { 0 };          // Sensor noise
+
+    // [orbit]; angles in radians here, degrees in the file. Starts as the nominal orbit,
+    // so a file that only sets the altitude keeps everything else.
+    OrbitalElements orbit;
+
+    // [spacecraft]
+    glm::mat3 inertia { CUBESAT_INERTIA }; // kg*m^2
+    glm::vec3 attitude { glm::radians(20.0f), glm::radians(30.0f), glm::radians(10.0f) }; // rad, Euler XYZ
+    bool bodyRatesSet { false };       // Otherwise the body starts rotating at the orbit rate
+    glm::vec3 bodyRates { 0.0f };      // rad/s, body frame
+    AdcsMode initialMode { AdcsMode::NADIR };
+
+    // [wheels]
+    float wheelInertia { WHEEL_INERTIA }; // kg*m^2
+    float wheelMaxTorque { WHEEL_MAX_TORQUE };
+    float wheelMaxSpeed { WHEEL_MAX_SPEED };
+
+    // [controller], [estimator], [sensors]
+    AdcsConfig adcs;
+    EstimatorConfig estimator;
+    SensorConfig sensors;
+
+    // [output]; empty strings disable each output
+    std::string eventsCsv;
+    std::string telemetryPath;         // Every physics step, see telemetry_recorder.h
+    ColumnarCodec telemetryCodec;      // For .tlc telemetry paths
+    std::string checkpointPath;
+    float checkpointInterval { 600.0f }; // s of simulated time
+    std::string tracePath;             // Chrome trace of PROFILE_ZONEs, see profiler.h
+
+    // [downlink]: CCSDS packets over UDP, off unless a port is given
+    DownlinkConfig downlink;
+
+    // [telecommand]: Unix socket accepting ground commands, off when empty
+    std::string telecommandSocket;
+
+    Scenario();
+};
+
+// One `key = value` line of a scenario-style file, with its table folded into the key
+struct ConfigEntry
+{
+    std::string key;   // "table.key"
+    std::string value; // Unparsed value text
+    std::string where; // "file:line", for messages
+};
+
+// Reads a TOML subset: [table] headers, `key = value` lines and # comments, where a
+// value is a number, true/false, a "string" or a one-line [array] of numbers. Keys are
+// not interpreted here.
+bool readConfigFile(const std::string& path, std::vector<ConfigEntry>& entries, std::string& error);
+
+// Applies entries in order. Unknown tables and keys are errors, so a typo never
+// silently falls back to a default. On failure `scenario` is unchanged and `error`
+// names the line and the problem.
+bool applyScenarioSettings(const std::vector<ConfigEntry>& entries, Scenario& scenario, std::string& error);
+
+bool loadScenario(const std::string& path, Scenario& scenario, std::string& error);
+
+// Replaces the orbit, mass properties, wheels, sensors, estimator, controller, initial
+// attitude and clock of `state`
+void applyScenario(const Scenario& scenario, SimulationState& state);
+
+#endif
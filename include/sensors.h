@@ -0,0 +1,200 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <cstdint>
+
+#include "random_stream.h"
+
+struct SimulationState;
+
+// Noise figures are 1-sigma. A rate or latency of zero means "every sample" / "no delay".
+struct GyroConfig
+{
+    float noiseDensity { 1.5e-4f };     // rad/s/sqrt(Hz) (angle random walk)
+    float biasRandomWalk { 2.0e-6f };   // rad/s^2/sqrt(Hz) (rate random walk)
+    float initialBiasSigma { 5.0e-4f }; // rad/s
+    float resolution { 1.0e-5f };       // rad/s per LSB
+    float rate { 0.0f };                // Hz
+    float latency { 0.005f };           // s
+};
+
+struct StarTrackerConfig
+{
+    float noiseSigma { 1.0e-4f };       // rad (~20 arcsec)
+    float rate { 4.0f };
+    float latency { 0.2f };
+};
+
+struct SunSensorConfig
+{
+    float noiseSigma { 0.0087f };       // rad (~0.5 deg)
+    float rate { 10.0f };
+    float latency { 0.02f };
+};
+
+struct MagnetometerConfig
+{
+    float noiseSigma { 1.0e-7f };       // Tesla (100 nT)
+    float initialBiasSigma { 5.0e-7f }; // Tesla
+    float resolution { 1.0e-8f };       // Tesla per LSB
+    float rate { 10.0f };
+    float latency { 0.01f };
+};
+
+struct SensorConfig
+{
+    GyroConfig gyro;
+    StarTrackerConfig starTracker;
+    SunSensorConfig sunSensor;
+    MagnetometerConfig magnetometer;
+};
+
+// `time` is the simulation clock (SimulationState::simElapsedTime) when the measurement
+// was taken, which lags the current clock by the sensor latency. `fresh` is only set on
+// the sample in which the value was delivered.
+template <typename T>
+struct Measurement
+{
+    T value {};
+    double time { 0.0 };
+    bool valid { false };
+    bool fresh { false };
+};
+
+struct SensorReadings
+{
+    Measurement<glm::vec3> gyro;        // body rates, rad/s
+    Measurement<glm::quat> starTracker; // body-to-world attitude
+    Measurement<glm::vec3> sunVector;   // unit vector, body frame
+    Measurement<glm::vec3> magField;    // Tesla, body frame
+};
+
+// Fixed-capacity FIFO holding samples until their latency has elapsed. Scenarios whose
+// rate and latency need more than N samples in flight are rejected when parsed; should
+// one get here anyway, a full line replaces its newest sample, so it still delivers
+// (at a lower rate) instead of dropping every sample before its latency elapses.
+template <typename T, int N>
+class DelayLine
+{
+public:
+    void push(const Measurement<T>& m)
+    {
+        if (m_count == N)
+        {
+            m_buffer[(m_head + m_count - 1) % N] = m;
+            return;
+        }
+        m_buffer[(m_head + m_count) % N] = m;
+        ++m_count;
+    }
+
+    // Latest sample whose latency has elapsed; older ready samples are discarded
+    bool release(double now, float latency, Measurement<T>& out)
+    {
+        bool found { false };
+        while (m_count > 0 && m_buffer[m_head].time + latency <= now)
+        {
+            out = m_buffer[m_head];
+            pop();
+            found = true;
+        }
+        return found;
+    }
+
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        ar.value(m_buffer);
+        ar.value(m_head);
+        ar.value(m_count);
+    }
+
+private:
+    void pop()
+    {
+        m_head = (m_head + 1) % N;
+        --m_count;
+    }
+
+    std::array<Measurement<T>, N> m_buffer {};
+    int m_head { 0 };
+    int m_count { 0 };
+};
+
+class SensorSuite
+{
+public:
+    static constexpr int DELAY_CAPACITY { 64 };
+
+    SensorSuite(const SensorConfig& config = SensorConfig {}, std::uint64_t seed = 0,
+                std::uint32_t spacecraftId = 0);
+
+    // Takes the samples due over a step of `dt` that has not yet been added to
+    // state.simElapsedTime; they are stamped with the clock at the end of the step
+    void sample(const SimulationState& state, float dt);
+
+    const SensorReadings& getReadings() const;
+    const SensorConfig& getConfig() const;
+
+    glm::vec3 getGyroBias() const;
+    glm::vec3 getMagBias() const;
+
+    // New noise streams for (seed, spacecraftId); biases and queued samples are kept,
+    // so a run forked from a checkpoint diverges only in its future noise
+    void reseed(std::uint64_t seed, std::uint32_t spacecraftId);
+
+    template <typename Archive>
+    void checkpoint(Archive& ar)
+    {
+        ar.value(m_config);
+        ar.object(m_gyroNoise);
+        ar.object(m_starTrackerNoise);
+        ar.object(m_sunSensorNoise);
+        ar.object(m_magNoise);
+        ar.value(m_gyroBias);
+        ar.value(m_magBias);
+        ar.value(m_time);
+        ar.value(m_gyroAccum);
+        ar.value(m_starTrackerAccum);
+        ar.value(m_sunSensorAccum);
+        ar.value(m_magAccum);
+        ar.object(m_gyroDelay);
+        ar.object(m_starTrackerDelay);
+        ar.object(m_sunSensorDelay);
+        ar.object(m_magDelay);
+        ar.value(m_readings);
+    }
+
+private:
+    glm::vec3 noiseVec(RandomStream& stream, float sigma);
+    bool due(double& accumulator, float rate, float dt) const;
+
+    SensorConfig m_config;
+
+    RandomStream m_gyroNoise;
+    RandomStream m_starTrackerNoise;
+    RandomStream m_sunSensorNoise;
+    RandomStream m_magNoise;
+
+    glm::vec3 m_gyroBias { 0.0f };
+    glm::vec3 m_magBias { 0.0f };
+
+    double m_time { 0.0 }; // Simulation clock at the end of the last sample() call
+    double m_gyroAccum { 0.0 };
+    double m_starTrackerAccum { 0.0 };
+    double m_sunSensorAccum { 0.0 };
+    double m_magAccum { 0.0 };
+
+    DelayLine<glm::vec3, DELAY_CAPACITY> m_gyroDelay;
+    DelayLine<glm::quat, DELAY_CAPACITY> m_starTrackerDelay;
+    DelayLine<glm::vec3, DELAY_CAPACITY> m_sunSensorDelay;
+    DelayLine<glm::vec3, DELAY_CAPACITY> m_magDelay;
+
+    SensorReadings m_readings;
+};
+
+#endif
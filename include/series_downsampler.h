@@ -0,0 +1,93 @@
+#ifndef SERIES_DOWNSAMPLER_H
+#define SERIES_DOWNSAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PlotPoint
+{
+    float time;  // s after the start of the queried range
+    float value;
+};
+
+// Largest-Triangle-Three-Buckets: reduces `count` points (ascending time) to at most
+// `target`, always keeping the first and last. Each of the target - 2 inner buckets
+// keeps the point forming the largest triangle with the point kept before it and the
+// mean of the next bucket, which preserves the visual shape far better than striding.
+void lttbDownsample(const PlotPoint* points, std::size_t count, std::size_t target, std::vector<PlotPoint>& out);
+
+// One channel of a live plot, downsampled at every zoom level in time proportional to
+// the screen width rather than the history length.
+//
+// Samples go into two structures as they arrive, O(1) amortized each:
+//   - a ring of the most recent raw samples, for ranges short enough to draw as is;
+//   - a min/max pyramid over all history. Level 0 buckets are `baseWidth` s wide and
+//     each level above doubles the width. A sample only climbs while it extends a
+//     bucket's range, so most samples stop after a level or two.
+//
+// query() picks the coarsest level that still gives about PRESELECT_RATIO candidate
+// points per output point. Each bucket contributes its min and max, in the order they
+// happened. LTTB then reduces the candidates to the requested count. Every candidate
+// is a local extreme, so isolated spikes are kept, and LTTB picks among them by shape
+// (the MinMaxLTTB scheme). Ranges finer than the pyramid fall back to the raw ring
+// while it still reaches back far enough.
+class SeriesDownsampler
+{
+public:
+    static constexpr std::size_t PRESELECT_RATIO { 4 };
+
+    explicit SeriesDownsampler(double baseWidth = 0.25, std::size_t rawCapacity = std::size_t { 1 } << 16);
+
+    // Times must not decrease; an earlier sample (a replay seek) starts the series over
+    void append(double time, float value);
+    void clear();
+
+    // At most maxPoints points covering [t0, t1], times relative to t0, into `out`
+    // (cleared first). Work is O(maxPoints) on the pyramid, or O(raw samples in range)
+    // on the raw ring.
+    void query(double t0, double t1, std::size_t maxPoints, std::vector<PlotPoint>& out) const;
+
+    bool empty() const;
+    double getStartTime() const;
+    double getEndTime() const;
+    std::size_t getLevelCount() const;
+    std::size_t getSampleCount() const;
+
+private:
+    struct Bucket
+    {
+        float min;
+        float max;
+        bool minLast; // The min was reached after the max
+    };
+
+    struct RawSample
+    {
+        double time;
+        float value;
+    };
+
+    static Bucket emptyBucket();
+    static Bucket combine(const Bucket& earlier, const Bucket& later);
+    void addToLevel(std::size_t level, std::size_t index, float value);
+    bool rawCovers(double t0) const;
+    const RawSample& raw(std::size_t i) const; // 0 = oldest retained
+    void queryRaw(double t0, double t1) const;
+    void queryLevel(std::size_t level, double t0, double t1) const;
+
+    double m_baseWidth;
+    double m_origin { 0.0 };
+    double m_last { 0.0 };
+    std::size_t m_samples { 0 };
+
+    std::vector<RawSample> m_raw;
+    std::size_t m_rawNext { 0 };
+    std::size_t m_rawCount { 0 };
+
+    std::vector<std::vector<Bucket>> m_levels;
+
+    mutable std::vector<PlotPoint> m_candidates; // Reused by query()
+};
+
+#endif
@@ -0,0 +1,13 @@
+#version 330 core
+in float windowX;
+in vec3 lineColor;
+
+out vec4 FragColor;
+
+void main()
+{
+    // The ring reaches further back than the shown window; clip to the panel
+    if (windowX < 0.0 || windowX > 1.0)
+        discard;
+    FragColor = vec4(lineColor, 1.0);
+}
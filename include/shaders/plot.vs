@@ -0,0 +1,27 @@
+#version 330 core
+layout (location = 0) in vec2 vertex; // time since the chart origin, value
+
+out float windowX;
+out vec3 lineColor;
+
+const int MAX_SLOTS = 16;
+
+uniform mat4 projection;
+uniform int slotStride;          // Vertices per buffer region
+uniform vec2 timeRange;          // Shown window, same origin as the samples
+uniform vec4 panelRect[MAX_SLOTS];   // x, y, width, height in pixels
+uniform vec2 valueRange[MAX_SLOTS];  // Values at the bottom and top edges
+uniform vec3 slotColor[MAX_SLOTS];
+
+void main()
+{
+    int slot = gl_VertexID / slotStride;
+    vec4 rect = panelRect[slot];
+    vec2 range = valueRange[slot];
+
+    windowX = (vertex.x - timeRange.x) / (timeRange.y - timeRange.x);
+    float height = clamp((vertex.y - range.x) / (range.y - range.x), 0.0, 1.0);
+
+    gl_Position = projection * vec4(rect.x + windowX * rect.z, rect.y + height * rect.w, 0.0, 1.0);
+    lineColor = slotColor[slot];
+}
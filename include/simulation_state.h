@@ -3,9 +3,19 @@
 
 #include <glm/glm.hpp>
 
+#include "adcs_mode.h"
+#include "attitude.h"
 #include "camera.h"
 #include "constants.h"
+#include "mekf.h"
 #include "reaction_wheel_system.h"
+#include "sensors.h"
+
+class EventDetector;
+class PilBridge;
+class TelecommandQueue;
+class TelemetryDownlink;
+class TelemetryRecorder;
 
 enum class CameraMode { FREE, FOLLOW, ONBOARD };
 
@@ -28,11 +38,36 @@ struct SimulationState
       
     glm::vec3 cubesatAngularVel { glm::vec3(0.0f) };
 
+    glm::mat3 inertia { CUBESAT_INERTIA };
+    glm::mat3 inverseInertia { INV_INERTIA }; // Recomputed wherever `inertia` is set
+
     ReactionWheelSystem wheels;
 
+    SensorSuite sensors;
+
+    AttitudeEstimator estimator;
+
+    ModeManager adcs;
+
+    // When set, external flight software supplies actuator commands instead of `adcs`
+    PilBridge* pil { nullptr };
+
+    // Optional, fed after every propagator step
+    EventDetector* events { nullptr };
+
+    // Optional, handed a frame after every physics step
+    TelemetryRecorder* recorder { nullptr };
+
+    // Optional, sends any CCSDS packets due after every physics step
+    TelemetryDownlink* downlink { nullptr };
+
+    // Optional, applies due ground commands before every physics step and may hold the
+    // step while paused
+    TelecommandQueue* telecommands { nullptr };
+
     CameraMode cameraMode { CameraMode::FREE };
 
-    float simElapsedTime { 0.0f };
+    double simElapsedTime { 0.0 }; // s; double so month-long runs still advance in 0.1 s steps
 };
 
 #endif
@@ -0,0 +1,181 @@
+#ifndef SMALL_MATRIX_H
+#define SMALL_MATRIX_H
+
+#include <array>
+#include <cmath>
+
+// Fixed-size, stack-allocated matrix for estimation code. Dimensions are template
+// parameters, so every loop below has a compile-time trip count and is unrolled by
+// the compiler; nothing here ever touches the heap.
+template <int R, int C, typename T = double>
+struct Matrix
+{
+    std::array<T, R * C> data {};
+
+    T& operator()(int r, int c) { return data[r * C + c]; }
+    const T& operator()(int r, int c) const { return data[r * C + c]; }
+
+    static Matrix zero() { return Matrix {}; }
+
+    static Matrix identity()
+    {
+        static_assert(R == C, "identity() requires a square matrix");
+        Matrix m {};
+        for (int i = 0; i < R; ++i)
+            m(i, i) = T(1);
+        return m;
+    }
+
+    Matrix<C, R, T> transposed() const
+    {
+        Matrix<C, R, T> t {};
+        for (int r = 0; r < R; ++r)
+            for (int c = 0; c < C; ++c)
+                t(c, r) = (*this)(r, c);
+        return t;
+    }
+
+    template <int BR, int BC>
+    Matrix<BR, BC, T> block(int row, int col) const
+    {
+        Matrix<BR, BC, T> b {};
+        for (int r = 0; r < BR; ++r)
+            for (int c = 0; c < BC; ++c)
+                b(r, c) = (*this)(row + r, col + c);
+        return b;
+    }
+
+    template <int BR, int BC>
+    void setBlock(int row, int col, const Matrix<BR, BC, T>& b)
+    {
+        for (int r = 0; r < BR; ++r)
+            for (int c = 0; c < BC; ++c)
+                (*this)(row + r, col + c) = b(r, c);
+    }
+
+    Matrix& operator+=(const Matrix& o)
+    {
+        for (int i = 0; i < R * C; ++i)
+            data[i] += o.data[i];
+        return *this;
+    }
+
+    Matrix& operator-=(const Matrix& o)
+    {
+        for (int i = 0; i < R * C; ++i)
+            data[i] -= o.data[i];
+        return *this;
+    }
+
+    Matrix& operator*=(T s)
+    {
+        for (int i = 0; i < R * C; ++i)
+            data[i] *= s;
+        return *this;
+    }
+};
+
+template <int N, typename T = double>
+using Vector = Matrix<N, 1, T>;
+
+template <int R, int C, typename T>
+Matrix<R, C, T> operator+(Matrix<R, C, T> a, const Matrix<R, C, T>& b) { return a += b; }
+
+template <int R, int C, typename T>
+Matrix<R, C, T> operator-(Matrix<R, C, T> a, const Matrix<R, C, T>& b) { return a -= b; }
+
+template <int R, int C, typename T>
+Matrix<R, C, T> operator*(Matrix<R, C, T> a, T s) { return a *= s; }
+
+template <int R, int C, typename T>
+Matrix<R, C, T> operator*(T s, Matrix<R, C, T> a) { return a *= s; }
+
+template <int R, int K, int C, typename T>
+Matrix<R, C, T> operator*(const Matrix<R, K, T>& a, const Matrix<K, C, T>& b)
+{
+    Matrix<R, C, T> m {};
+    for (int r = 0; r < R; ++r)
+        for (int k = 0; k < K; ++k)
+        {
+            T ark = a(r, k);
+            for (int c = 0; c < C; ++c)
+                m(r, c) += ark * b(k, c);
+        }
+    return m;
+}
+
+// Average with the transpose to remove round-off asymmetry from covariance updates
+template <int N, typename T>
+void symmetrize(Matrix<N, N, T>& m)
+{
+    for (int r = 0; r < N; ++r)
+        for (int c = r + 1; c < N; ++c)
+        {
+            T avg = T(0.5) * (m(r, c) + m(c, r));
+            m(r, c) = avg;
+            m(c, r) = avg;
+        }
+}
+
+// In-place Cholesky factorization (lower triangle). Returns false if not positive definite.
+template <int N, typename T>
+bool choleskyDecompose(Matrix<N, N, T>& a)
+{
+    for (int j = 0; j < N; ++j)
+    {
+        T d = a(j, j);
+        for (int k = 0; k < j; ++k)
+            d -= a(j, k) * a(j, k);
+        if (d <= T(0)) { return false; }
+        a(j, j) = std::sqrt(d);
+
+        for (int i = j + 1; i < N; ++i)
+        {
+            T s = a(i, j);
+            for (int k = 0; k < j; ++k)
+                s -= a(i, k) * a(j, k);
+            a(i, j) = s / a(j, j);
+        }
+        for (int c = j + 1; c < N; ++c)
+            a(j, c) = T(0);
+    }
+    return true;
+}
+
+// Solves A X = B for symmetric positive definite A
+template <int N, int M, typename T>
+bool choleskySolve(Matrix<N, N, T> a, Matrix<N, M, T>& b)
+{
+    if (!choleskyDecompose(a)) { return false; }
+
+    for (int m = 0; m < M; ++m)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            T s = b(i, m);
+            for (int k = 0; k < i; ++k)
+                s -= a(i, k) * b(k, m);
+            b(i, m) = s / a(i, i);
+        }
+        for (int i = N - 1; i >= 0; --i)
+        {
+            T s = b(i, m);
+            for (int k = i + 1; k < N; ++k)
+                s -= a(k, i) * b(k, m);
+            b(i, m) = s / a(i, i);
+        }
+    }
+    return true;
+}
+
+template <typename T>
+Matrix<3, 3, T> skew(T x, T y, T z)
+{
+    Matrix<3, 3, T> m {};
+    m(0, 1) = -z; m(0, 2) =  y;
+    m(1, 0) =  z; m(1, 2) = -x;
+    m(2, 0) = -y; m(2, 1) =  x;
+    return m;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded single-producer/single-consumer queue over preallocated storage. Neither
+// side ever locks or allocates: the producer publishes with a release store of the
+// head, the consumer frees slots with a release store of the tail. Head and tail sit
+// on separate cache lines so the two threads do not false-share. Capacity is rounded
+// up to a power of two so indices wrap with a mask.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity)
+    {
+        std::size_t size { 1 };
+        while (size < capacity)
+            size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. False, and nothing written, when the ring is full.
+    bool tryPush(const T& item)
+    {
+        std::size_t head { m_head.load(std::memory_order_relaxed) };
+        if (head - m_cachedTail > m_mask)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask) { return false; }
+        }
+        m_slots[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Longest run of readable items that is contiguous in memory, so it
+    // can be handed to a write call as is; release it with consume().
+    std::size_t peek(const T*& first)
+    {
+        std::size_t tail { m_tail.load(std::memory_order_relaxed) };
+        std::size_t available { m_head.load(std::memory_order_acquire) - tail };
+        std::size_t offset { tail & m_mask };
+        first = m_slots.data() + offset;
+        return std::min(available, m_slots.size() - offset);
+    }
+
+    void consume(std::size_t count) { m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release); }
+
+    bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+    std::size_t capacity() const { return m_slots.size(); }
+
+private:
+    std::vector<T> m_slots;
+    std::size_t m_mask { 0 };
+
+    alignas(64) std::atomic<std::size_t> m_head { 0 }; // Written by the producer
+    std::size_t m_cachedTail { 0 };                    // Producer's last view of m_tail
+    alignas(64) std::atomic<std::size_t> m_tail { 0 }; // Written by the consumer
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <cstdint>
+#include <vector>
+
+// Constant-memory summary of a stream of samples: Welford mean/variance, extremes
+// and a log-spaced histogram for percentiles. Accumulators from different threads
+// are combined with merge(), so no sample ever needs to be stored.
+class StreamingStats
+{
+public:
+    StreamingStats(double histMin = 1e-6, double histMax = 1e6, int numBins = 240);
+
+    void add(double x);
+    void merge(const StreamingStats& other);
+
+    std::uint64_t count() const;
+    double mean() const;
+    double stddev() const;
+    double min() const;
+    double max() const;
+
+    // Resolution is one histogram bin; values outside the range land in the end bins
+    double percentile(double p) const;
+
+private:
+    int binIndex(double x) const;
+    double binCenter(int idx) const;
+
+    double m_histMin;
+    double m_histMax;
+    double m_logMin;
+    double m_logStep;
+
+    std::uint64_t m_count { 0 };
+    double m_mean { 0.0 };
+    double m_m2 { 0.0 };
+    double m_min { 0.0 };
+    double m_max { 0.0 };
+    std::vector<std::uint64_t> m_bins;
+};
+
+#endif
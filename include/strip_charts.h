@@ -0,0 +1,112 @@
+#ifndef STRIP_CHARTS_H
+#define STRIP_CHARTS_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "series_downsampler.h"
+#include "shader_s.h"
+#include "telemetry_recorder.h"
+#include "text_renderer.h"
+
+// Uniform array length in plot.vs: one slot per series plus one per panel frame
+inline constexpr std::size_t MAX_PLOT_SLOTS { 16 };
+
+// Live strip charts drawn over the 3D view, one panel per quantity with any number of
+// series each. Every series owns a region of a single vertex buffer, twice `capacity`
+// vertices long, that new vertices are appended to. Each frame uploads the vertices
+// appended since the last one as a single range per series. A region that fills up
+// starts over with its newest `capacity` vertices, in one upload every `capacity`
+// appends. The newest vertices therefore always sit contiguously and draw as one line
+// strip. All series draw with one glMultiDrawArrays call, the panel frames with a
+// second; panel placement, scaling and colour come from uniform arrays indexed by region
+// in the vertex shader.
+//
+// The ring holds two spans' worth of vertices, one per span / (capacity / 2) s. When
+// the span changes, each ring is rebuilt from the series' SeriesDownsampler, which keeps
+// the whole history, so zooming out shows everything recorded rather than what the ring
+// happened to keep.
+class StripCharts
+{
+public:
+    StripCharts(Shader& plotShader, TextRenderer& textRenderer, Shader& textShader,
+                std::size_t capacity = 2048, double span = 120.0);
+    ~StripCharts();
+
+    StripCharts(const StripCharts&) = delete;
+    StripCharts& operator=(const StripCharts&) = delete;
+
+    // Panels and series are fixed once the first sample arrives
+    int addPanel(std::string_view title);
+    void addSeries(int panel, const glm::vec3& color);
+    void collatePlots();
+
+    // One value per series, in the order they were added; a time earlier than the
+    // last (a replay seek) starts every chart over
+    void append(double time, const float* values);
+    void render(int windowWidth, int windowHeight);
+
+    void updateAndRender(const TelemetryFrame& frame, float pointingError, int windowWidth, int windowHeight);
+
+    void setSpan(double seconds);
+    double getSpan() const;
+    void toggleVisible();
+
+private:
+    struct Panel
+    {
+        std::string title;
+        float min;
+        float max;
+    };
+
+    struct Series
+    {
+        int panel;
+        glm::vec3 color;
+        SeriesDownsampler history;
+
+        // CPU ring of the newest `capacity` vertices, for uploads and auto-scaling. Series
+        // share append times, but a rebuild can give each a different number of points.
+        std::vector<float> times;
+        std::vector<float> values;
+        std::size_t written { 0 };
+        std::size_t uploaded { 0 }; // Of `written`, how many the GPU region has
+        std::size_t end { 0 };      // Next free vertex in the GPU region
+    };
+
+    void createBuffers();
+    void reset(double time);
+    void rebuild();
+    void upload();
+    void autoScale();
+    glm::vec4 panelRect(std::size_t panel, int windowWidth, int windowHeight) const;
+
+    Shader& m_plotShader;
+    TextRenderer& m_textRenderer;
+    Shader& m_textShader;
+
+    std::size_t m_capacity;
+    double m_span;
+    bool m_visible { true };
+
+    std::vector<Panel> m_panels;
+    std::vector<Series> m_series;
+
+    double m_origin { 0.0 }; // Vertex times are relative to this, to stay exact in float; rebuild() moves it up
+    double m_now { 0.0 };
+    double m_lastVertex { 0.0 };
+    bool m_started { false };
+
+    unsigned int m_vao { 0 };
+    unsigned int m_vbo { 0 };
+    std::vector<int> m_firsts;
+    std::vector<int> m_counts;
+    std::vector<PlotPoint> m_staging;
+};
+
+#endif
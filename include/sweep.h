@@ -0,0 +1,64 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "scenario.h"
+
+// One swept scenario key and the value texts it takes, e.g. orbit.altitude_km
+struct SweepAxis
+{
+    std::string key;
+    std::vector<std::string> values;
+};
+
+// Sweep file, in the same TOML subset as scenarios:
+//   [sweep]  template = "scenarios/nominal.toml", output = "sweep_out", threads = 0
+//   [axes]   orbit.altitude_km = [350, 400, 450]   (any scenario key, one line each)
+// Jobs are the cartesian product of the axes, the last axis varying fastest. Relative
+// template and output paths are taken from the sweep file's directory.
+struct SweepSpec
+{
+    std::string templatePath;
+    std::string outputDir { "sweep_out" };
+    unsigned int threads { 0 };  // 0 = all hardware threads, within one shard
+    std::vector<SweepAxis> axes;
+    Scenario base;               // The template, loaded with the spec
+};
+
+bool loadSweep(const std::string& path, SweepSpec& spec, std::string& error);
+
+std::size_t sweepJobCount(const SweepSpec& spec);
+
+// Value text of every axis for job `index` (mixed radix on the axis sizes)
+std::vector<std::string> sweepJobValues(const SweepSpec& spec, std::size_t index);
+
+// Job j belongs to shard j % count. Round robin keeps shards balanced when run time
+// grows along an axis, and needs nothing but the shard's own index to compute.
+struct SweepShard
+{
+    std::size_t index { 0 };
+    std::size_t count { 1 };
+};
+
+// "i/N", with 0 <= i < N
+bool parseSweepShard(const std::string& text, SweepShard& shard);
+
+struct SweepReport
+{
+    std::size_t run { 0 };
+    std::size_t skipped { 0 };  // Result file already present, e.g. from before a preemption
+    std::size_t failed { 0 };
+};
+
+// Runs this shard's jobs headless and writes each result to <outputDir>/job_<index>.csv
+// (through a temporary file and a rename, so only complete results are ever seen)
+SweepReport runSweep(const SweepSpec& spec, const SweepShard& shard);
+
+// Concatenates every job file, in job order, into <outputDir>/summary.csv. Missing jobs
+// are counted and left out.
+bool mergeSweep(const SweepSpec& spec, std::size_t& merged, std::size_t& missing, std::string& error);
+
+#endif
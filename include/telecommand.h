@@ -0,0 +1,149 @@
+#ifndef TELECOMMAND_H
+#define TELECOMMAND_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+struct SimulationState;
+
+enum class TelecommandOpcode : std::uint8_t
+{
+    SET_MODE = 1,              // args[0]: AdcsMode index (0 DETUMBLE, 1 SUN_ACQUIRE, 2 NADIR)
+    SET_TARGET_ATTITUDE = 2,   // args: w, x, y, z body-to-world, held by NADIR mode instead of nadir
+    CLEAR_TARGET_ATTITUDE = 3,
+    SET_WHEEL_SPEEDS = 4,      // args[0..2]: rad/s, replacing the wheel torque of the active mode
+    CLEAR_WHEEL_SPEEDS = 5,
+    SET_SIM_SPEED = 6,         // args[0]: simulated seconds per wall second (interactive runs)
+    PAUSE = 7,
+    RESUME = 8,
+    STEP = 9,                  // args[0]: s of simulated time to run, then stay paused
+};
+
+enum class TelecommandStatus : std::uint8_t
+{
+    ACCEPTED = 0,   // Queued; runs at the first physics step starting at or after executeAt
+    REJECTED = 1,   // Unknown opcode or arguments out of range
+    QUEUE_FULL = 2,
+};
+
+// Wire format of the ground command port. Native byte order, like the PIL link: the
+// ground tool runs on the same host. Every command is answered with an ack carrying
+// its sequence.
+#pragma pack(push, 1)
+struct TelecommandPacket
+{
+    std::uint32_t magic;
+    std::uint32_t sequence;
+    double executeAt;          // s of simulated time; a time already passed means the next step
+    std::uint8_t opcode;       // TelecommandOpcode
+    std::uint8_t reserved[3];
+    float args[4];
+};
+
+struct TelecommandAck
+{
+    std::uint32_t magic;
+    std::uint32_t sequence;
+    std::uint8_t status;       // TelecommandStatus
+    std::uint8_t reserved[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TelecommandPacket) == 36, "Telecommand packet layout changed");
+static_assert(sizeof(TelecommandAck) == 12, "Telecommand ack layout changed");
+
+inline constexpr std::uint32_t TELECOMMAND_MAGIC { 0x54434D44 };     // "TCMD"
+inline constexpr std::uint32_t TELECOMMAND_ACK_MAGIC { 0x5443414B }; // "TCAK"
+
+const char* telecommandStatusName(TelecommandStatus status);
+
+// Opcode and argument ranges; `error` says what is wrong
+bool validateTelecommand(const TelecommandPacket& packet, std::string& error);
+
+// Command-line form: a name (mode, target, clear-target, wheels, clear-wheels, speed,
+// pause, resume, step), its arguments, then optionally `at <s>`. Modes may be given by
+// name.
+bool parseTelecommand(const std::vector<std::string>& words, TelecommandPacket& packet, std::string& error);
+
+// What the loop driving stepSimulation does between steps; the physics never reads it
+struct SimulationControl
+{
+    float simSpeed { 1.0f };
+    bool paused { false };
+    float stepRemaining { 0.0f }; // s still to run while paused
+};
+
+// Commands cross from the I/O thread to the simulation thread through a lock-free SPSC
+// ring, then wait in a list ordered by execution time (arrival order among equal times).
+// Every due command is applied before a physics step starts, so a command tagged with a
+// simulated time takes effect on the same step in every run.
+class TelecommandQueue
+{
+public:
+    explicit TelecommandQueue(float simSpeed, std::size_t capacity = 256);
+
+    // I/O thread only; false, and nothing queued, when the ring is full
+    bool push(const TelecommandPacket& packet);
+
+    // Simulation thread, before each physics step of length dt. Applies the due commands
+    // and returns false when the step must not run because the simulation is paused.
+    // Steps requested while paused are rounded to whole physics steps.
+    bool beginStep(SimulationState& state, float dt);
+
+    const SimulationControl& getControl() const;
+    bool isHeld() const; // Paused with nothing left to step: beginStep will refuse
+    std::uint64_t getApplied() const;
+
+private:
+    void apply(const TelecommandPacket& packet, SimulationState& state);
+
+    SpscRing<TelecommandPacket> m_ring;
+    std::vector<TelecommandPacket> m_pending;
+    SimulationControl m_control;
+    std::uint64_t m_applied { 0 };
+};
+
+// Serves one ground client at a time on a Unix-domain socket. A background thread does
+// all the socket I/O: it validates each command, queues it and acknowledges it, so the
+// simulation thread never touches the network. Unlike PilBridge, open() does not wait
+// for a client.
+class TelecommandServer
+{
+public:
+    TelecommandServer(std::string socketPath, TelecommandQueue& queue);
+    ~TelecommandServer();
+
+    TelecommandServer(const TelecommandServer&) = delete;
+    TelecommandServer& operator=(const TelecommandServer&) = delete;
+
+    bool open(std::string& error);
+    void close();
+
+    std::uint64_t getReceived() const;
+    std::uint64_t getRejected() const; // Invalid or refused for a full queue
+
+private:
+    void run();
+    TelecommandStatus handle(const TelecommandPacket& packet);
+
+    std::string m_socketPath;
+    TelecommandQueue& m_queue;
+    int m_listenFd { -1 };
+
+    std::thread m_thread;
+    std::atomic<bool> m_running { false };
+    std::atomic<std::uint64_t> m_received { 0 };
+    std::atomic<std::uint64_t> m_rejected { 0 };
+};
+
+// Ground side: connects, sends one command and waits up to timeoutMs for its ack
+bool sendTelecommand(const std::string& socketPath, const TelecommandPacket& packet, TelecommandStatus& status,
+                     std::string& error, int timeoutMs = 1000);
+
+#endif
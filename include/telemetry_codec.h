@@ -0,0 +1,39 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Streaming column codecs for smooth physical signals, after Facebook's Gorilla:
+//
+//   DELTA      time: delta-of-delta of the IEEE bit patterns. A fixed step gives a
+//              delta of deltas of zero, one bit per sample; deltas are shifted right
+//              by their common trailing zeros, so times that came from floats cost
+//              no more than doubles with short mantissas.
+//              floats: XOR with the previous value, storing only the changed bits
+//              (reusing the previous leading/trailing-zero window when it fits).
+//   QUANTIZED  floats rounded to a multiple of a step, then delta-of-delta of the
+//              integers. Lossy by half a step (or half a float ulp where that is
+//              coarser); slowly varying channels cost a few bits per sample.
+//
+// Every encoded column is self-contained; decoders need only the value count and
+// reject streams that run short.
+enum class ColumnEncoding : std::uint32_t
+{
+    RAW = 0,
+    DELTA = 1,
+    QUANTIZED = 2,
+};
+
+void encodeTimeColumn(const double* times, std::size_t count, std::vector<std::uint8_t>& out);
+bool decodeTimeColumn(const std::uint8_t* data, std::size_t bytes, std::size_t count, double* times);
+
+void encodeFloatColumn(const float* values, std::size_t count, std::vector<std::uint8_t>& out);
+bool decodeFloatColumn(const std::uint8_t* data, std::size_t bytes, std::size_t count, float* values);
+
+// Rounds `values` in place to what the decoder will reproduce, then encodes them
+void quantizeAndEncodeColumn(float* values, std::size_t count, float step, std::vector<std::uint8_t>& out);
+bool decodeQuantizedColumn(const std::uint8_t* data, std::size_t bytes, std::size_t count, float* values);
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef TELEMETRY_COLUMNS_H
+#define TELEMETRY_COLUMNS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "telemetry_codec.h"
+#include "telemetry_recorder.h"
+
+// Every float channel of a TelemetryFrame, in frame order. MODE is stored as a float.
+enum class TelemetryChannel
+{
+    POS_X, POS_Y, POS_Z,
+    VEL_X, VEL_Y, VEL_Z,
+    Q_W, Q_X, Q_Y, Q_Z,
+    RATE_X, RATE_Y, RATE_Z,
+    WHEEL_0, WHEEL_1, WHEEL_2,
+    TORQUE_X, TORQUE_Y, TORQUE_Z,
+    MODE,
+    COUNT
+};
+
+inline constexpr int TELEMETRY_CHANNELS { static_cast<int>(TelemetryChannel::COUNT) };
+
+const char* telemetryChannelName(TelemetryChannel channel);
+bool telemetryChannelFromName(std::string_view name, TelemetryChannel& channel);
+
+float channelValue(const TelemetryFrame& frame, TelemetryChannel channel);
+void setChannelValue(TelemetryFrame& frame, TelemetryChannel channel, float value);
+
+// Columnar telemetry file ("CTLC"):
+//
+//   header   "CTLC", uint32 version, uint32 chunk frames, uint32 channel count
+//   chunks   per chunk of up to `chunk frames` frames: the time column (double), then
+//            one float column per channel, each raw or encoded (telemetry_codec.h)
+//            and starting on an 8-byte boundary
+//   footer   per chunk: ColumnarChunkInfo, then one ColumnarColumnInfo for the time
+//            column and for each channel
+//   trailer  uint64 footer offset, "CTLC"
+//
+// Native byte order. The footer (under 1 KB per chunk, against 360 KB of column data at
+// the default chunk size) is all a reader needs to find the chunk holding a given time
+// or to answer min/max/mean over whole chunks; column data is only touched for the
+// edges of a query. Statistics describe the values as stored, after any quantization.
+//
+// Version 2 added encoded columns; version 1 files (all raw) still read.
+inline constexpr std::uint32_t COLUMNAR_FILE_VERSION { 2 };
+inline constexpr std::uint32_t COLUMNAR_DEFAULT_CHUNK { 4096 };
+
+#pragma pack(push, 1)
+struct ColumnarChunkInfo
+{
+    double firstTime;
+    double lastTime;
+    std::uint32_t frames;
+    std::uint32_t reserved;
+};
+
+struct ColumnarColumnInfo
+{
+    std::uint64_t offset;    // From the start of the file
+    std::uint32_t bytes;
+    std::uint32_t encoding;  // ColumnEncoding
+    double min;
+    double max;
+    double sum;
+};
+#pragma pack(pop)
+
+// How a writer encodes its columns. Without compression every column is raw.
+struct ColumnarCodec
+{
+    bool compress { true };
+    std::array<float, TELEMETRY_CHANNELS> quantum {}; // Per channel step, 0 = lossless
+};
+
+// Sets the quantum of every channel in a group: position (m), velocity (m/s),
+// attitude, body rates (rad/s), wheel speeds (rad/s) and torque (N*m), in that order
+void setQuantumGroups(ColumnarCodec& codec, const std::array<float, 6>& groups);
+
+// Streams frames into chunks; only the chunk being filled is held in memory
+class TelemetryColumnWriter
+{
+public:
+    bool open(const std::string& path, std::uint32_t chunkFrames = COLUMNAR_DEFAULT_CHUNK,
+              const ColumnarCodec& codec = {});
+    void append(const TelemetryFrame* frames, std::size_t count);
+    bool close(); // Writes the last partial chunk and the footer
+
+    bool good() const; // False once any write has failed
+    std::uint64_t getFrames() const;
+    std::uint64_t getFlushedFrames() const; // In chunks already written out
+
+private:
+    void flushChunk();
+    void writeColumn(const void* data, std::size_t bytes, ColumnEncoding encoding, ColumnarColumnInfo& info);
+
+    std::ofstream m_file;
+    std::uint32_t m_chunkFrames { COLUMNAR_DEFAULT_CHUNK };
+    ColumnarCodec m_codec;
+    std::vector<std::uint8_t> m_encoded;
+    std::uint64_t m_offset { 0 };
+    std::uint64_t m_frames { 0 };
+
+    std::vector<double> m_time;
+    std::vector<std::vector<float>> m_columns;
+    std::vector<ColumnarChunkInfo> m_chunks;
+    std::vector<ColumnarColumnInfo> m_columnInfo; // 1 + TELEMETRY_CHANNELS per chunk
+};
+
+struct ChannelSummary
+{
+    std::uint64_t count { 0 };
+    double min { 0.0 };
+    double max { 0.0 };
+    double mean { 0.0 };
+    std::size_t chunksScanned { 0 }; // Edge chunks whose column data had to be read
+};
+
+// Read-only view of a columnar file through mmap. Opening reads the footer only;
+// the operating system pages column data in as queries touch it. Encoded columns are
+// decoded on first touch into a one-chunk cache per column, so sequential reads decode
+// each chunk once. Not safe to share between threads.
+class TelemetryColumnReader
+{
+public:
+    TelemetryColumnReader() = default;
+    ~TelemetryColumnReader();
+
+    TelemetryColumnReader(const TelemetryColumnReader&) = delete;
+    TelemetryColumnReader& operator=(const TelemetryColumnReader&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    std::uint64_t frameCount() const;
+    std::size_t chunkCount() const;
+    double startTime() const;
+    double endTime() const;
+
+    // Last frame at or before `time` (the first frame if `time` precedes the run):
+    // binary search over the chunk index, then within one chunk's time column
+    std::uint64_t findFrame(double time) const;
+
+    double time(std::uint64_t frame) const;
+    float value(TelemetryChannel channel, std::uint64_t frame) const;
+    TelemetryFrame frame(std::uint64_t frame) const;
+
+    // Over frames with t0 <= time <= t1. Chunks entirely inside the range are answered
+    // from the footer.
+    ChannelSummary summarize(TelemetryChannel channel, double t0, double t1) const;
+
+private:
+    const ColumnarColumnInfo& column(std::size_t chunk, int column) const;
+    const double* timeColumn(std::size_t chunk) const;
+    const float* channelColumn(std::size_t chunk, TelemetryChannel channel) const;
+    std::size_t chunkOf(std::uint64_t frame) const;
+
+    struct DecodedColumn
+    {
+        std::size_t chunk { SIZE_MAX };
+        std::vector<double> times;
+        std::vector<float> values;
+    };
+
+    const std::uint8_t* m_map { nullptr };
+    std::size_t m_size { 0 };
+    std::uint32_t m_chunkFrames { 0 };
+    std::uint64_t m_frames { 0 };
+    std::vector<ColumnarChunkInfo> m_chunks;
+    const ColumnarColumnInfo* m_columnInfo { nullptr }; // Inside the mapping
+    mutable std::vector<DecodedColumn> m_decoded;        // One per column
+};
+
+bool readTelemetryFrames(const std::string& rawPath, std::vector<TelemetryFrame>& frames, std::string& error);
+
+// Rewrites a raw recorder file (telemetry_recorder.h) in the columnar format
+bool convertTelemetryToColumns(const std::string& rawPath, const std::string& columnarPath,
+                               std::uint32_t chunkFrames, const ColumnarCodec& codec, std::string& error);
+
+struct CodecBenchmark
+{
+    std::uint64_t frames { 0 };
+    std::uint64_t rawBytes { 0 };     // Time and channel columns, unencoded
+    std::uint64_t encodedBytes { 0 };
+    double encodeSeconds { 0.0 };
+    double decodeSeconds { 0.0 };
+    bool roundTrip { true };          // Decoded columns match what the writer stored
+    std::array<double, TELEMETRY_CHANNELS> maxError {}; // Against the input, from quantization
+};
+
+// Encodes `frames` chunk by chunk as the writer would, decodes them back and checks
+// the round trip. Transposition into columns is not timed.
+CodecBenchmark benchmarkTelemetryCodec(const std::vector<TelemetryFrame>& frames, const ColumnarCodec& codec,
+                                       std::uint32_t chunkFrames = COLUMNAR_DEFAULT_CHUNK);
+
+#endif
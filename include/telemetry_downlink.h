@@ -0,0 +1,112 @@
+#ifndef TELEMETRY_DOWNLINK_H
+#define TELEMETRY_DOWNLINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "orbit_math.h"
+#include "telemetry_recorder.h"
+#include "udp_downlink.h"
+
+struct SimulationState;
+
+// User data of the downlink packets, big-endian IEEE floats after the CCSDS headers
+//
+//   HOUSEKEEPING  the values TelemetryDisplay shows: wheel torque x, y, z (N*m), wheel
+//                 speeds 0, 1, 2 (rad/s), altitude (m); 28 bytes
+//   ATTITUDE      attitude w, x, y, z, body rates x, y, z (rad/s), then the ADCS mode
+//                 byte and 3 spare bytes; 32 bytes
+enum class DownlinkContent
+{
+    HOUSEKEEPING,
+    ATTITUDE,
+};
+
+inline constexpr std::size_t HOUSEKEEPING_DATA_SIZE { 28 };
+inline constexpr std::size_t ATTITUDE_DATA_SIZE { 32 };
+
+struct DownlinkStream
+{
+    std::uint16_t apid;
+    float rate;                // Hz of simulated time; 0 disables the stream
+    DownlinkContent content;
+};
+
+struct DownlinkConfig
+{
+    std::string host { "127.0.0.1" };
+    int port { 0 };                   // 0 = no downlink
+    std::vector<DownlinkStream> streams {
+        { 100, 1.0f, DownlinkContent::HOUSEKEEPING },
+        { 101, 10.0f, DownlinkContent::ATTITUDE },
+    };
+    std::size_t batchSize { 64 };     // Datagrams per sendmmsg
+};
+
+// Packs one packet of `content` from `frame` into `out`; returns its size
+std::size_t writeDownlinkPacket(std::uint8_t* out, DownlinkContent content, std::uint16_t apid,
+                                std::uint16_t sequenceCount, const TelemetryFrame& frame);
+
+// Streams CCSDS packets to a UDP port, one packet per datagram, each stream on its own
+// APID and sequence counter and sampled on its own simulated-time schedule. Packets due
+// in one physics step leave in one batch.
+class TelemetryDownlink
+{
+public:
+    explicit TelemetryDownlink(const DownlinkConfig& config);
+
+    bool open(std::string& error);
+
+    // Simulation thread, after every physics step
+    void update(const SimulationState& state);
+
+    const UdpSender& getSender() const;
+
+private:
+    struct StreamState
+    {
+        DownlinkStream stream;
+        double nextTime { 0.0 };
+        std::uint16_t sequence { 0 };
+        bool started { false };
+    };
+
+    DownlinkConfig m_config;
+    UdpSender m_sender;
+    std::vector<StreamState> m_streams;
+};
+
+struct DownlinkLoadReport
+{
+    std::uint64_t packets { 0 };
+    std::uint64_t bytes { 0 };
+    std::uint64_t syscalls { 0 };
+    std::uint64_t dropped { 0 };
+    double seconds { 0.0 };     // Wall time
+    double lateSeconds { 0.0 }; // Worst lag behind the packet schedule
+};
+
+// Stand-in for a constellation: every satellite sends housekeeping packets at `rate` Hz
+// of wall time, on APID firstApid + its index (wrapping below the idle APID), for
+// `seconds`. Orbits are Kepler-propagated from `constellation`; wheels read zero.
+// rate <= 0 sends as fast as possible.
+DownlinkLoadReport runDownlinkLoadTest(const DownlinkConfig& config, const std::vector<OrbitSample>& constellation,
+                                       std::uint16_t firstApid, double rate, double seconds);
+
+struct DownlinkListenReport
+{
+    std::uint64_t packets { 0 };
+    std::uint64_t bytes { 0 };
+    std::uint64_t malformed { 0 };
+    std::uint64_t sequenceGaps { 0 };   // Packets missing according to the sequence counters
+    std::map<std::uint16_t, std::uint64_t> perApid;
+};
+
+// Minimal ground-side check: validates every datagram as a space packet and tracks
+// per-APID sequence counters for `seconds` of wall time
+bool listenDownlink(int port, double seconds, DownlinkListenReport& report, std::string& error);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "spsc_ring.h"
+
+struct SimulationState;
+class TelemetryColumnWriter;
+struct ColumnarCodec;
+
+// One physics step. Packed so the file layout does not depend on the compiler;
+// native byte order, like the PIL packets.
+#pragma pack(push, 1)
+struct TelemetryFrame
+{
+    double time;               // s
+    float position[3];         // m, world frame (unscaled)
+    float velocity[3];         // m/s
+    float attitude[4];         // w, x, y, z, body to world
+    float bodyRates[3];        // rad/s, body frame
+    float wheelSpeeds[3];      // rad/s
+    float reactionTorque[3];   // N*m, world frame
+    std::uint8_t mode;         // AdcsMode
+    std::uint8_t reserved[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TelemetryFrame) == 88, "Telemetry frame layout changed");
+
+TelemetryFrame makeTelemetryFrame(const SimulationState& state);
+
+// File: "CTLM", uint32 version, uint32 frame size, then frames back to back
+inline constexpr std::uint32_t TELEMETRY_FILE_VERSION { 1 };
+
+// Records a frame per physics step without slowing the physics: record() copies the
+// frame into a preallocated SPSC ring and returns, and a background thread writes
+// whatever is in the ring straight from ring memory to an append-only file. If the
+// writer ever falls a whole ring behind, new frames are dropped (and counted) rather
+// than blocking the simulation.
+//
+// A path ending in ".tlc" is written in the columnar format (telemetry_columns.h)
+// instead; the writer thread transposes and encodes chunks off the simulation thread.
+class TelemetryRecorder
+{
+public:
+    explicit TelemetryRecorder(std::size_t capacity = 1 << 16);
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    bool open(const std::string& path);
+    bool open(const std::string& path, const ColumnarCodec& codec); // Codec applies to .tlc only
+
+    // Simulation thread only
+    void record(const SimulationState& state);
+
+    // Drains the ring, joins the writer and closes the file. False if a write failed
+    // (e.g. a full disk); recording stopped there and getError() says why.
+    bool stop();
+
+    std::uint64_t getRecorded() const;
+    std::uint64_t getDropped() const;
+    std::uint64_t getWritten() const; // Frames handed to the file without a write error
+    const std::string& getError() const;
+
+private:
+    void writerLoop();
+
+    SpscRing<TelemetryFrame> m_ring;
+    std::ofstream m_file;
+    std::unique_ptr<TelemetryColumnWriter> m_columns;
+    std::thread m_writer;
+    std::atomic<bool> m_running { false };
+    std::atomic<bool> m_failed { false };
+    std::string m_path;
+    std::string m_error; // Written by the writer thread, read after it is joined
+
+    std::uint64_t m_recorded { 0 };
+    std::uint64_t m_dropped { 0 };
+    std::atomic<std::uint64_t> m_written { 0 };
+};
+
+#endif
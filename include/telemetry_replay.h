@@ -0,0 +1,67 @@
+#ifndef TELEMETRY_REPLAY_H
+#define TELEMETRY_REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "telemetry_columns.h"
+#include "telemetry_recorder.h"
+
+struct SimulationState;
+
+// Recorded run, sampled at any time between its first and last frame. Columnar files
+// (.tlc) are read through the mmap reader; raw recordings are loaded into memory.
+class TelemetryReplay
+{
+public:
+    bool open(const std::string& path, std::string& error);
+
+    std::uint64_t frameCount() const;
+    double startTime() const;
+    double endTime() const;
+
+    // Position by cubic Hermite through the bracketing frames (their velocities are the
+    // end tangents), attitude by slerp, rates, wheel speeds and torque linearly; the
+    // mode is held from the earlier frame. Times outside the run clamp to its ends.
+    TelemetryFrame sample(double time) const;
+
+    TelemetryFrame frame(std::uint64_t index) const; // As recorded
+
+private:
+    std::uint64_t findFrame(double time) const;
+
+    bool m_columnar { false };
+    TelemetryColumnReader m_columns;
+    std::vector<TelemetryFrame> m_frames;
+};
+
+// Poses the state for rendering: time, orbit, attitude and angular velocity. Wheels,
+// controller and estimator are left alone; the replay never steps the physics.
+void applyTelemetryFrame(const TelemetryFrame& frame, SimulationState& state);
+
+// Playback position in simulated time, advanced by wall time times the speed. Negative
+// speeds play backwards; reaching either end pauses.
+class ReplayClock
+{
+public:
+    ReplayClock(double startTime, double endTime, double speed);
+
+    void advance(double wallSeconds);
+    void seek(double time);
+    void setSpeed(double speed);
+    void togglePause();
+
+    double getTime() const;
+    double getSpeed() const;
+    bool isPaused() const;
+
+private:
+    double m_start;
+    double m_end;
+    double m_time;
+    double m_speed;
+    bool m_paused { false };
+};
+
+#endif
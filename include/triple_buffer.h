@@ -0,0 +1,63 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Latest-value channel from one writer thread to one reader thread. The writer fills
+// the back buffer and publishes it by swapping it with the middle one; the reader takes
+// the middle buffer whenever a newer one has been published. Neither side ever waits or
+// copies under a lock, the writer can publish far more often than the reader looks, and
+// the reader always sees a complete value: the newest one at the time it asked.
+template <typename T>
+class TripleBuffer
+{
+public:
+    explicit TripleBuffer(const T& initial = T {})
+    {
+        for (Slot& slot : m_slots)
+            slot.value = initial;
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer only
+    T& back() { return m_slots[m_back].value; }
+
+    void publish()
+    {
+        std::uint8_t previous { m_middle.exchange(static_cast<std::uint8_t>(m_back | FRESH), std::memory_order_acq_rel) };
+        m_back = previous & INDEX_MASK;
+    }
+
+    // Reader only. Swaps in the newest published value, if there is one since the last
+    // call, and says whether it did; front() is valid either way.
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) { return false; }
+        std::uint8_t previous { m_middle.exchange(m_front, std::memory_order_acq_rel) };
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return m_slots[m_front].value; }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK { 0x3 };
+    static constexpr std::uint8_t FRESH { 0x4 };
+
+    // Own cache line each, so the writer filling one never slows the reader on another
+    struct alignas(64) Slot
+    {
+        T value;
+    };
+
+    std::array<Slot, 3> m_slots;
+    std::uint8_t m_back { 0 };                     // Writer's
+    alignas(64) std::atomic<std::uint8_t> m_middle { 1 };
+    alignas(64) std::uint8_t m_front { 2 };        // Reader's
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef UDP_DOWNLINK_H
+#define UDP_DOWNLINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Datagram sender that batches packets into one sendmmsg() call. sendmmsg is
+// Linux-only: elsewhere (macOS, the BSDs) there is no batched UDP send, so the same
+// batch goes out as one send() per datagram and getSyscalls() equals getPackets().
+// Packets are built in place in a preallocated arena, so nothing is copied in user
+// space between the encoder and the kernel. The socket is connected; datagrams refused
+// by the receiver are counted and dropped, never retried.
+class UdpSender
+{
+public:
+    explicit UdpSender(std::size_t batchSize = 64, std::size_t maxDatagram = 1472);
+    ~UdpSender();
+
+    UdpSender(const UdpSender&) = delete;
+    UdpSender& operator=(const UdpSender&) = delete;
+
+    // `host` is a name or an IPv4 address, resolved with getaddrinfo()
+    bool open(const std::string& host, int port, std::string& error);
+    void close();
+
+    // Room for one datagram of up to getMaxDatagram() bytes; commit() queues it and
+    // sends the batch once it is full
+    std::uint8_t* slot();
+    void commit(std::size_t size);
+    void flush();
+
+    std::size_t getMaxDatagram() const;
+    std::uint64_t getPackets() const;
+    std::uint64_t getBytes() const;
+    std::uint64_t getSyscalls() const;
+    std::uint64_t getDropped() const;
+
+private:
+    int m_fd { -1 };
+    std::size_t m_batchSize;
+    std::size_t m_maxDatagram;
+    std::vector<std::uint8_t> m_arena;
+    std::vector<std::size_t> m_sizes;
+    std::size_t m_queued { 0 };
+
+    std::uint64_t m_packets { 0 };
+    std::uint64_t m_bytes { 0 };
+    std::uint64_t m_syscalls { 0 };
+    std::uint64_t m_dropped { 0 };
+};
+
+// Receiving end, batching with recvmmsg() on Linux; elsewhere each wakeup drains up to
+// batchSize datagrams with one non-blocking recv() apiece
+class UdpReceiver
+{
+public:
+    explicit UdpReceiver(std::size_t batchSize = 64, std::size_t maxDatagram = 65536);
+    ~UdpReceiver();
+
+    UdpReceiver(const UdpReceiver&) = delete;
+    UdpReceiver& operator=(const UdpReceiver&) = delete;
+
+    bool open(int port, std::string& error);
+    void close();
+
+    // Waits up to timeoutMs for datagrams and hands each to `handler`; returns the count
+    std::size_t receive(int timeoutMs, const std::function<void(const std::uint8_t*, std::size_t)>& handler);
+
+private:
+    int m_fd { -1 };
+    std::size_t m_batchSize;
+    std::size_t m_maxDatagram;
+    std::vector<std::uint8_t> m_arena;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "adcs_mode.h"
+#include "constants.h"
+#include "environment.h"
+#include "nadir_controller.h"
+#include "simulation_state.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <array>
+#include <cmath>
+
+const char* adcsModeName(AdcsMode mode)
+{
+    switch (mode)
+    {
+        case AdcsMode::DETUMBLE:    return "DETUMBLE";
+        case AdcsMode::SUN_ACQUIRE: return "SUN_ACQUIRE";
+        case AdcsMode::NADIR:       return "NADIR";
+    }
+    return "UNKNOWN";
+}
+
+ModeManager::ModeManager(const AdcsConfig& config)
+    : m_config { config }, m_mode { config.initialMode }
+{
+    // First update runs a control cycle immediately
+    m_cycleAccum = (m_config.controlRate > 0.0f) ? 1.0 / m_config.controlRate : 0.0;
+    if (m_mode == AdcsMode::NADIR) { m_nadirEntryTime = 0.0; }
+}
+
+const ActuatorCommand& ModeManager::update(const SimulationState& state, float dt)
+{
+    m_time += dt;
+    m_cycleAccum += dt;
+
+    double period = (m_config.controlRate > 0.0f) ? 1.0 / m_config.controlRate : 0.0;
+    if (m_cycleAccum >= period)
+    {
+        m_cycleAccum = (period > 0.0) ? std::fmod(m_cycleAccum, period) : 0.0;
+        runCycle(state);
+    }
+
+    return m_command;
+}
+
+void ModeManager::runCycle(const SimulationState& state)
+{
+    const SensorReadings& readings = state.sensors.getReadings();
+
+    float bodyRate = readings.gyro.valid ? glm::length(readings.gyro.value) : 0.0f;
+
+    // Finite-difference field rate for B-dot, only when a new sample has arrived
+    if (readings.magField.valid && readings.magField.time > m_prevMagTime)
+    {
+        if (m_prevMagTime >= 0.0)
+            m_magRate = (readings.magField.value - m_prevMag)
+                       / static_cast<float>(readings.magField.time - m_prevMagTime);
+
+        m_prevMag = readings.magField.value;
+        m_prevMagTime = readings.magField.time;
+    }
+
+    // Sun error measured directly by the sun sensor, in the body frame
+    bool sunVisible = readings.sunVector.valid;
+    glm::vec3 sunErrorAxis { 0.0f };
+    float sunAngle { glm::pi<float>() };
+    if (sunVisible)
+    {
+        glm::vec3 axis = glm::normalize(m_config.sunAxisBody);
+        sunAngle = std::acos(glm::clamp(glm::dot(axis, readings.sunVector.value), -1.0f, 1.0f));
+
+        glm::vec3 cross = glm::cross(axis, readings.sunVector.value);
+        if (glm::length(cross) > 1e-6f)
+            sunErrorAxis = glm::normalize(cross);
+        else if (sunAngle > 1.0f) // Anti-parallel: any perpendicular axis will do
+            sunErrorAxis = glm::normalize(glm::cross(axis, glm::vec3(axis.y, axis.z, axis.x)));
+    }
+
+    evaluateTransitions(bodyRate, sunAngle, sunVisible);
+
+    bool useEstimate = state.estimator.getConfig().closedLoop && state.estimator.isInitialized();
+    glm::quat attitude = useEstimate ? state.estimator.getAttitude() : state.cubesatOrientation;
+    glm::vec3 angularVel = useEstimate ? state.estimator.getAngularVelocity() : state.cubesatAngularVel;
+
+    m_command = ActuatorCommand {};
+
+    switch (m_mode)
+    {
+        case AdcsMode::DETUMBLE:
+        {
+            m_command.dipole = glm::clamp(-m_config.bdotGain * m_magRate,
+                                          -m_config.maxDipole, m_config.maxDipole);
+            break;
+        }
+        case AdcsMode::SUN_ACQUIRE:
+        {
+            // Track a rate-limited slew towards the Sun; in eclipse this just damps rates
+            glm::vec3 desiredRate { 0.0f };
+            if (sunVisible)
+            {
+                float slewRate = glm::min(m_config.sunSlewGain * sunAngle, m_config.sunSlewRate);
+                desiredRate = attitude * (slewRate * sunErrorAxis);
+            }
+
+            // Desired body torque in world frame
+            glm::vec3 bodyTorque = m_config.sunRateGain * (desiredRate - angularVel);
+
+            m_command.wheelTorque = glm::clamp(-bodyTorque, -m_config.torqueLimit, m_config.torqueLimit);
+            break;
+        }
+        case AdcsMode::NADIR:
+        {
+            m_command.wheelTorque = m_hasAttitudeTarget
+                ? computeTrackingTorque(attitude, angularVel, m_attitudeTarget, glm::vec3(0.0f))
+                : computeNadirTorque(state, attitude, angularVel);
+            break;
+        }
+    }
+
+    if (m_hasWheelSpeedTarget)
+    {
+        std::array<float, 3> speeds = state.wheels.getSpeeds();
+        for (int i = 0; i < 3; ++i)
+            m_command.wheelTorque[i] = glm::clamp(m_config.wheelSpeedGain * (m_wheelSpeedTarget[i] - speeds[i]),
+                                                  -m_config.torqueLimit, m_config.torqueLimit);
+    }
+}
+
+void ModeManager::evaluateTransitions(float bodyRate, float sunAngle, bool sunVisible)
+{
+    if (bodyRate > m_config.detumbleEntryRate)
+    {
+        // Ground setpoints do not survive a tumble, whatever caused it
+        m_hasAttitudeTarget = false;
+        m_hasWheelSpeedTarget = false;
+        if (m_mode != AdcsMode::DETUMBLE)
+        {
+            setMode(AdcsMode::DETUMBLE);
+            return;
+        }
+    }
+
+    switch (m_mode)
+    {
+        case AdcsMode::DETUMBLE:
+            requestMode(AdcsMode::SUN_ACQUIRE, bodyRate < m_config.detumbleExitRate);
+            break;
+        case AdcsMode::SUN_ACQUIRE:
+            requestMode(AdcsMode::NADIR, sunVisible && sunAngle < m_config.sunAcquiredAngle);
+            break;
+        case AdcsMode::NADIR:
+            break;
+    }
+}
+
+// Switches once the condition has held continuously for the dwell time
+void ModeManager::requestMode(AdcsMode mode, bool condition)
+{
+    if (!condition)
+    {
+        m_conditionSince = -1.0;
+        return;
+    }
+
+    if (m_conditionSince < 0.0) { m_conditionSince = m_time; }
+    if (m_time - m_conditionSince >= m_config.dwellTime) { setMode(mode); }
+}
+
+void ModeManager::setMode(AdcsMode mode)
+{
+    m_mode = mode;
+    m_modeEntryTime = m_time;
+    m_conditionSince = -1.0;
+
+    if (mode == AdcsMode::NADIR && m_nadirEntryTime < 0.0)
+        m_nadirEntryTime = m_time;
+}
+
+void ModeManager::setAttitudeTarget(const glm::quat& target)
+{
+    m_attitudeTarget = glm::normalize(target);
+    m_hasAttitudeTarget = true;
+}
+
+void ModeManager::clearAttitudeTarget() { m_hasAttitudeTarget = false; }
+
+void ModeManager::setWheelSpeedTarget(const glm::vec3& speeds)
+{
+    m_wheelSpeedTarget = speeds;
+    m_hasWheelSpeedTarget = true;
+}
+
+void ModeManager::clearWheelSpeedTarget() { m_hasWheelSpeedTarget = false; }
+
+AdcsMode ModeManager::getMode() const { return m_mode; }
+
+double ModeManager::getTime() const { return m_time; }
+
+double ModeManager::getModeEntryTime() const { return m_modeEntryTime; }
+
+double ModeManager::getNadirEntryTime() const { return m_nadirEntryTime; }
+
+const ActuatorCommand& ModeManager::getCommand() const { return m_command; }
+
+const AdcsConfig& ModeManager::getConfig() const { return m_config; }
+
+bool ModeManager::hasAttitudeTarget() const { return m_hasAttitudeTarget; }
+
+bool ModeManager::hasWheelSpeedTarget() const { return m_hasWheelSpeedTarget; }
+
+glm::vec3 computeMagnetorquerTorque(const SimulationState& state, const glm::vec3& dipole)
+{
+    glm::vec3 fieldWorld = magneticField(state.cubesatPos / SCALE_FACTOR);
+    glm::vec3 dipoleWorld = state.cubesatOrientation * dipole;
+
+    return glm::cross(dipoleWorld, fieldWorld);
+}
@@ -1,16 +1,17 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "attitude.h"
+#include "simulation_state.h"
 #include <glm/gtx/quaternion.hpp>
 
 void updateAttitude(SimulationState& state, const glm::vec3& appliedTorque, float simDeltaTime)
 {
     glm::vec3 omega = state.cubesatAngularVel;
 
-    glm::vec3 angularMomentum = CUBESAT_INERTIA * omega;
+    glm::vec3 angularMomentum = state.inertia * omega;
 
     glm::vec3 omegaCrossH = glm::cross(omega, angularMomentum);
 
-    glm::vec3 angularAcc = INV_INERTIA * (appliedTorque - omegaCrossH);
+    glm::vec3 angularAcc = state.inverseInertia * (appliedTorque - omegaCrossH);
 
     // Integrate angular velocity
     state.cubesatAngularVel += angularAcc * simDeltaTime;
@@ -0,0 +1,91 @@
+#include "ccsds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr std::uint16_t SECONDARY_HEADER_FLAG { 0x0800 };
+    constexpr std::uint16_t UNSEGMENTED { 0xC000 }; // Sequence flags 0b11
+}
+
+void putBigEndian(std::uint8_t* out, std::uint32_t value)
+{
+    out[0] = static_cast<std::uint8_t>(value >> 24);
+    out[1] = static_cast<std::uint8_t>(value >> 16);
+    out[2] = static_cast<std::uint8_t>(value >> 8);
+    out[3] = static_cast<std::uint8_t>(value);
+}
+
+void putBigEndian(std::uint8_t* out, float value)
+{
+    std::uint32_t bits { 0 };
+    std::memcpy(&bits, &value, sizeof(bits));
+    putBigEndian(out, bits);
+}
+
+std::uint32_t getBigEndian32(const std::uint8_t* in)
+{
+    return (static_cast<std::uint32_t>(in[0]) << 24) | (static_cast<std::uint32_t>(in[1]) << 16)
+         | (static_cast<std::uint32_t>(in[2]) << 8) | in[3];
+}
+
+float getBigEndianFloat(const std::uint8_t* in)
+{
+    std::uint32_t bits { getBigEndian32(in) };
+    float value { 0.0f };
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::size_t writeSpacePacket(std::uint8_t* out, std::uint16_t apid, std::uint16_t sequenceCount, double time,
+                             const std::uint8_t* data, std::size_t dataSize)
+{
+    // Packet data field: secondary header plus user data; the length field holds its size - 1
+    std::size_t dataField { CCSDS_TIME_CODE_SIZE + dataSize };
+    std::uint16_t id { static_cast<std::uint16_t>(SECONDARY_HEADER_FLAG | (apid & CCSDS_APID_MASK)) };
+    std::uint16_t sequence { static_cast<std::uint16_t>(UNSEGMENTED | (sequenceCount & CCSDS_SEQUENCE_MASK)) };
+    std::uint16_t length { static_cast<std::uint16_t>(dataField - 1) };
+
+    out[0] = static_cast<std::uint8_t>(id >> 8);
+    out[1] = static_cast<std::uint8_t>(id);
+    out[2] = static_cast<std::uint8_t>(sequence >> 8);
+    out[3] = static_cast<std::uint8_t>(sequence);
+    out[4] = static_cast<std::uint8_t>(length >> 8);
+    out[5] = static_cast<std::uint8_t>(length);
+
+    double clamped { std::max(0.0, time) };
+    double seconds { std::floor(clamped) };
+    auto fraction = static_cast<std::uint32_t>(std::min(65535.0, std::round((clamped - seconds) * 65536.0)));
+    putBigEndian(out + CCSDS_PRIMARY_HEADER_SIZE, static_cast<std::uint32_t>(seconds));
+    out[CCSDS_PRIMARY_HEADER_SIZE + 4] = static_cast<std::uint8_t>(fraction >> 8);
+    out[CCSDS_PRIMARY_HEADER_SIZE + 5] = static_cast<std::uint8_t>(fraction);
+
+    std::uint8_t* userData { out + CCSDS_HEADERS_SIZE };
+    if (data != userData) { std::memmove(userData, data, dataSize); }
+    return CCSDS_HEADERS_SIZE + dataSize;
+}
+
+bool parseSpacePacket(const std::uint8_t* packet, std::size_t size, CcsdsPacketInfo& info)
+{
+    if (size < CCSDS_HEADERS_SIZE + 1) { return false; }
+
+    std::uint16_t id { static_cast<std::uint16_t>((packet[0] << 8) | packet[1]) };
+    std::uint16_t sequence { static_cast<std::uint16_t>((packet[2] << 8) | packet[3]) };
+    std::size_t length { static_cast<std::size_t>((packet[4] << 8) | packet[5]) + 1 };
+
+    bool versionAndType { (id & 0xF000) == 0 }; // Version 0, telemetry
+    if (!versionAndType || !(id & SECONDARY_HEADER_FLAG) || (sequence & 0xC000) != UNSEGMENTED
+        || length < CCSDS_TIME_CODE_SIZE + 1 || CCSDS_PRIMARY_HEADER_SIZE + length > size)
+        return false;
+
+    const std::uint8_t* time { packet + CCSDS_PRIMARY_HEADER_SIZE };
+    info.apid = id & CCSDS_APID_MASK;
+    info.sequenceCount = sequence & CCSDS_SEQUENCE_MASK;
+    info.time = getBigEndian32(time) + ((time[4] << 8) | time[5]) / 65536.0;
+    info.data = packet + CCSDS_HEADERS_SIZE;
+    info.dataSize = length - CCSDS_TIME_CODE_SIZE;
+    info.packetSize = CCSDS_PRIMARY_HEADER_SIZE + length;
+    return true;
+}
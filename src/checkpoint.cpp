@@ -0,0 +1,106 @@
+#include "checkpoint.h"
+#include "simulation_state.h"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    constexpr char MAGIC[4] { 'C', 'S', 'C', 'K' };
+    constexpr std::size_t HEADER_SIZE { sizeof(MAGIC) + 2 * sizeof(std::uint32_t) };
+
+    template <typename Archive>
+    void transferState(Archive& ar, SimulationState& s)
+    {
+        ar.value(s.deltaTime);
+        ar.value(s.lastFrame);
+        ar.value(s.lightPos);
+        ar.value(s.cubesatPos);
+        ar.value(s.cubesatVel);
+        ar.value(s.cubesatOrientation);
+        ar.value(s.cubesatAngularVel);
+        ar.value(s.inertia);
+        ar.object(s.wheels);
+        ar.object(s.sensors);
+        ar.object(s.estimator);
+        ar.object(s.adcs);
+        ar.value(s.cameraMode);
+        ar.value(s.simElapsedTime);
+    }
+
+    std::uint32_t payloadCrc(const std::uint8_t* data, std::size_t size)
+    {
+        return static_cast<std::uint32_t>(crc32(crc32(0L, Z_NULL, 0), data, static_cast<uInt>(size)));
+    }
+}
+
+std::vector<std::uint8_t> serializeState(const SimulationState& state)
+{
+    CheckpointWriter writer;
+    for (char c : MAGIC)
+        writer.value(c);
+    writer.value(CHECKPOINT_VERSION);
+    writer.value(std::uint32_t { 0 }); // Payload size, patched below
+
+    transferState(writer, const_cast<SimulationState&>(state));
+
+    std::vector<std::uint8_t>& data = writer.data();
+    std::uint32_t payloadSize { static_cast<std::uint32_t>(data.size() - HEADER_SIZE) };
+    std::memcpy(data.data() + sizeof(MAGIC) + sizeof(std::uint32_t), &payloadSize, sizeof(payloadSize));
+    writer.value(payloadCrc(data.data() + HEADER_SIZE, payloadSize));
+    return std::move(data);
+}
+
+bool deserializeState(const std::vector<std::uint8_t>& snapshot, SimulationState& state)
+{
+    CheckpointReader header(snapshot.data(), snapshot.size());
+    char magic[4] {};
+    std::uint32_t version { 0 }, payloadSize { 0 };
+    for (char& c : magic)
+        header.value(c);
+    header.value(version);
+    header.value(payloadSize);
+
+    if (!header.ok() || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != CHECKPOINT_VERSION)
+        return false;
+    if (snapshot.size() != HEADER_SIZE + payloadSize + sizeof(std::uint32_t)) { return false; }
+
+    const std::uint8_t* payload { snapshot.data() + HEADER_SIZE };
+    std::uint32_t crc { 0 };
+    std::memcpy(&crc, payload + payloadSize, sizeof(crc));
+    if (crc != payloadCrc(payload, payloadSize)) { return false; }
+
+    // Restore into a copy so a short payload cannot leave `state` half written
+    SimulationState restored = state;
+    CheckpointReader reader(payload, payloadSize);
+    transferState(reader, restored);
+    if (!reader.ok() || !reader.atEnd()) { return false; }
+    restored.inverseInertia = glm::inverse(restored.inertia);
+
+    state = restored;
+    return true;
+}
+
+bool saveCheckpoint(const std::string& path, const SimulationState& state)
+{
+    std::vector<std::uint8_t> snapshot = serializeState(state);
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) { return false; }
+        out.write(reinterpret_cast<const char*>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+        if (!out.flush()) { return false; }
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool loadCheckpoint(const std::string& path, SimulationState& state)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { return false; }
+    std::vector<std::uint8_t> snapshot((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return deserializeState(snapshot, state);
+}
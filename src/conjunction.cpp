@@ -0,0 +1,310 @@
+#include "conjunction.h"
+#include "parallel.h"
+#include "root_finding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+
+namespace
+{
+    struct ScreenedObject
+    {
+        KeplerPropagator orbit;
+        double perigee; // m, radius
+        double apogee;  // m, radius
+        double pad;     // m, half the screening distance plus the arc's bulge over one step
+    };
+
+    struct Cell
+    {
+        std::int32_t x, y, z;
+
+        bool operator==(const Cell& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+
+    // Uniform grid stored as a hash table built by counting sort. All buffers are kept
+    // between builds, so a step costs no allocation once the first one has run.
+    //
+    // The table is rebuilt in full every step rather than patched for the objects whose
+    // cells changed. Cells are only as wide as one step's swept box, so a box moves about
+    // its own width per step and nearly every object changes cells anyway (see
+    // ConjunctionStats::cellChanges). Patching would also need per-bucket lists in place
+    // of the counting sort's flat, allocation-free arrays, for no reduction in work.
+    class ScreeningGrid
+    {
+    public:
+        // Returns how many objects changed cells since the previous build
+        std::size_t build(const std::vector<glm::dvec3>& lo, const std::vector<glm::dvec3>& hi, double cellSize)
+        {
+            const std::size_t n { lo.size() };
+            bool compare { m_cellSize == cellSize && m_minCell.size() == n };
+            m_cellSize = cellSize;
+            m_minCell.resize(n);
+            m_maxCell.resize(n);
+            m_entries.clear();
+
+            std::size_t changed { 0 };
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                Cell a = cellOf(lo[i]);
+                Cell b = cellOf(hi[i]);
+                if (!compare || !(a == m_minCell[i]) || !(b == m_maxCell[i])) { ++changed; }
+                m_minCell[i] = a;
+                m_maxCell[i] = b;
+                for (std::int32_t x = a.x; x <= b.x; ++x)
+                    for (std::int32_t y = a.y; y <= b.y; ++y)
+                        for (std::int32_t z = a.z; z <= b.z; ++z)
+                            m_entries.push_back({ { x, y, z }, static_cast<std::uint32_t>(i) });
+            }
+
+            std::size_t tableSize { 1 };
+            while (tableSize < 2 * m_entries.size()) { tableSize <<= 1; }
+            m_mask = tableSize - 1;
+
+            m_bucketStart.assign(tableSize + 1, 0);
+            for (const Entry& e : m_entries)
+                ++m_bucketStart[bucketOf(e.cell) + 1];
+            for (std::size_t b = 0; b < tableSize; ++b)
+                m_bucketStart[b + 1] += m_bucketStart[b];
+
+            m_sorted.resize(m_entries.size());
+            m_fill.assign(m_bucketStart.begin(), m_bucketStart.end() - 1);
+            for (const Entry& e : m_entries)
+                m_sorted[m_fill[bucketOf(e.cell)]++] = e;
+            return changed;
+        }
+
+        // Calls fn(i, j) once for every pair of objects sharing at least one cell
+        template <typename Fn>
+        void forEachPair(Fn&& fn) const
+        {
+            for (std::size_t b = 0; b + 1 < m_bucketStart.size(); ++b)
+            {
+                std::uint32_t begin { m_bucketStart[b] };
+                std::uint32_t end { m_bucketStart[b + 1] };
+                for (std::uint32_t p = begin; p < end; ++p)
+                {
+                    for (std::uint32_t q = p + 1; q < end; ++q)
+                    {
+                        const Entry& a = m_sorted[p];
+                        const Entry& c = m_sorted[q];
+                        // Different cells can hash to the same bucket
+                        if (!(a.cell == c.cell)) { continue; }
+
+                        // Boxes sharing several cells: report only from the first shared one
+                        const Cell& ma = m_minCell[a.object];
+                        const Cell& mc = m_minCell[c.object];
+                        Cell first { std::max(ma.x, mc.x), std::max(ma.y, mc.y), std::max(ma.z, mc.z) };
+                        if (!(first == a.cell)) { continue; }
+
+                        fn(std::min(a.object, c.object), std::max(a.object, c.object));
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            Cell cell;
+            std::uint32_t object;
+        };
+
+        Cell cellOf(const glm::dvec3& p) const
+        {
+            return { static_cast<std::int32_t>(std::floor(p.x / m_cellSize)),
+                     static_cast<std::int32_t>(std::floor(p.y / m_cellSize)),
+                     static_cast<std::int32_t>(std::floor(p.z / m_cellSize)) };
+        }
+
+        std::size_t bucketOf(const Cell& c) const
+        {
+            std::uint32_t h { static_cast<std::uint32_t>(c.x) * 73856093u
+                            ^ static_cast<std::uint32_t>(c.y) * 19349663u
+                            ^ static_cast<std::uint32_t>(c.z) * 83492791u };
+            return h & m_mask;
+        }
+
+        double m_cellSize { 1.0 };
+        std::size_t m_mask { 0 };
+        std::vector<Cell> m_minCell;
+        std::vector<Cell> m_maxCell;
+        std::vector<Entry> m_entries;
+        std::vector<Entry> m_sorted;
+        std::vector<std::uint32_t> m_bucketStart;
+        std::vector<std::uint32_t> m_fill;
+    };
+
+    double rangeRate(const OrbitSample& a, const OrbitSample& b)
+    {
+        return glm::dot(a.pos - b.pos, a.vel - b.vel);
+    }
+
+    struct WorkerState
+    {
+        ScreeningGrid grid;
+        std::vector<OrbitSample> start;
+        std::vector<OrbitSample> end;
+        std::vector<glm::dvec3> lo;
+        std::vector<glm::dvec3> hi;
+        std::vector<Conjunction> found;
+        ConjunctionStats stats;
+    };
+}
+
+std::vector<Conjunction> screenConjunctions(const std::vector<OrbitSample>& objects,
+                                            const ConjunctionConfig& config,
+                                            ConjunctionStats* stats)
+{
+    const std::size_t n { objects.size() };
+    const double halfDistance { 0.5 * config.screeningDistance };
+
+    std::vector<ScreenedObject> screened;
+    screened.reserve(n);
+    double cellSize { config.screeningDistance };
+    for (const OrbitSample& o : objects)
+    {
+        KeplerPropagator orbit(o);
+        OrbitalElements el = stateToElements(o);
+        double perigee { el.semiMajorAxis * (1.0 - el.eccentricity) };
+        double apogee { el.semiMajorAxis * (1.0 + el.eccentricity) };
+
+        // The arc strays from its chord by at most a*dt^2/8
+        double maxAccel { Orbit::EARTH_MU / (perigee * perigee) };
+        double pad { halfDistance + maxAccel * config.step * config.step / 8.0 };
+
+        // A swept box must fit in one cell per axis so it never touches more than 2^3 cells
+        double maxSpeed { std::sqrt(Orbit::EARTH_MU * (2.0 / perigee - 1.0 / el.semiMajorAxis)) };
+        cellSize = std::max(cellSize, maxSpeed * config.step + 2.0 * pad);
+
+        screened.push_back({ orbit, perigee, apogee, pad });
+    }
+
+    const double endTime { config.startTime + config.duration };
+    const std::size_t steps { static_cast<std::size_t>(std::ceil(config.duration / config.step)) };
+    const std::size_t perTask { static_cast<std::size_t>(std::max(1, config.stepsPerTask)) };
+    const std::size_t tasks { (steps + perTask - 1) / perTask };
+
+    unsigned int threads = resolveThreadCount(config.threads);
+    std::vector<WorkerState> workers(threads);
+
+    auto stateAt = [&](std::size_t i, double t) { return screened[i].orbit.state(t); };
+
+    parallelFor(tasks, threads, [&](std::size_t task, unsigned int worker) {
+        WorkerState& ws = workers[worker];
+        ws.start.resize(n);
+        ws.end.resize(n);
+        ws.lo.resize(n);
+        ws.hi.resize(n);
+
+        std::size_t firstStep { task * perTask };
+        std::size_t lastStep { std::min(steps, firstStep + perTask) };
+
+        double t0 { config.startTime + config.step * static_cast<double>(firstStep) };
+        for (std::size_t i = 0; i < n; ++i)
+            ws.start[i] = stateAt(i, t0);
+
+        for (std::size_t k = firstStep; k < lastStep; ++k)
+        {
+            double t1 { std::min(t0 + config.step, endTime) };
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                ws.end[i] = stateAt(i, t1);
+                glm::dvec3 pad(screened[i].pad);
+                ws.lo[i] = glm::min(ws.start[i].pos, ws.end[i].pos) - pad;
+                ws.hi[i] = glm::max(ws.start[i].pos, ws.end[i].pos) + pad;
+            }
+
+            std::size_t changed { ws.grid.build(ws.lo, ws.hi, cellSize) };
+            if (k > firstStep)
+            {
+                ws.stats.cellChanges += changed;
+                ws.stats.cellChecks += n;
+            }
+
+            bool firstOverall { k == 0 };
+            bool lastOverall { k + 1 == steps };
+            ws.grid.forEachPair([&](std::uint32_t i, std::uint32_t j) {
+                ++ws.stats.broadPhasePairs;
+
+                if (glm::any(glm::lessThan(ws.hi[i], ws.lo[j])) || glm::any(glm::lessThan(ws.hi[j], ws.lo[i])))
+                    return;
+                const ScreenedObject& a = screened[i];
+                const ScreenedObject& b = screened[j];
+                if (a.perigee - config.screeningDistance > b.apogee
+                    || b.perigee - config.screeningDistance > a.apogee)
+                    return;
+                ++ws.stats.shellPairs;
+
+                // Relative motion stays within the two bulges of the straight line between the
+                // step's end points, which bounds the closest approach from below
+                glm::dvec3 d0 = ws.start[i].pos - ws.start[j].pos;
+                glm::dvec3 d1 = ws.end[i].pos - ws.end[j].pos;
+                glm::dvec3 chord = d1 - d0;
+                double u { glm::clamp(-glm::dot(d0, chord) / std::max(glm::dot(chord, chord), 1e-9), 0.0, 1.0) };
+                double bulge { a.pad + b.pad - config.screeningDistance };
+                if (glm::length(d0 + u * chord) - bulge >= config.screeningDistance)
+                    return;
+
+                double f0 { rangeRate(ws.start[i], ws.start[j]) };
+                double f1 { rangeRate(ws.end[i], ws.end[j]) };
+
+                double tca;
+                if (f0 < 0.0 && f1 >= 0.0)
+                {
+                    auto f = [&](double t) { return rangeRate(stateAt(i, t), stateAt(j, t)); };
+                    tca = brentRoot(f, t0, t1, f0, f1, config.timeTolerance);
+                }
+                else if (firstOverall && f0 >= 0.0) { tca = t0; }  // Already receding at the start
+                else if (lastOverall && f1 < 0.0) { tca = t1; }    // Still closing at the end
+                else { return; }
+                ++ws.stats.narrowPhasePairs;
+
+                OrbitSample sa = stateAt(i, tca);
+                OrbitSample sb = stateAt(j, tca);
+                double miss { glm::length(sa.pos - sb.pos) };
+                if (miss < config.screeningDistance)
+                {
+                    ws.found.push_back({ static_cast<int>(i), static_cast<int>(j), tca, miss,
+                                         glm::length(sa.vel - sb.vel) });
+                }
+            });
+
+            std::swap(ws.start, ws.end);
+            t0 = t1;
+        }
+    });
+
+    std::vector<Conjunction> result;
+    ConjunctionStats total;
+    for (const WorkerState& ws : workers)
+    {
+        result.insert(result.end(), ws.found.begin(), ws.found.end());
+        total.broadPhasePairs += ws.stats.broadPhasePairs;
+        total.shellPairs += ws.stats.shellPairs;
+        total.narrowPhasePairs += ws.stats.narrowPhasePairs;
+        total.cellChanges += ws.stats.cellChanges;
+        total.cellChecks += ws.stats.cellChecks;
+    }
+    if (stats) { *stats = total; }
+
+    std::sort(result.begin(), result.end(), [](const Conjunction& a, const Conjunction& b) {
+        if (a.tca != b.tca) { return a.tca < b.tca; }
+        if (a.first != b.first) { return a.first < b.first; }
+        return a.second < b.second;
+    });
+    return result;
+}
+
+void writeConjunctionCsv(std::ostream& out, const std::vector<Conjunction>& conjunctions)
+{
+    out << "first,second,tca_s,miss_distance_m,relative_speed_mps\n";
+    out << std::fixed << std::setprecision(3);
+    for (const Conjunction& c : conjunctions)
+    {
+        out << c.first << ',' << c.second << ',' << c.tca << ','
+            << c.missDistance << ',' << c.relativeSpeed << '\n';
+    }
+}
@@ -0,0 +1,202 @@
+#include "contact_windows.h"
+#include "parallel.h"
+#include "root_finding.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+    // Station data laid out as parallel arrays so the per-sample loop over stations
+    // is a straight run of arithmetic the compiler can vectorize
+    struct StationArrays
+    {
+        std::vector<double> x, y, z;    // Earth-fixed position, m
+        std::vector<double> ux, uy, uz; // Local vertical
+        std::vector<double> sinMinElevation;
+
+        explicit StationArrays(const std::vector<GroundStation>& stations)
+        {
+            for (const GroundStation& gs : stations)
+            {
+                glm::dvec3 p = geodeticToEarthFixed(gs.latitude, gs.longitude, gs.altitude);
+                glm::dvec3 u = glm::normalize(p);
+                x.push_back(p.x); y.push_back(p.y); z.push_back(p.z);
+                ux.push_back(u.x); uy.push_back(u.y); uz.push_back(u.z);
+                sinMinElevation.push_back(std::sin(gs.minElevation));
+            }
+        }
+
+        std::size_t size() const { return x.size(); }
+    };
+
+    // Elevation margin: positive while the satellite is above the station's mask
+    double elevationMargin(const StationArrays& st, std::size_t j, const glm::dvec3& satFixed)
+    {
+        double dx { satFixed.x - st.x[j] };
+        double dy { satFixed.y - st.y[j] };
+        double dz { satFixed.z - st.z[j] };
+        double range { std::sqrt(dx * dx + dy * dy + dz * dz) };
+        return dx * st.ux[j] + dy * st.uy[j] + dz * st.uz[j] - st.sinMinElevation[j] * range;
+    }
+
+    double elevation(const StationArrays& st, std::size_t j, const glm::dvec3& satFixed)
+    {
+        double dx { satFixed.x - st.x[j] };
+        double dy { satFixed.y - st.y[j] };
+        double dz { satFixed.z - st.z[j] };
+        double range { std::sqrt(dx * dx + dy * dy + dz * dz) };
+        return std::asin(glm::clamp((dx * st.ux[j] + dy * st.uy[j] + dz * st.uz[j]) / range, -1.0, 1.0));
+    }
+
+    // Passes are single-peaked in elevation, so a golden section search finds the top
+    template <typename Fn>
+    double goldenSectionMax(Fn&& f, double a, double b, double tol)
+    {
+        const double invPhi { 0.6180339887498949 };
+        double c { b - invPhi * (b - a) };
+        double d { a + invPhi * (b - a) };
+        double fc { f(c) };
+        double fd { f(d) };
+        while (b - a > tol)
+        {
+            if (fc > fd)
+            {
+                b = d; d = c; fd = fc;
+                c = b - invPhi * (b - a);
+                fc = f(c);
+            }
+            else
+            {
+                a = c; c = d; fc = fd;
+                d = a + invPhi * (b - a);
+                fd = f(d);
+            }
+        }
+        return 0.5 * (a + b);
+    }
+
+    void findWindowsForSatellite(int satIdx, const OrbitSample& epoch, const StationArrays& st,
+                                 const ContactConfig& config, std::vector<ContactWindow>& out)
+    {
+        const std::size_t n { st.size() };
+        const KeplerPropagator orbit(epoch);
+        const double endTime { config.startTime + config.duration };
+
+        auto fixedPosition = [&orbit](double t) { return inertialToEarthFixed(orbit.position(t), t); };
+
+        std::vector<double> previous(n);
+        std::vector<double> current(n);
+        std::vector<double> openAos(n, -1.0); // AOS of the pass in progress, negative if none
+
+        auto closePass = [&](std::size_t j, double aos, double los) {
+            ContactWindow w;
+            w.satellite = satIdx;
+            w.station = static_cast<int>(j);
+            w.aos = aos;
+            w.los = los;
+            w.maxElevationTime = goldenSectionMax(
+                [&](double t) { return elevation(st, j, fixedPosition(t)); }, aos, los, config.timeTolerance);
+            w.maxElevation = elevation(st, j, fixedPosition(w.maxElevationTime));
+            out.push_back(w);
+        };
+
+        double tPrev { config.startTime };
+        {
+            glm::dvec3 p = fixedPosition(tPrev);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                previous[j] = elevationMargin(st, j, p);
+                if (previous[j] > 0.0) { openAos[j] = tPrev; }
+            }
+        }
+
+        while (tPrev < endTime)
+        {
+            double t { std::min(tPrev + config.coarseStep, endTime) };
+            glm::dvec3 p = fixedPosition(t);
+
+            for (std::size_t j = 0; j < n; ++j)
+                current[j] = elevationMargin(st, j, p);
+
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                if ((previous[j] > 0.0) == (current[j] > 0.0)) { continue; }
+
+                double crossing { brentRoot([&](double tt) { return elevationMargin(st, j, fixedPosition(tt)); },
+                                            tPrev, t, previous[j], current[j], config.timeTolerance) };
+                if (current[j] > 0.0)
+                {
+                    openAos[j] = crossing;
+                }
+                else if (openAos[j] >= 0.0)
+                {
+                    closePass(j, openAos[j], crossing);
+                    openAos[j] = -1.0;
+                }
+            }
+
+            std::swap(previous, current);
+            tPrev = t;
+        }
+
+        for (std::size_t j = 0; j < n; ++j)
+            if (openAos[j] >= 0.0) { closePass(j, openAos[j], endTime); }
+    }
+}
+
+std::vector<GroundStation> defaultGroundStations()
+{
+    auto deg = [](double d) { return glm::radians(d); };
+    return {
+        { "Svalbard",   deg(78.23),  deg(15.39),   500.0 },
+        { "Fairbanks",  deg(64.86),  deg(-147.85), 300.0 },
+        { "Wallops",    deg(37.94),  deg(-75.46),  10.0 },
+        { "Kiruna",     deg(67.86),  deg(20.96),   400.0 },
+        { "Hartebeest", deg(-25.89), deg(27.69),   1500.0 },
+        { "Santiago",   deg(-33.15), deg(-70.67),  700.0 },
+        { "Singapore",  deg(1.40),   deg(103.83),  20.0 },
+        { "McMurdo",    deg(-77.84), deg(166.67),  100.0 },
+    };
+}
+
+std::vector<ContactWindow> computeContactWindows(const std::vector<OrbitSample>& satellites,
+                                                 const std::vector<GroundStation>& stations,
+                                                 const ContactConfig& config)
+{
+    const StationArrays st(stations);
+
+    unsigned int threads = resolveThreadCount(config.threads);
+    std::vector<std::vector<ContactWindow>> perWorker(threads);
+
+    parallelFor(satellites.size(), threads, [&](std::size_t satIdx, unsigned int worker) {
+        findWindowsForSatellite(static_cast<int>(satIdx), satellites[satIdx], st, config, perWorker[worker]);
+    });
+
+    std::vector<ContactWindow> windows;
+    for (auto& w : perWorker)
+        windows.insert(windows.end(), w.begin(), w.end());
+
+    std::sort(windows.begin(), windows.end(), [](const ContactWindow& a, const ContactWindow& b) {
+        if (a.aos != b.aos) { return a.aos < b.aos; }
+        if (a.satellite != b.satellite) { return a.satellite < b.satellite; }
+        return a.station < b.station;
+    });
+    return windows;
+}
+
+void writeContactCsv(std::ostream& out, const std::vector<ContactWindow>& windows,
+                     const std::vector<GroundStation>& stations)
+{
+    out << "satellite,station,aos_s,los_s,duration_s,max_elevation_deg,max_elevation_time_s\n";
+    out << std::fixed << std::setprecision(3);
+    for (const ContactWindow& w : windows)
+    {
+        out << w.satellite << ',' << stations[static_cast<std::size_t>(w.station)].name << ','
+            << w.aos << ',' << w.los << ',' << (w.los - w.aos) << ','
+            << glm::degrees(w.maxElevation) << ',' << w.maxElevationTime << '\n';
+    }
+}
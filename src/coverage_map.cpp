@@ -0,0 +1,279 @@
+#include "coverage_map.h"
+#include "parallel.h"
+#include "png_writer.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+    constexpr std::uint32_t RASTER_VERSION { 1 };
+
+    struct GridGeometry
+    {
+        int width;
+        int height;
+        double dLat;
+        double dLon;
+        std::vector<double> sinLat, cosLat; // Row centres
+
+        GridGeometry(int w, int h)
+            : width { w }, height { h }, dLat { glm::pi<double>() / h }, dLon { glm::two_pi<double>() / w }
+        {
+            for (int r = 0; r < h; ++r)
+            {
+                double lat { glm::half_pi<double>() - (r + 0.5) * dLat };
+                sinLat.push_back(std::sin(lat));
+                cosLat.push_back(std::cos(lat));
+            }
+        }
+    };
+
+    // Sub-satellite point and the Earth central angle of the visibility circle
+    struct Footprint
+    {
+        double latitude, longitude;
+        double sinLat, cosLat;
+        double halfAngle, cosHalfAngle;
+    };
+
+    Footprint footprintAt(const glm::dvec3& satFixed, double minElevation)
+    {
+        double r { glm::length(satFixed) };
+        Footprint f;
+        f.latitude = std::asin(glm::clamp(satFixed.z / r, -1.0, 1.0));
+        f.longitude = std::atan2(satFixed.y, satFixed.x);
+        f.sinLat = std::sin(f.latitude);
+        f.cosLat = std::cos(f.latitude);
+
+        // Triangle Earth centre / station / satellite with the elevation angle at the station
+        double ratio { std::min(1.0, Orbit::EARTH_RADIUS / r) };
+        f.halfAngle = std::max(0.0, std::acos(ratio * std::cos(minElevation)) - minElevation);
+        f.cosHalfAngle = std::cos(f.halfAngle);
+        return f;
+    }
+
+    // Calls fn(cell) once for every cell whose centre is inside the footprint: a row range
+    // from the latitude extent, then per row the longitude half-width from the spherical
+    // law of cosines, so no cell outside the circle is ever tested.
+    template <typename Fn>
+    void forEachCoveredCell(const GridGeometry& grid, const Footprint& f, Fn&& fn)
+    {
+        const double pi { glm::pi<double>() };
+        int rowMin = static_cast<int>(std::ceil((glm::half_pi<double>() - (f.latitude + f.halfAngle)) / grid.dLat - 0.5));
+        int rowMax = static_cast<int>(std::floor((glm::half_pi<double>() - (f.latitude - f.halfAngle)) / grid.dLat - 0.5));
+        rowMin = std::max(rowMin, 0);
+        rowMax = std::min(rowMax, grid.height - 1);
+
+        for (int row = rowMin; row <= rowMax; ++row)
+        {
+            std::size_t base { static_cast<std::size_t>(row) * static_cast<std::size_t>(grid.width) };
+            double sinTerm { grid.sinLat[row] * f.sinLat };
+            double cosTerm { grid.cosLat[row] * f.cosLat };
+
+            double halfWidth;
+            if (cosTerm < 1e-12)
+            {
+                if (sinTerm < f.cosHalfAngle) { continue; }
+                halfWidth = pi;
+            }
+            else
+            {
+                double c { (f.cosHalfAngle - sinTerm) / cosTerm };
+                if (c > 1.0) { continue; }
+                halfWidth = (c <= -1.0) ? pi : std::acos(c);
+            }
+
+            int colMin = static_cast<int>(std::ceil((f.longitude - halfWidth + pi) / grid.dLon - 0.5));
+            int colMax = static_cast<int>(std::floor((f.longitude + halfWidth + pi) / grid.dLon - 0.5));
+            if (colMax - colMin + 1 >= grid.width)
+            {
+                colMin = 0;
+                colMax = grid.width - 1;
+            }
+
+            for (int col = colMin; col <= colMax; ++col)
+            {
+                int wrapped { ((col % grid.width) + grid.width) % grid.width };
+                fn(base + static_cast<std::size_t>(wrapped));
+            }
+        }
+    }
+
+    std::size_t groundTrackCell(const GridGeometry& grid, const Footprint& f)
+    {
+        int row = static_cast<int>((glm::half_pi<double>() - f.latitude) / grid.dLat);
+        int col = static_cast<int>((f.longitude + glm::pi<double>()) / grid.dLon);
+        row = glm::clamp(row, 0, grid.height - 1);
+        col = ((col % grid.width) + grid.width) % grid.width;
+        return static_cast<std::size_t>(row) * static_cast<std::size_t>(grid.width) + static_cast<std::size_t>(col);
+    }
+
+    // One worker's grids; lastCovered carries the most recent step each cell was in view
+    struct WorkerGrids
+    {
+        std::vector<std::uint32_t> groundTrack, coveredSteps, accesses;
+        std::vector<std::int64_t> lastCovered;
+
+        explicit WorkerGrids(std::size_t cells)
+            : groundTrack(cells, 0), coveredSteps(cells, 0), accesses(cells, 0), lastCovered(cells, -2)
+        {
+        }
+    };
+
+    glm::u8vec3 colourRamp(double f)
+    {
+        static const glm::dvec3 stops[] { { 30, 40, 120 }, { 20, 140, 200 }, { 60, 190, 90 }, { 240, 220, 40 }, { 220, 50, 30 } };
+        constexpr int last { 4 };
+
+        double x { glm::clamp(f, 0.0, 1.0) * last };
+        int i { std::min(static_cast<int>(x), last - 1) };
+        glm::dvec3 c = glm::mix(stops[i], stops[i + 1], x - i);
+        return glm::u8vec3(c + 0.5);
+    }
+}
+
+double CoverageMap::coverageFraction(std::size_t cell) const
+{
+    return (steps > 0) ? static_cast<double>(coveredSteps[cell]) / steps : 0.0;
+}
+
+double CoverageMap::globalCoverage() const
+{
+    double covered { 0.0 }, area { 0.0 };
+    for (int row = 0; row < height; ++row)
+    {
+        double w { std::cos(glm::half_pi<double>() - (row + 0.5) * glm::pi<double>() / height) };
+        for (int col = 0; col < width; ++col)
+            covered += w * coverageFraction(static_cast<std::size_t>(row) * width + col);
+        area += w * width;
+    }
+    return (area > 0.0) ? covered / area : 0.0;
+}
+
+double CoverageMap::meanRevisitInterval() const
+{
+    double sum { 0.0 }, area { 0.0 };
+    for (int row = 0; row < height; ++row)
+    {
+        double w { std::cos(glm::half_pi<double>() - (row + 0.5) * glm::pi<double>() / height) };
+        for (int col = 0; col < width; ++col)
+        {
+            std::uint32_t n { accesses[static_cast<std::size_t>(row) * width + col] };
+            if (n == 0) { continue; }
+            sum += w * steps * step / n;
+            area += w;
+        }
+    }
+    return (area > 0.0) ? sum / area : 0.0;
+}
+
+CoverageMap computeCoverageMap(const std::vector<OrbitSample>& satellites, const CoverageConfig& config)
+{
+    const GridGeometry grid(std::max(1, config.width), std::max(1, config.height));
+    const std::size_t cells { static_cast<std::size_t>(grid.width) * static_cast<std::size_t>(grid.height) };
+
+    CoverageMap map;
+    map.width = grid.width;
+    map.height = grid.height;
+    map.startTime = config.startTime;
+    map.step = config.step;
+    map.steps = static_cast<std::uint32_t>(std::max(0.0, std::floor(config.duration / config.step)) + 1);
+
+    std::vector<KeplerPropagator> propagators;
+    for (const OrbitSample& s : satellites)
+        propagators.emplace_back(s);
+
+    const std::size_t stepsPerTask { std::max<std::size_t>(1, config.stepsPerTask) };
+    const std::size_t tasks { (map.steps + stepsPerTask - 1) / stepsPerTask };
+    unsigned int threads = static_cast<unsigned int>(std::min<std::size_t>(resolveThreadCount(config.threads), tasks));
+    std::vector<WorkerGrids> workers(threads, WorkerGrids(cells));
+
+    parallelFor(tasks, threads, [&](std::size_t task, unsigned int worker) {
+        WorkerGrids& g = workers[worker];
+        const std::int64_t first { static_cast<std::int64_t>(task * stepsPerTask) };
+        const std::int64_t end { std::min<std::int64_t>(first + static_cast<std::int64_t>(stepsPerTask), map.steps) };
+
+        // Starting one step early only seeds lastCovered, so an access already under way
+        // at the block edge continues instead of counting as a new one
+        for (std::int64_t k = std::max<std::int64_t>(first - 1, 0); k < end; ++k)
+        {
+            const bool accumulate { k >= first };
+            double time { config.startTime + k * config.step };
+
+            for (const KeplerPropagator& prop : propagators)
+            {
+                Footprint f = footprintAt(inertialToEarthFixed(prop.position(time), time), config.minElevation);
+                if (accumulate) { ++g.groundTrack[groundTrackCell(grid, f)]; }
+
+                forEachCoveredCell(grid, f, [&](std::size_t cell) {
+                    std::int64_t& last = g.lastCovered[cell];
+                    if (last == k) { return; } // Already in view of another satellite this step
+                    if (accumulate)
+                    {
+                        ++g.coveredSteps[cell];
+                        if (last != k - 1) { ++g.accesses[cell]; }
+                    }
+                    last = k;
+                });
+            }
+        }
+    });
+
+    map.groundTrack.assign(cells, 0);
+    map.coveredSteps.assign(cells, 0);
+    map.accesses.assign(cells, 0);
+    for (const WorkerGrids& g : workers)
+    {
+        for (std::size_t i = 0; i < cells; ++i)
+        {
+            map.groundTrack[i] += g.groundTrack[i];
+            map.coveredSteps[i] += g.coveredSteps[i];
+            map.accesses[i] += g.accesses[i];
+        }
+    }
+    return map;
+}
+
+bool writeCoveragePng(const std::string& path, const CoverageMap& map)
+{
+    const std::size_t cells { static_cast<std::size_t>(map.width) * static_cast<std::size_t>(map.height) };
+    std::vector<std::uint8_t> rgb(cells * 3);
+
+    for (std::size_t i = 0; i < cells; ++i)
+    {
+        glm::u8vec3 c = (map.groundTrack[i] > 0) ? glm::u8vec3(255)
+                      : (map.coveredSteps[i] == 0) ? glm::u8vec3(16)
+                      : colourRamp(map.coverageFraction(i));
+        rgb[3 * i] = c.r;
+        rgb[3 * i + 1] = c.g;
+        rgb[3 * i + 2] = c.b;
+    }
+    return writePngRgb(path, map.width, map.height, rgb);
+}
+
+bool writeCoverageRaster(const std::string& path, const CoverageMap& map)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) { return false; }
+
+    auto put = [&out](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto putLayer = [&out](const std::vector<std::uint32_t>& layer) {
+        out.write(reinterpret_cast<const char*>(layer.data()), static_cast<std::streamsize>(layer.size() * sizeof(std::uint32_t)));
+    };
+
+    out.write("CVRG", 4);
+    put(RASTER_VERSION);
+    put(static_cast<std::uint32_t>(map.width));
+    put(static_cast<std::uint32_t>(map.height));
+    put(map.steps);
+    put(map.startTime);
+    put(map.step);
+    putLayer(map.groundTrack);
+    putLayer(map.coveredSteps);
+    putLayer(map.accesses);
+    return static_cast<bool>(out);
+}
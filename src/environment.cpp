@@ -0,0 +1,35 @@
+#include "environment.h"
+#include "constants.h"
+
+glm::vec3 earthSpinAxis()
+{
+    float tilt = glm::radians(Physics::EARTH_AXIAL_TILT_DEG);
+    return glm::vec3(glm::sin(tilt), glm::cos(tilt), 0.0f);
+}
+
+glm::vec3 sunDirection(const SimulationState& state)
+{
+    return glm::normalize(state.lightPos);
+}
+
+bool isInEclipse(const glm::vec3& posMeters, const glm::vec3& sunDir)
+{
+    float alongSun = glm::dot(posMeters, sunDir);
+    if (alongSun > 0.0f) { return false; }
+
+    glm::vec3 perpendicular = posMeters - alongSun * sunDir;
+    return glm::length(perpendicular) < Physics::EARTH_RADIUS;
+}
+
+glm::vec3 magneticField(const glm::vec3& posMeters)
+{
+    // Dipole moment points towards geographic south
+    glm::vec3 m = -earthSpinAxis();
+
+    float r = glm::length(posMeters);
+    glm::vec3 rHat = posMeters / r;
+    float ratio = Physics::EARTH_RADIUS / r;
+
+    return Physics::EARTH_DIPOLE_FIELD * ratio * ratio * ratio
+           * (3.0f * glm::dot(m, rHat) * rHat - m);
+}
@@ -0,0 +1,160 @@
+#include "event_detector.h"
+#include "constants.h"
+#include "environment.h"
+#include "root_finding.h"
+#include "simulation_state.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace
+{
+    double osculatingEccentricity(const OrbitSample& s)
+    {
+        const double mu { Orbit::EARTH_MU };
+        double r { glm::length(s.pos) };
+        double v2 { glm::dot(s.vel, s.vel) };
+        glm::dvec3 e = ((v2 - mu / r) * s.pos - glm::dot(s.pos, s.vel) * s.vel) / mu;
+        return glm::length(e);
+    }
+}
+
+OrbitSample interpolateOrbit(const OrbitSample& a, const OrbitSample& b, double time)
+{
+    double h { b.time - a.time };
+    if (h <= 0.0) { return b; }
+
+    double s { (time - a.time) / h };
+    double s2 { s * s };
+    double s3 { s2 * s };
+
+    double h00 { 2.0 * s3 - 3.0 * s2 + 1.0 };
+    double h10 { s3 - 2.0 * s2 + s };
+    double h01 { -2.0 * s3 + 3.0 * s2 };
+    double h11 { s3 - s2 };
+
+    double d00 { 6.0 * s2 - 6.0 * s };
+    double d10 { 3.0 * s2 - 4.0 * s + 1.0 };
+    double d01 { -6.0 * s2 + 6.0 * s };
+    double d11 { 3.0 * s2 - 2.0 * s };
+
+    OrbitSample out;
+    out.time = time;
+    out.pos = h00 * a.pos + h10 * h * a.vel + h01 * b.pos + h11 * h * b.vel;
+    out.vel = (d00 * a.pos + d01 * b.pos) / h + d10 * a.vel + d11 * b.vel;
+    return out;
+}
+
+const char* eventTypeName(EventType type)
+{
+    switch (type)
+    {
+        case EventType::ECLIPSE_ENTRY:   return "ECLIPSE_ENTRY";
+        case EventType::ECLIPSE_EXIT:    return "ECLIPSE_EXIT";
+        case EventType::PERIAPSIS:       return "PERIAPSIS";
+        case EventType::APOAPSIS:        return "APOAPSIS";
+        case EventType::ASCENDING_NODE:  return "ASCENDING_NODE";
+        case EventType::DESCENDING_NODE: return "DESCENDING_NODE";
+    }
+    return "UNKNOWN";
+}
+
+EventDetector::EventDetector(const EventDetectorConfig& config)
+    : m_config { config }
+{
+}
+
+void EventDetector::addSwitchingFunction(SwitchingFunction function)
+{
+    m_functions.push_back(std::move(function));
+    // Values of the new function are unknown at the previous step; restart the bracket
+    m_hasPrevious = false;
+}
+
+void EventDetector::addStandardEvents(const glm::vec3& sunDir)
+{
+    const glm::dvec3 sun { glm::normalize(glm::dvec3(sunDir)) };
+    const double earthRadius { Orbit::EARTH_RADIUS };
+
+    // Positive inside the shadow cylinder. On the day side it falls back to R - |r|,
+    // which matches the night side value at the terminator, so g stays continuous.
+    addSwitchingFunction({
+        [sun, earthRadius](const OrbitSample& s) {
+            double along { glm::dot(s.pos, sun) };
+            if (along >= 0.0) { return earthRadius - glm::length(s.pos); }
+            return earthRadius - glm::length(s.pos - along * sun);
+        },
+        EventType::ECLIPSE_ENTRY, EventType::ECLIPSE_EXIT, nullptr
+    });
+
+    // r.v turns positive after periapsis and negative after apoapsis
+    double minEcc { m_config.minApsisEccentricity };
+    addSwitchingFunction({
+        [](const OrbitSample& s) { return glm::dot(s.pos, s.vel); },
+        EventType::PERIAPSIS, EventType::APOAPSIS,
+        [minEcc](const OrbitSample& s) { return osculatingEccentricity(s) >= minEcc; }
+    });
+
+    const glm::dvec3 spin { glm::dvec3(earthSpinAxis()) };
+    addSwitchingFunction({
+        [spin](const OrbitSample& s) { return glm::dot(s.pos, spin); },
+        EventType::ASCENDING_NODE, EventType::DESCENDING_NODE, nullptr
+    });
+}
+
+void EventDetector::step(const SimulationState& state)
+{
+    OrbitSample current = orbitSampleFromState(state);
+
+    std::vector<double> values(m_functions.size());
+    for (std::size_t i = 0; i < m_functions.size(); ++i)
+        values[i] = m_functions[i].g(current);
+
+    if (m_hasPrevious)
+    {
+        std::size_t firstNew { m_log.size() };
+
+        for (std::size_t i = 0; i < m_functions.size(); ++i)
+        {
+            double g0 { m_previousValues[i] };
+            double g1 { values[i] };
+            // A zero at the start of the step was reported by the previous step
+            if (g0 == 0.0 || (g0 > 0.0) == (g1 > 0.0)) { continue; }
+
+            const SwitchingFunction& fn = m_functions[i];
+            auto gAt = [&](double t) { return fn.g(interpolateOrbit(m_previous, current, t)); };
+            double t { brentRoot(gAt, m_previous.time, current.time, g0, g1, m_config.timeTolerance) };
+
+            OrbitSample atRoot = interpolateOrbit(m_previous, current, t);
+            if (fn.accept && !fn.accept(atRoot)) { continue; }
+
+            m_log.push_back({ t, (g1 > 0.0) ? fn.rising : fn.falling, atRoot.pos });
+        }
+
+        // Several events in one step: keep the log ordered by time
+        std::sort(m_log.begin() + static_cast<std::ptrdiff_t>(firstNew), m_log.end(),
+                  [](const EventRecord& a, const EventRecord& b) { return a.time < b.time; });
+    }
+
+    m_previous = current;
+    m_previousValues = std::move(values);
+    m_hasPrevious = true;
+}
+
+const std::vector<EventRecord>& EventDetector::getLog() const { return m_log; }
+
+void EventDetector::clear()
+{
+    m_log.clear();
+}
+
+void EventDetector::writeCsv(std::ostream& out) const
+{
+    out << "time_s,event,x_m,y_m,z_m\n";
+    out << std::fixed << std::setprecision(3);
+    for (const EventRecord& e : m_log)
+    {
+        out << e.time << ',' << eventTypeName(e.type) << ','
+            << e.posMeters.x << ',' << e.posMeters.y << ',' << e.posMeters.z << '\n';
+    }
+}
@@ -2,21 +2,46 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include "attitude.h"
 #include "camera.h"
+#include "environment.h"
+#include "event_detector.h"
 #include "functions_main.h"
 #include "nadir_controller.h"
+#include "pil_bridge.h"
+#include "profiler.h"
 #include "simulation_state.h"
+#include "strip_charts.h"
+#include "telecommand.h"
+#include "telemetry_downlink.h"
+#include "telemetry_recorder.h"
+#include "telemetry_replay.h"
 
 float lastX { Window::SCR_WIDTH / 2.0 };
 float lastY { Window::SCR_HEIGHT / 2.0 };
 bool firstMouse { true };
 
 bool cKeyPressedLastFrame { false };
+bool replayKeysLastFrame[6] {};
+bool chartKeysLastFrame[3] {};
+
+namespace
+{
+    // True on the frame a key goes down
+    bool keyPressedOnce(GLFWwindow *window, int key, bool& pressedLastFrame)
+    {
+        bool pressed = glfwGetKey(window, key) == GLFW_PRESS;
+        bool once = pressed && !pressedLastFrame;
+        pressedLastFrame = pressed;
+        return once;
+    }
+}
 
 void initNadirPointing(SimulationState& state)
 {
@@ -38,6 +63,17 @@ void initNadirPointing(SimulationState& state)
     float orbitalRate = std::sqrt(mu / (r_unscaled * r_unscaled * r_unscaled));
 
     state.cubesatAngularVel = R_desired * glm::vec3(0.0f, orbitalRate, 0.0f);
+
+    state.adcs.setMode(AdcsMode::NADIR);
+}
+
+// Post-deployment case: arbitrary attitude and body rates, ADCS starts from detumble
+void initTumble(SimulationState& state, const glm::quat& attitude, const glm::vec3& bodyRates)
+{
+    state.cubesatOrientation = glm::normalize(attitude);
+    state.cubesatAngularVel = state.cubesatOrientation * bodyRates;
+
+    state.adcs.setMode(AdcsMode::DETUMBLE);
 }
 
 void renderSkybox(Shader& skyboxShader, const glm::mat4& view, const glm::mat4& projection, 
@@ -73,9 +109,9 @@ void renderSun(Shader& sunShader, const glm::mat4& view, const glm::mat4& projec
 }
 
 void renderEarth(Shader& earthShader, const glm::mat4& view, const glm::mat4& projection,
-                 const glm::vec3& lightPos, const glm::vec3& cameraPos, float simSpeed)
+                 const glm::vec3& lightPos, const glm::vec3& cameraPos, float simTime)
 {
-    float earthRotationDegPerSec = (360.0f / SECS_IN_DAY) * simSpeed;
+    float earthRotationDegPerSec = 360.0f / SECS_IN_DAY;
 
     earthShader.use();
     earthShader.setMat4("view", view);
@@ -85,12 +121,11 @@ void renderEarth(Shader& earthShader, const glm::mat4& view, const glm::mat4& pr
     glm::mat4 earthModel = glm::mat4(1.0f);
     earthModel = glm::scale(earthModel, glm::vec3(Physics::EARTH_RADIUS_SCALED));
 
-    glm::vec3 tiltAxis = glm::vec3(glm::sin(glm::radians(23.5f)),
-                                   glm::cos(glm::radians(23.5f)), 0.0f);
+    glm::vec3 tiltAxis = earthSpinAxis();
 
     earthModel = glm::rotate(
         earthModel,
-        glm::radians((float)glfwGetTime() * earthRotationDegPerSec),
+        glm::radians(std::fmod(simTime, SECS_IN_DAY) * earthRotationDegPerSec),
         tiltAxis
     );
 
@@ -123,6 +158,8 @@ void renderCubesat(Shader& cubesatShader, const glm::mat4& view, const glm::mat4
 // Verlet integration is used to compute position and velocity
 void propagateOrbit(SimulationState& state, float dt)
 {
+    PROFILE_ZONE("propagateOrbit");
+
     // Gravity points downward to Earth
     // Unscale pos value for physics calculations
     glm::vec3 r_vec = -(state.cubesatPos / SCALE_FACTOR);
@@ -151,12 +188,40 @@ void propagateOrbit(SimulationState& state, float dt)
 
 void updateAttitudeControl(SimulationState& state, float dt)
 {
-    glm::vec3 torqueCmd = computeNadirTorque(state);
-    state.wheels.applyTorqueCommands(torqueCmd, dt);
+    PROFILE_ZONE("updateAttitudeControl");
+
+    glm::vec3 posMeters = state.cubesatPos / SCALE_FACTOR;
+    state.estimator.step(state.sensors.getReadings(), sunDirection(state), magneticField(posMeters), dt);
+
+    const ActuatorCommand& command = state.pil ? state.pil->update(state, dt) : state.adcs.update(state, dt);
+    state.wheels.applyTorqueCommands(command.wheelTorque, dt);
     state.wheels.update(dt);
 
     glm::vec3 reactionTorque = state.wheels.computeReactionTorque(dt);
-    updateAttitude(state, reactionTorque, dt);
+    glm::vec3 magTorque = computeMagnetorquerTorque(state, command.dipole);
+    updateAttitude(state, reactionTorque + magTorque, dt);
+
+    state.sensors.sample(state, dt);
+}
+
+// Advances the physics by simDeltaTime in equal sub-steps (render loop and headless runs).
+// Returns the sub-steps taken, fewer than asked when a telecommand holds the simulation.
+int stepSimulation(SimulationState& state, float simDeltaTime, int subSteps)
+{
+    PROFILE_ZONE("stepSimulation");
+
+    float subDt = simDeltaTime / static_cast<float>(subSteps);
+    for (int i = 0; i < subSteps; ++i)
+    {
+        if (state.telecommands && !state.telecommands->beginStep(state, subDt)) { return i; }
+        propagateOrbit(state, subDt);
+        updateAttitudeControl(state, subDt);
+        state.simElapsedTime += subDt;
+        if (state.events) { state.events->step(state); }
+        if (state.recorder) { state.recorder->record(state); }
+        if (state.downlink) { state.downlink->update(state); }
+    }
+    return subSteps;
 }
 
 // Use non-scaled values in physics calculations
@@ -247,6 +312,35 @@ void processInput(GLFWwindow *window, [[maybe_unused]] SimulationState& state)
     cKeyPressedLastFrame = cKeyPressed;
 }
 
+void processReplayInput(GLFWwindow *window, ReplayClock& clock)
+{
+    // A seek covers ten seconds of playback at the current speed
+    const double seekStep = 10.0 * std::max(1.0, std::abs(clock.getSpeed()));
+
+    if (keyPressedOnce(window, GLFW_KEY_SPACE, replayKeysLastFrame[0]))
+        clock.togglePause();
+    if (keyPressedOnce(window, GLFW_KEY_UP, replayKeysLastFrame[1]))
+        clock.setSpeed(clock.getSpeed() * 2.0);
+    if (keyPressedOnce(window, GLFW_KEY_DOWN, replayKeysLastFrame[2]))
+        clock.setSpeed(clock.getSpeed() * 0.5);
+    if (keyPressedOnce(window, GLFW_KEY_R, replayKeysLastFrame[3]))
+        clock.setSpeed(-clock.getSpeed());
+    if (keyPressedOnce(window, GLFW_KEY_RIGHT, replayKeysLastFrame[4]))
+        clock.seek(clock.getTime() + seekStep);
+    if (keyPressedOnce(window, GLFW_KEY_LEFT, replayKeysLastFrame[5]))
+        clock.seek(clock.getTime() - seekStep);
+}
+
+void processChartInput(GLFWwindow *window, StripCharts& charts)
+{
+    if (keyPressedOnce(window, GLFW_KEY_P, chartKeysLastFrame[0]))
+        charts.toggleVisible();
+    if (keyPressedOnce(window, GLFW_KEY_LEFT_BRACKET, chartKeysLastFrame[1]))
+        charts.setSpan(charts.getSpan() * 0.5);
+    if (keyPressedOnce(window, GLFW_KEY_RIGHT_BRACKET, chartKeysLastFrame[2]))
+        charts.setSpan(charts.getSpan() * 2.0);
+}
+
 void framebuffer_size_callback(GLFWwindow *window, int width, int height)
 {
     glViewport(0, 0, width, height);
@@ -342,35 +436,3 @@ unsigned int loadCubemap(const std::array<std::string_view, 6>& faces)
 
     return textureID;
 }
-
-void ignoreLine()
-{
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-}
-
-float getSimSpeed()
-{
-    float simSpeed {};
-    do
-    {
-        if (std::cin.fail()) 
-        { 
-            std::cin.clear();
-            ignoreLine(); 
-        }
-
-        std::cout << "Choose SIM_SPEED:\n";
-        std::cout << "---------------------------------------------\n";
-        std::cout << "SIM_SPEED | 1 Earth Rotation | 1 Orbit Time\n";
-        std::cout << "---------------------------------------------\n";
-        std::cout << "1         | 24 hours         | 92 minutes\n";
-        std::cout << "60        | 24 minutes       | 1.53 minutes\n";
-        std::cout << "600       | 2.4 minutes      | 9.2 seconds\n";   
-        std::cout << "---------------------------------------------\n"; 
-
-        std::cout << "Enter desired SIM_SPEED: ";
-        std::cin >> simSpeed; 
-    } while (std::cin.fail());
-
-    return simSpeed;
-}
@@ -2,40 +2,936 @@
 #include <GLFW/glfw3.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <stb_image.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "attitude.h"
 #include "camera.h"
 #include "camera_controller.h"
+#include "checkpoint.h"
 #include "constants.h"
+#include "conjunction.h"
+#include "contact_windows.h"
+#include "coverage_map.h"
 #include "cube.h"
+#include "environment.h"
+#include "event_detector.h"
 #include "functions_main.h"
 #include "geometric_data.h"
+#include "monte_carlo.h"
 #include "nadir_controller.h"
+#include "orbit_decay.h"
+#include "orbit_determination.h"
+#include "orbit_stm.h"
+#include "parallel.h"
+#include "physics_thread.h"
+#include "pil_bridge.h"
+#include "profiler.h"
+#include "random_stream.h"
+#include "scenario.h"
+#include "series_downsampler.h"
 #include "shader_s.h"
 #include "simulation_state.h"
 #include "sphere.h"
+#include "strip_charts.h"
+#include "sweep.h"
+#include "telecommand.h"
+#include "telemetry_columns.h"
 #include "telemetry_display.h"
+#include "telemetry_downlink.h"
+#include "telemetry_recorder.h"
+#include "telemetry_replay.h"
 #include "text_renderer.h"
 
 Camera camera { glm::vec3(0.0f, 0.0f, 50.0f) };
 
+namespace
+{
+    // Keeps the noise of forked branches disjoint from the streams of the original run
+    constexpr std::uint64_t FORK_KEY { 0x94D049BB133111EBull };
+
+    // Numeric arguments must parse in full, so a typo is reported instead of read as 0.
+    // `out` is only written on success.
+    bool parseArgument(const char* text, double& out)
+    {
+        char* end { nullptr };
+        errno = 0;
+        double value { std::strtod(text, &end) };
+        if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(value)) { return false; }
+        out = value;
+        return true;
+    }
+
+    bool parseArgument(const char* text, int& out)
+    {
+        char* end { nullptr };
+        errno = 0;
+        long value { std::strtol(text, &end, 10) };
+        if (end == text || *end != '\0' || errno == ERANGE || value < INT_MIN || value > INT_MAX) { return false; }
+        out = static_cast<int>(value);
+        return true;
+    }
+
+    int usageError(const char* program, std::string_view usage, std::string_view problem)
+    {
+        std::cerr << "Usage: " << program << ' ' << usage << "\n  " << problem << '\n';
+        return -1;
+    }
+}
+
 int main(int argc, char *argv[])
 {
+    // Headless batch modes return before any window is created
+    if (argc > 1 && std::string_view(argv[1]) == "--monte-carlo")
+    {
+        DispersionConfig config;
+        if (argc > 2 && (!parseArgument(argv[2], config.runs) || config.runs < 1))
+            return usageError(argv[0], "--monte-carlo [runs]", "runs: number of dispersed cases, a positive integer");
+        printMonteCarloSummary(runMonteCarlo(config), std::cout);
+        return 0;
+    }
+
+    // --contacts <csv> [days] [satellites]: AOS/LOS windows for a constellation spread
+    // over planes and phases around the nominal orbit
+    if (argc > 2 && std::string_view(argv[1]) == "--contacts")
+    {
+        ContactConfig config;
+        double days { config.duration / SECS_IN_DAY };
+        int satellites { 1 };
+        if (argc > 3 && (!parseArgument(argv[3], days) || !(days > 0.0)))
+            return usageError(argv[0], "--contacts <csv> [days] [satellites]", "days: expected a positive number");
+        if (argc > 4 && (!parseArgument(argv[4], satellites) || satellites < 1))
+            return usageError(argv[0], "--contacts <csv> [days] [satellites]", "satellites: expected a positive integer");
+        config.duration = days * SECS_IN_DAY;
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        OrbitalElements nominal = stateToElements(orbitSampleFromState(state));
+
+        std::vector<OrbitSample> constellation = spreadConstellation(nominal, satellites, config.startTime);
+
+        std::vector<GroundStation> stations = defaultGroundStations();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<ContactWindow> windows = computeContactWindows(constellation, stations, config);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream out(argv[2]);
+        if (!out)
+        {
+            std::cerr << "Cannot open " << argv[2] << '\n';
+            return -1;
+        }
+        writeContactCsv(out, windows, stations);
+        std::cout << windows.size() << " contact windows (" << satellites << " satellites, "
+                  << stations.size() << " stations) in " << wall << " s, written to " << argv[2] << '\n';
+        return 0;
+    }
+
+    // --coverage <prefix> [days] [satellites]: ground track and coverage raster for the
+    // same constellation layout as --contacts, written as <prefix>.png and <prefix>.bin
+    if (argc > 2 && std::string_view(argv[1]) == "--coverage")
+    {
+        CoverageConfig config;
+        double days { config.duration / SECS_IN_DAY };
+        int satellites { 1 };
+        if (argc > 3 && (!parseArgument(argv[3], days) || !(days > 0.0)))
+            return usageError(argv[0], "--coverage <prefix> [days] [satellites]", "days: expected a positive number");
+        if (argc > 4 && (!parseArgument(argv[4], satellites) || satellites < 1))
+            return usageError(argv[0], "--coverage <prefix> [days] [satellites]", "satellites: expected a positive integer");
+        config.duration = days * SECS_IN_DAY;
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        OrbitalElements nominal = stateToElements(orbitSampleFromState(state));
+        std::vector<OrbitSample> constellation = spreadConstellation(nominal, satellites, config.startTime);
+
+        auto start = std::chrono::steady_clock::now();
+        CoverageMap map = computeCoverageMap(constellation, config);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::string prefix(argv[2]);
+        if (!writeCoveragePng(prefix + ".png", map) || !writeCoverageRaster(prefix + ".bin", map))
+        {
+            std::cerr << "Cannot open " << prefix << ".png/.bin\n";
+            return -1;
+        }
+        std::cout << "Coverage " << 100.0 * map.globalCoverage() << "% of the surface, mean revisit "
+                  << map.meanRevisitInterval() / 60.0 << " min (" << satellites << " satellites, " << map.steps
+                  << " steps) in " << wall << " s, written to " << prefix << ".png/.bin\n";
+        return 0;
+    }
+
+    // --decay <csv> [satellites] [years]: orbit lifetimes for the nominal CubeSat and a
+    // random population of low orbits and ballistic coefficients around it
+    if (argc > 2 && std::string_view(argv[1]) == "--decay")
+    {
+        int count { 1000 };
+        DecayConfig config;
+        double years { config.maxDuration / (365.25 * SECS_IN_DAY) };
+        if (argc > 3 && (!parseArgument(argv[3], count) || count < 1))
+            return usageError(argv[0], "--decay <csv> [satellites] [years]", "satellites: expected a positive integer");
+        if (argc > 4 && (!parseArgument(argv[4], years) || !(years > 0.0)))
+            return usageError(argv[0], "--decay <csv> [satellites] [years]", "years: expected a positive number");
+        config.maxDuration = years * 365.25 * SECS_IN_DAY;
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        DecaySatellite nominal;
+        nominal.elements = stateToElements(orbitSampleFromState(state));
+
+        RandomStream rng(1, 0);
+        std::vector<DecaySatellite> satellites { nominal };
+        for (int i = 1; i < count; ++i)
+        {
+            DecaySatellite sat = nominal;
+            sat.elements.eccentricity = 0.005 * rng.uniform();
+            sat.elements.semiMajorAxis = (Orbit::EARTH_RADIUS + 2.5e5 + 3.0e5 * rng.uniform()) / (1.0 - sat.elements.eccentricity);
+            sat.elements.inclination = std::acos(1.0 - 2.0 * rng.uniform());
+            sat.elements.raan = glm::two_pi<double>() * rng.uniform();
+            sat.elements.argPeriapsis = glm::two_pi<double>() * rng.uniform();
+            sat.elements.trueAnomaly = glm::two_pi<double>() * rng.uniform();
+            sat.ballisticCoefficient *= 0.5 + 1.5 * rng.uniform();
+            satellites.push_back(sat);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<DecayResult> results = estimateOrbitLifetimes(satellites, config);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream out(argv[2]);
+        if (!out)
+        {
+            std::cerr << "Cannot open " << argv[2] << '\n';
+            return -1;
+        }
+        writeDecayCsv(out, satellites, results);
+        std::size_t reentered = std::count_if(results.begin(), results.end(), [](const DecayResult& r) { return r.reentered; });
+        std::cout << "Nominal orbit lifetime " << results[0].lifetime / SECS_IN_DAY << " days; " << reentered << " of "
+                  << count << " satellites reentered within " << config.maxDuration / (365.25 * SECS_IN_DAY)
+                  << " years, in " << wall << " s, written to " << argv[2] << '\n';
+        return 0;
+    }
+
+    // --conjunctions <csv> [objects] [hours]: screen a random LEO population
+    if (argc > 2 && std::string_view(argv[1]) == "--conjunctions")
+    {
+        int count { 10000 };
+        ConjunctionConfig config;
+        double hours { config.duration / 3600.0 };
+        if (argc > 3 && (!parseArgument(argv[3], count) || count < 2))
+            return usageError(argv[0], "--conjunctions <csv> [objects] [hours]", "objects: expected an integer of at least 2");
+        if (argc > 4 && (!parseArgument(argv[4], hours) || !(hours > 0.0)))
+            return usageError(argv[0], "--conjunctions <csv> [objects] [hours]", "hours: expected a positive number");
+        config.duration = hours * 3600.0;
+
+        RandomStream rng(1, 0);
+        std::vector<OrbitSample> objects;
+        for (int i = 0; i < count; ++i)
+        {
+            OrbitalElements el;
+            el.eccentricity = 0.01 * rng.uniform();
+            el.semiMajorAxis = (Orbit::EARTH_RADIUS + 3.0e5 + 9.0e5 * rng.uniform()) / (1.0 - el.eccentricity);
+            el.inclination = std::acos(1.0 - 2.0 * rng.uniform());
+            el.raan = glm::two_pi<double>() * rng.uniform();
+            el.argPeriapsis = glm::two_pi<double>() * rng.uniform();
+            el.trueAnomaly = glm::two_pi<double>() * rng.uniform();
+            objects.push_back(elementsToState(el, config.startTime));
+        }
+
+        ConjunctionStats stats;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Conjunction> conjunctions = screenConjunctions(objects, config, &stats);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream out(argv[2]);
+        if (!out)
+        {
+            std::cerr << "Cannot open " << argv[2] << '\n';
+            return -1;
+        }
+        writeConjunctionCsv(out, conjunctions);
+        std::cout << conjunctions.size() << " conjunctions among " << count << " objects in " << wall
+                  << " s (broad phase pairs " << stats.broadPhasePairs << ", shell " << stats.shellPairs
+                  << ", narrow " << stats.narrowPhasePairs << ", objects changing cells per step "
+                  << 100.0 * static_cast<double>(stats.cellChanges) / static_cast<double>(std::max<std::size_t>(stats.cellChecks, 1))
+                  << "%), written to " << argv[2] << '\n';
+        return 0;
+    }
+
+    // --covariance <csv> <t1,t2,...> [stmInterval]: propagate an initial covariance of
+    // 10 m / 0.1 m/s per axis from the nominal orbit to the listed epochs (s)
+    if (argc > 3 && std::string_view(argv[1]) == "--covariance")
+    {
+        constexpr std::string_view usage { "--covariance <csv> <t1,t2,...> [stmInterval]" };
+        std::vector<double> epochs;
+        std::stringstream list(argv[3]);
+        for (std::string item; std::getline(list, item, ',');)
+        {
+            double t { 0.0 };
+            if (!parseArgument(item.c_str(), t) || !(t > 0.0))
+                return usageError(argv[0], usage, "epochs: expected positive times in s, separated by commas");
+            epochs.push_back(t);
+        }
+        std::sort(epochs.begin(), epochs.end());
+        int stmInterval { 1 };
+        if (argc > 4 && (!parseArgument(argv[4], stmInterval) || stmInterval < 1))
+            return usageError(argv[0], usage, "stmInterval: expected a positive integer");
+        constexpr double dt { 1.0 };
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        OrbitSample epoch = orbitSampleFromState(state);
+
+        StateMatrix p0;
+        for (int i = 0; i < 3; ++i)
+        {
+            p0(i, i) = 10.0 * 10.0;
+            p0(i + 3, i + 3) = 0.1 * 0.1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<CovarianceSample> samples = propagateCovariance(epoch, p0, epochs, dt, stmInterval);
+        double withStm = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Same steps without the STM, for the cost comparison
+        start = std::chrono::steady_clock::now();
+        OrbitSample plain = epoch;
+        while (!epochs.empty() && plain.time < epochs.back())
+            propagateOrbitMeters(plain, dt);
+        double withoutStm = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream out(argv[2]);
+        if (!out)
+        {
+            std::cerr << "Cannot open " << argv[2] << '\n';
+            return -1;
+        }
+        writeCovarianceCsv(out, samples);
+        std::cout << samples.size() << " covariance epochs written to " << argv[2] << "; STM every "
+                  << stmInterval << " steps costs " << withStm / std::max(withoutStm, 1e-9)
+                  << "x plain propagation\n";
+        return 0;
+    }
+
+    // --orbit-determination [hours]: track the nominal orbit from the default stations and
+    // recover its initial state from a guess 1 km / 1 m/s off
+    if (argc > 1 && std::string_view(argv[1]) == "--orbit-determination")
+    {
+        TrackingConfig tracking;
+        double hours { tracking.duration / 3600.0 };
+        if (argc > 2 && (!parseArgument(argv[2], hours) || !(hours > 0.0)))
+            return usageError(argv[0], "--orbit-determination [hours]", "hours: expected a positive number");
+        tracking.duration = hours * 3600.0;
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        OrbitSample truth = orbitSampleFromState(state);
+
+        std::vector<GroundStation> stations = defaultGroundStations();
+        std::vector<TrackingObservation> observations = simulateTracking(state, stations, tracking);
+
+        OrbitSample guess = truth;
+        guess.pos += glm::dvec3(1000.0, -600.0, 800.0);
+        guess.vel += glm::dvec3(-0.6, 0.8, 0.5);
+
+        OdConfig od;
+        od.sigmas = tracking.sigmas;
+        auto start = std::chrono::steady_clock::now();
+        OdSolution solution = estimateInitialState(guess, observations, stations, od);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << observations.size() << " tracking samples, solved in " << wall << " s\n";
+        printOdSolution(solution, &truth, std::cout);
+        return 0;
+    }
+
+    // --events <csv> [orbits]: propagate the nominal scenario and log orbital events
+    if (argc > 2 && std::string_view(argv[1]) == "--events")
+    {
+        double orbits { 3.0 };
+        if (argc > 3 && (!parseArgument(argv[3], orbits) || !(orbits > 0.0)))
+            return usageError(argv[0], "--events <csv> [orbits]", "orbits: expected a positive number");
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        initNadirPointing(state);
+
+        EventDetector events;
+        events.addStandardEvents(sunDirection(state));
+        state.events = &events;
+
+        float radius = Physics::EARTH_RADIUS + Physics::ORBIT_ALTITUDE;
+        float period = glm::two_pi<float>() * radius / glm::length(state.cubesatVel);
+        constexpr float dt { 1.0f };
+        int steps = static_cast<int>(orbits * period / dt);
+        for (int i = 0; i < steps; ++i)
+            stepSimulation(state, dt, 1);
+
+        std::ofstream out(argv[2]);
+        if (!out)
+        {
+            std::cerr << "Cannot open " << argv[2] << '\n';
+            return -1;
+        }
+        events.writeCsv(out);
+        std::cout << events.getLog().size() << " events written to " << argv[2] << '\n';
+        return 0;
+    }
+
+    // --checkpoint <file> <seconds> [interval]: run the first dispersed Monte Carlo case
+    // headless, snapshotting every `interval` s of simulated time. An existing snapshot
+    // is resumed, so a preempted job is simply restarted with the same arguments.
+    if (argc > 3 && std::string_view(argv[1]) == "--checkpoint")
+    {
+        DispersionConfig dispersion;
+        constexpr std::string_view usage { "--checkpoint <file> <seconds> [interval]" };
+        double duration { 0.0 };
+        double interval { 600.0 };
+        if (!parseArgument(argv[3], duration) || !(duration >= 0.0))
+            return usageError(argv[0], usage, "seconds: expected a non-negative end time");
+        if (argc > 4 && (!parseArgument(argv[4], interval) || !(interval > 0.0)))
+            return usageError(argv[0], usage, "interval: expected a positive number of seconds");
+
+        SimulationState state;
+        bool resumed = loadCheckpoint(argv[2], state);
+        if (!resumed) { sampleDispersedState(dispersion, 0, state); }
+
+        // Whole steps to the end time, so the run stops however the clock rounds
+        const long long steps { std::max(0LL, std::llround((duration - state.simElapsedTime) / dispersion.dt)) };
+        const long long stepsPerSave { std::max(1LL, std::llround(interval / dispersion.dt)) };
+        for (long long k = 1; k <= steps; ++k)
+        {
+            stepSimulation(state, dispersion.dt, 1);
+            if (k % stepsPerSave == 0 || k == steps)
+            {
+                if (!saveCheckpoint(argv[2], state))
+                {
+                    std::cerr << "Cannot open " << argv[2] << '\n';
+                    return -1;
+                }
+            }
+        }
+        std::cout << (resumed ? "Resumed" : "Started") << " run reached t = " << state.simElapsedTime << " s in "
+                  << adcsModeName(state.adcs.getMode()) << ", nadir error "
+                  << glm::degrees(nadirPointingError(state)) << " deg, snapshot in " << argv[2] << '\n';
+        return 0;
+    }
+
+    // --fork <file> <branches> <seconds>: continue a snapshot in parallel branches that
+    // differ only in their future sensor noise; branch 0 is the undisturbed continuation
+    if (argc > 4 && std::string_view(argv[1]) == "--fork")
+    {
+        constexpr std::string_view usage { "--fork <file> <branches> <seconds>" };
+        int branches { 0 };
+        double duration { 0.0 };
+        if (!parseArgument(argv[3], branches) || branches < 1)
+            return usageError(argv[0], usage, "branches: expected a positive integer");
+        if (!parseArgument(argv[4], duration) || !(duration >= 0.0))
+            return usageError(argv[0], usage, "seconds: expected a non-negative number");
+
+        SimulationState prefix;
+        if (!loadCheckpoint(argv[2], prefix))
+        {
+            std::cerr << "Cannot load checkpoint " << argv[2] << '\n';
+            return -1;
+        }
+        DispersionConfig dispersion;
+
+        std::vector<float> finalError(static_cast<std::size_t>(branches));
+        parallelFor(finalError.size(), 0, [&](std::size_t b, unsigned int) {
+            SimulationState state = prefix;
+            if (b > 0) { state.sensors.reseed(dispersion.seed ^ FORK_KEY, static_cast<std::uint32_t>(b)); }
+
+            const long long steps { std::llround(duration / dispersion.dt) };
+            for (long long i = 0; i < steps; ++i)
+                stepSimulation(state, dispersion.dt, 1);
+            finalError[b] = glm::degrees(nadirPointingError(state));
+        });
+
+        StreamingStats errors(1.0e-4, 180.0);
+        for (float e : finalError)
+            errors.add(e);
+        std::cout << branches << " branches from t = " << prefix.simElapsedTime << " s, +" << duration
+                  << " s: final nadir error mean " << errors.mean() << " deg, p95 " << errors.percentile(95.0)
+                  << " deg, max " << errors.max() << " deg\n";
+        return 0;
+    }
+
+    // --sweep <file> [i/N]: run shard i of N of a parameter sweep; every job writes its
+    // own result file. --sweep-merge <file> then collects them into summary.csv.
+    if (argc > 2 && (std::string_view(argv[1]) == "--sweep" || std::string_view(argv[1]) == "--sweep-merge"))
+    {
+        SweepSpec spec;
+        std::string error;
+        if (!loadSweep(argv[2], spec, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+
+        if (std::string_view(argv[1]) == "--sweep-merge")
+        {
+            std::size_t merged { 0 }, missing { 0 };
+            if (!mergeSweep(spec, merged, missing, error))
+            {
+                std::cerr << error << '\n';
+                return -1;
+            }
+            std::cout << merged << " of " << sweepJobCount(spec) << " jobs merged into " << spec.outputDir
+                      << "/summary.csv" << (missing > 0 ? ", " + std::to_string(missing) + " missing" : "") << '\n';
+            return missing > 0 ? 1 : 0;
+        }
+
+        SweepShard shard;
+        if (argc > 3 && !parseSweepShard(argv[3], shard))
+        {
+            std::cerr << "Shard must be i/N with 0 <= i < N, got " << argv[3] << '\n';
+            return -1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        SweepReport report = runSweep(spec, shard);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Shard " << shard.index << "/" << shard.count << " of " << sweepJobCount(spec) << " jobs: "
+                  << report.run << " run, " << report.skipped << " already done, " << report.failed << " failed in "
+                  << wall << " s\n";
+        return report.failed > 0 ? 1 : 0;
+    }
+
+    // --telemetry-index <recording> <out.tlc>: rewrite a raw recording in the columnar format
+    if (argc > 3 && std::string_view(argv[1]) == "--telemetry-index")
+    {
+        std::string error;
+        if (!convertTelemetryToColumns(argv[2], argv[3], COLUMNAR_DEFAULT_CHUNK, ColumnarCodec {}, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        TelemetryColumnReader reader;
+        if (!reader.open(argv[3], error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        std::cout << reader.frameCount() << " frames in " << reader.chunkCount() << " chunks, t = "
+                  << reader.startTime() << " to " << reader.endTime() << " s, written to " << argv[3] << '\n';
+        return 0;
+    }
+
+    // --telemetry-bench <recording> [6 quanta]: compression ratio and encode/decode
+    // throughput of the column codecs on a raw recording. Quanta are rounding steps for
+    // position, velocity, attitude, rates, wheel speeds and torque.
+    if (argc > 2 && std::string_view(argv[1]) == "--telemetry-bench")
+    {
+        constexpr std::string_view usage { "--telemetry-bench <recording> [position velocity attitude rates wheels torque]" };
+        std::array<float, 6> groups {};
+        if (argc > 3 && argc != 9)
+            return usageError(argv[0], usage, "quanta: expected all 6 or none");
+        for (std::size_t i = 0; argc == 9 && i < groups.size(); ++i)
+        {
+            double quantum { 0.0 };
+            if (!parseArgument(argv[3 + i], quantum) || !(quantum >= 0.0))
+                return usageError(argv[0], usage, "quanta: expected non-negative numbers, 0 for lossless");
+            groups[i] = static_cast<float>(quantum);
+        }
+
+        std::vector<TelemetryFrame> frames;
+        std::string error;
+        if (!readTelemetryFrames(argv[2], frames, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+
+        auto report = [&frames](const char* label, const ColumnarCodec& codec) {
+            CodecBenchmark b = benchmarkTelemetryCodec(frames, codec);
+            double mb { static_cast<double>(b.rawBytes) / 1.0e6 };
+            std::cout << std::setprecision(4) << label << ": " << b.rawBytes << " -> " << b.encodedBytes
+                      << " bytes, ratio " << static_cast<double>(b.rawBytes) / std::max<std::uint64_t>(1, b.encodedBytes)
+                      << ", encode " << mb / b.encodeSeconds << " MB/s, decode " << mb / b.decodeSeconds
+                      << " MB/s, round trip " << (b.roundTrip ? "ok" : "FAILED") << '\n';
+            for (int c = 0; c < TELEMETRY_CHANNELS; ++c)
+            {
+                if (codec.quantum[static_cast<std::size_t>(c)] > 0.0f)
+                {
+                    std::cout << "  " << telemetryChannelName(static_cast<TelemetryChannel>(c)) << " max error "
+                              << b.maxError[static_cast<std::size_t>(c)] << '\n';
+                }
+            }
+            return b.roundTrip;
+        };
+
+        std::cout << frames.size() << " frames from " << argv[2] << '\n';
+        bool ok { report("lossless", ColumnarCodec {}) };
+        if (argc == 9)
+        {
+            ColumnarCodec quantized;
+            setQuantumGroups(quantized, groups);
+            ok = report("quantized", quantized) && ok;
+        }
+        return ok ? 0 : 1;
+    }
+
+    // --telemetry-query <file.tlc> <channel> [t0] [t1]: statistics of one channel over a
+    // time range, read through the chunk index without loading the file
+    if (argc > 3 && std::string_view(argv[1]) == "--telemetry-query")
+    {
+        TelemetryColumnReader reader;
+        std::string error;
+        if (!reader.open(argv[2], error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        TelemetryChannel channel;
+        if (!telemetryChannelFromName(argv[3], channel))
+        {
+            std::cerr << "Unknown channel " << argv[3] << '\n';
+            return -1;
+        }
+        double t0 { reader.startTime() };
+        double t1 { reader.endTime() };
+        if ((argc > 4 && !parseArgument(argv[4], t0)) || (argc > 5 && !parseArgument(argv[5], t1)))
+            return usageError(argv[0], "--telemetry-query <file.tlc> <channel> [t0] [t1]", "t0, t1: expected times in s");
+
+        auto start = std::chrono::steady_clock::now();
+        ChannelSummary summary = reader.summarize(channel, t0, t1);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << telemetryChannelName(channel) << " over t = " << t0 << " to " << t1 << " s: " << summary.count
+                  << " frames, min " << summary.min << ", max " << summary.max << ", mean " << summary.mean << " ("
+                  << summary.chunksScanned << " chunks scanned, " << wall * 1e3 << " ms)\n";
+        return 0;
+    }
+
+    // --telemetry-plot <recording> <channel> <points> [t0] [t1]: one channel reduced to at
+    // most `points` points through the plot downsampler, as time_s,value CSV
+    if (argc > 4 && std::string_view(argv[1]) == "--telemetry-plot")
+    {
+        constexpr std::string_view usage { "--telemetry-plot <recording> <channel> <points> [t0] [t1]" };
+        int maxPoints { 0 };
+        if (!parseArgument(argv[4], maxPoints) || maxPoints < 2)
+            return usageError(argv[0], usage, "points: expected an integer of at least 2");
+
+        TelemetryReplay recording;
+        std::string error;
+        if (!recording.open(argv[2], error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        TelemetryChannel channel;
+        if (!telemetryChannelFromName(argv[3], channel))
+        {
+            std::cerr << "Unknown channel " << argv[3] << '\n';
+            return -1;
+        }
+
+        SeriesDownsampler series;
+        for (std::uint64_t i = 0; i < recording.frameCount(); ++i)
+        {
+            TelemetryFrame frame = recording.frame(i);
+            series.append(frame.time, channelValue(frame, channel));
+        }
+
+        double t0 { recording.startTime() };
+        double t1 { recording.endTime() };
+        if ((argc > 5 && !parseArgument(argv[5], t0)) || (argc > 6 && !parseArgument(argv[6], t1)))
+            return usageError(argv[0], usage, "t0, t1: expected times in s");
+        std::vector<PlotPoint> points;
+        series.query(t0, t1, static_cast<std::size_t>(maxPoints), points);
+
+        std::cout << std::setprecision(9) << "time_s," << telemetryChannelName(channel) << '\n';
+        for (const PlotPoint& p : points)
+            std::cout << t0 + p.time << ',' << p.value << '\n';
+        return 0;
+    }
+
+    // --downlink-load <host:port> <satellites> <seconds> [rate]: load-test a ground
+    // segment with housekeeping packets from a whole constellation; rate is per
+    // satellite in Hz, 0 for as fast as possible. --downlink-listen <port> <seconds>
+    // is a local stand-in that validates and counts what arrives.
+    if (argc > 4 && std::string_view(argv[1]) == "--downlink-load")
+    {
+        constexpr std::string_view usage { "--downlink-load <host:port> <satellites> <seconds> [rate]" };
+        std::string target { argv[2] };
+        std::size_t colon { target.rfind(':') };
+        DownlinkConfig config;
+        config.host = target.substr(0, colon);
+        if (colon == std::string::npos || config.host.empty() || !parseArgument(target.c_str() + colon + 1, config.port)
+            || config.port < 1 || config.port > 65535)
+            return usageError(argv[0], usage, "host:port: expected a host and a UDP port from 1 to 65535");
+        int satellites { 0 };
+        double seconds { 0.0 };
+        double rate { 1.0 };
+        if (!parseArgument(argv[3], satellites) || satellites < 1)
+            return usageError(argv[0], usage, "satellites: expected a positive integer");
+        if (!parseArgument(argv[4], seconds) || !(seconds > 0.0))
+            return usageError(argv[0], usage, "seconds: expected a positive duration");
+        if (argc > 5 && (!parseArgument(argv[5], rate) || !(rate >= 0.0)))
+            return usageError(argv[0], usage, "rate: expected a non-negative rate in Hz, 0 for as fast as possible");
+
+        SimulationState state;
+        state.cubesatVel = calculateCubesatVel();
+        OrbitalElements nominal = stateToElements(orbitSampleFromState(state));
+        std::vector<OrbitSample> constellation = spreadConstellation(nominal, satellites, state.simElapsedTime);
+
+        DownlinkLoadReport report = runDownlinkLoadTest(config, constellation, 256, rate, seconds);
+        if (report.seconds == 0.0)
+        {
+            std::cerr << "Cannot open downlink to " << target << '\n';
+            return -1;
+        }
+        std::cout << std::setprecision(4) << report.packets << " packets (" << report.bytes / 1.0e6 << " MB) in "
+                  << report.seconds << " s: " << report.packets / report.seconds << " packets/s in "
+                  << report.syscalls << " sends, " << report.dropped << " dropped, max lag "
+                  << report.lateSeconds * 1e3 << " ms\n";
+        return 0;
+    }
+
+    if (argc > 3 && std::string_view(argv[1]) == "--downlink-listen")
+    {
+        constexpr std::string_view usage { "--downlink-listen <port> <seconds>" };
+        int port { 0 };
+        double seconds { 0.0 };
+        if (!parseArgument(argv[2], port) || port < 1 || port > 65535)
+            return usageError(argv[0], usage, "port: expected a UDP port from 1 to 65535");
+        if (!parseArgument(argv[3], seconds) || !(seconds > 0.0))
+            return usageError(argv[0], usage, "seconds: expected a positive duration");
+
+        DownlinkListenReport report;
+        std::string error;
+        if (!listenDownlink(port, seconds, report, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        std::cout << report.packets << " packets (" << report.bytes << " bytes) on " << report.perApid.size()
+                  << " APIDs, " << report.sequenceGaps << " missing by sequence count, " << report.malformed
+                  << " malformed\n";
+        return 0;
+    }
+
+    // --telecommand <socket> <command> [args...] [at <s>]: send one ground command to a
+    // running simulation and print its acknowledgement
+    if (argc > 3 && std::string_view(argv[1]) == "--telecommand")
+    {
+        TelecommandPacket packet;
+        std::string error;
+        if (!parseTelecommand(std::vector<std::string>(argv + 3, argv + argc), packet, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        packet.sequence = 1;
+
+        TelecommandStatus status;
+        if (!sendTelecommand(argv[2], packet, status, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        std::cout << telecommandStatusName(status) << '\n';
+        return (status == TelecommandStatus::ACCEPTED) ? 0 : -1;
+    }
+
+    // --scenario <file>: orbit, spacecraft, controller, speed and outputs from a file
+    Scenario scenario;
+    if (argc > 2 && std::string_view(argv[1]) == "--scenario")
+    {
+        std::string error;
+        if (!loadScenario(argv[2], scenario, error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+    }
+
     SimulationState state; 
-    state.cubesatVel = calculateCubesatVel();
-    initNadirPointing(state);
+    applyScenario(scenario, state);
+
+    // --resume <file>: open the interactive view on a saved snapshot
+    if (argc > 2 && std::string_view(argv[1]) == "--resume" && !loadCheckpoint(argv[2], state))
+    {
+        std::cerr << "Cannot load checkpoint " << argv[2] << '\n';
+        return -1;
+    }
+
+    EventDetector events;
+    if (!scenario.eventsCsv.empty())
+    {
+        events.addStandardEvents(sunDirection(state));
+        state.events = &events;
+    }
+
+    TelemetryRecorder recorder;
+    if (!scenario.telemetryPath.empty())
+    {
+        if (!recorder.open(scenario.telemetryPath, scenario.telemetryCodec))
+        {
+            std::cerr << "Cannot open " << scenario.telemetryPath << '\n';
+            return -1;
+        }
+        state.recorder = &recorder;
+    }
+
+    TelemetryDownlink downlink(scenario.downlink);
+    if (scenario.downlink.port > 0)
+    {
+        std::string error;
+        if (!downlink.open(error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        state.downlink = &downlink;
+    }
+
+    TelecommandQueue telecommands(scenario.simSpeed);
+    TelecommandServer telecommandServer(scenario.telecommandSocket, telecommands);
+    if (!scenario.telecommandSocket.empty())
+    {
+        std::string error;
+        if (!telecommandServer.open(error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        state.telecommands = &telecommands;
+    }
+
+    if (!scenario.tracePath.empty())
+    {
+        if (!PROFILING_COMPILED_IN)
+            std::cerr << "Built without CUBESAT_PROFILING, " << scenario.tracePath << " will hold no zones\n";
+        setProfileThreadName("main");
+        startProfiling();
+    }
+
+    double nextCheckpoint = state.simElapsedTime + scenario.checkpointInterval;
+    auto saveScenarioOutputs = [&](bool final) {
+        if (!scenario.checkpointPath.empty() && (final || state.simElapsedTime >= nextCheckpoint))
+        {
+            if (!saveCheckpoint(scenario.checkpointPath, state))
+                std::cerr << "Cannot open " << scenario.checkpointPath << '\n';
+            nextCheckpoint = state.simElapsedTime + scenario.checkpointInterval;
+        }
+        if (final && state.events)
+        {
+            std::ofstream out(scenario.eventsCsv);
+            if (!out) { std::cerr << "Cannot open " << scenario.eventsCsv << '\n'; }
+            else { events.writeCsv(out); }
+        }
+        if (final && state.recorder)
+        {
+            if (!recorder.stop()) { std::cerr << recorder.getError() << '\n'; }
+            std::cout << "Telemetry: " << recorder.getWritten() << " frames written to " << scenario.telemetryPath
+                      << ", " << recorder.getDropped() << " dropped\n";
+        }
+        if (final && state.downlink)
+        {
+            const UdpSender& sender = downlink.getSender();
+            std::cout << "Downlink: " << sender.getPackets() << " packets in " << sender.getSyscalls()
+                      << " sends to " << scenario.downlink.host << ':' << scenario.downlink.port << ", "
+                      << sender.getDropped() << " dropped\n";
+        }
+        if (final && state.telecommands)
+        {
+            telecommandServer.close();
+            std::cout << "Telecommands: " << telecommandServer.getReceived() << " received, "
+                      << telecommandServer.getRejected() << " rejected, " << telecommands.getApplied()
+                      << " applied\n";
+        }
+        if (final && !scenario.tracePath.empty())
+        {
+            if (!writeChromeTrace(scenario.tracePath))
+                std::cerr << "Cannot open " << scenario.tracePath << '\n';
+            else
+                std::cout << "Trace: " << getProfileZoneCount() << " zones written to " << scenario.tracePath
+                          << ", " << getProfileZonesDropped() << " dropped\n";
+        }
+    };
+
+    if (scenario.headless)
+    {
+        // Whole steps, so the end does not depend on how the clock rounds
+        const long long steps { std::llround(scenario.duration / scenario.headlessStep) };
+        for (long long k = 0; k < steps;)
+        {
+            if (stepSimulation(state, scenario.headlessStep, 1) == 1) { ++k; }
+            else { std::this_thread::sleep_for(std::chrono::milliseconds(1)); } // Paused from the ground
+            saveScenarioOutputs(false);
+        }
+        saveScenarioOutputs(true);
+        std::cout << "Scenario reached t = " << state.simElapsedTime << " s in " << adcsModeName(state.adcs.getMode())
+                  << ", nadir error " << glm::degrees(nadirPointingError(state)) << " deg\n";
+        return 0;
+    }
+
+    // --pil <socket> [lockstep|free]: flight software in a separate process closes the loop
+    std::unique_ptr<PilBridge> pil;
+    if (argc > 2 && std::string_view(argv[1]) == "--pil")
+    {
+        PilSyncMode mode { PilSyncMode::LOCKSTEP };
+        if (argc > 3 && std::string_view(argv[3]) == "free") { mode = PilSyncMode::FREE_RUNNING; }
+        else if (argc > 3 && std::string_view(argv[3]) != "lockstep")
+        {
+            std::cerr << "Usage: " << argv[0] << " --pil <socket> [lockstep|free]\n"
+                      << "  unknown sync mode \"" << argv[3] << "\"\n";
+            return -1;
+        }
+        pil = std::make_unique<PilBridge>(argv[2], mode, state.adcs.getConfig().controlRate);
+        if (!pil->open()) { return -1; }
+        state.pil = pil.get();
+    }
+
+    // --replay <recording> [speed]: play a recorded run back through the renderer instead
+    // of simulating. Space pauses, up/down doubles/halves the speed, R reverses and
+    // left/right seek.
+    TelemetryReplay replay;
+    std::unique_ptr<ReplayClock> replayClock;
+    if (argc > 2 && std::string_view(argv[1]) == "--replay")
+    {
+        double speed { static_cast<double>(scenario.simSpeed) };
+        if (argc > 3 && (!parseArgument(argv[3], speed) || !(speed > 0.0)))
+            return usageError(argv[0], "--replay <recording> [speed]", "speed: expected a positive playback multiplier");
+
+        std::string error;
+        if (!replay.open(argv[2], error))
+        {
+            std::cerr << error << '\n';
+            return -1;
+        }
+        replayClock = std::make_unique<ReplayClock>(replay.startTime(), replay.endTime(), speed);
+        applyTelemetryFrame(replay.sample(replayClock->getTime()), state);
+        state.cameraMode = CameraMode::FOLLOW;
+    }
+
+    // From here the renderer draws its own copy of the state, fed a frame at a time by
+    // the replay or by the physics thread, which owns `state` until it is stopped
+    SimulationState rendered = state;
+    PhysicsThread physics(state, scenario.simSpeed, scenario.subSteps, [&saveScenarioOutputs] {
+        saveScenarioOutputs(false);
+    });
 
     declareHints();
-    GLFWwindow *window = initWindow(state);
+    GLFWwindow *window = initWindow(rendered);
     if (window == nullptr) { return -1; }
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -51,6 +947,7 @@ int main(int argc, char *argv[])
     Shader earthShader { "shaders/earth.vs", "shaders/earth.fs" };
     Shader cubesatShader { "shaders/cubesat.vs", "shaders/cubesat.fs" };
     Shader textShader { "shaders/text.vs", "shaders/text.fs" };
+    Shader plotShader { "shaders/plot.vs", "shaders/plot.fs" };
    
     // Skybox 
     unsigned int skyboxVAO;
@@ -108,6 +1005,11 @@ int main(int argc, char *argv[])
     // Telemetry display
     TelemetryDisplay telemetry(textRenderer, textShader);
     telemetry.collateEntries();
+    if (replayClock) { telemetry.addEntry("Replay:", TelemetryPosition::TopRight); }
+
+    // Strip charts: P toggles, [ and ] halve and double the time span
+    StripCharts charts(plotShader, textRenderer, textShader);
+    charts.collatePlots();
 
     // Setting textures (not abstracting away to keep texture unit indices visible)
     skyboxShader.use();
@@ -118,7 +1020,7 @@ int main(int argc, char *argv[])
 
     earthShader.use();
     earthShader.setInt("earthMap", 2);
-    earthShader.setVec3("lightPos", glm::normalize(state.lightPos));
+    earthShader.setVec3("lightPos", glm::normalize(rendered.lightPos));
     earthShader.setVec3("viewPos", camera.Position);
 
     cubesatShader.use();
@@ -127,76 +1029,94 @@ int main(int argc, char *argv[])
     cubesatShader.setInt("material.topDiffuse", 5);
     cubesatShader.setInt("material.bottomDiffuse", 6);
 
-    // To the user: check terminal for detailed sim speed info
-    const float SIM_SPEED = getSimSpeed();
+    if (!replayClock) { physics.start(); }
 
     while (!glfwWindowShouldClose(window)) 
     {
-         
-        updateDeltaTime(state);
+        PROFILE_ZONE("frame");
+        updateDeltaTime(rendered);
 
-        const float simDeltaTime = state.deltaTime * SIM_SPEED;
-        const int subSteps = 15;  
-        float subDt = simDeltaTime / static_cast<float>(subSteps);
-        for (int i = 0; i < subSteps; ++i)
+        TelemetryFrame shown;
+        if (replayClock)
         {
-            propagateOrbit(state, subDt);          
-            updateAttitudeControl(state, subDt);  
+            processReplayInput(window, *replayClock);
+            replayClock->advance(rendered.deltaTime);
+            shown = replay.sample(replayClock->getTime());
         }
-        state.simElapsedTime += simDeltaTime;
+        else
+        {
+            physics.update();
+            shown = physics.latest();
+        }
+        applyTelemetryFrame(shown, rendered);
   
-        processInput(window, state);
+        processInput(window, rendered);
+        processChartInput(window, charts);
+
+        {
+            PROFILE_ZONE("renderScene");
 
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::mat4 view = computeCameraView(state, camera);
-        glm::mat4 projection = glm::perspective(
-                glm::radians(camera.Zoom), (float)Window::SCR_WIDTH / (float)Window::SCR_HEIGHT, 0.1f, 1000.0f);
+            glm::mat4 view = computeCameraView(rendered, camera);
+            glm::mat4 projection = glm::perspective(
+                    glm::radians(camera.Zoom), (float)Window::SCR_WIDTH / (float)Window::SCR_HEIGHT, 0.1f, 1000.0f);
    
-        // Skybox 
-        renderSkybox(skyboxShader, view, projection, skyboxVAO, cubemapTexture);
-
-        // Sun 
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, sunMap);
-        renderSun(sunShader, view, projection, state.lightPos);
-        sun.draw();
-
-        // Earth
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, earthMap);
-        renderEarth(earthShader, view, projection, 
-                    state.lightPos, camera.Position, SIM_SPEED);
-        earth.draw();
-
-        // Cubesat
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, cubesatDiffuseMap);
-        glActiveTexture(GL_TEXTURE4);
-        glBindTexture(GL_TEXTURE_2D, cubesatSpecularMap);
-        glActiveTexture(GL_TEXTURE5);
-        glBindTexture(GL_TEXTURE_2D, cubesatTopMap);
-        glActiveTexture(GL_TEXTURE6);
-        glBindTexture(GL_TEXTURE_2D, cubesatBottomMap);
-        renderCubesat(cubesatShader, view, projection, 
-                      state.lightPos, camera.Position, state.cubesatPos, 
-                      state.cubesatOrientation);
-        cubesat.draw();
+            // Skybox 
+            renderSkybox(skyboxShader, view, projection, skyboxVAO, cubemapTexture);
+
+            // Sun 
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, sunMap);
+            renderSun(sunShader, view, projection, rendered.lightPos);
+            sun.draw();
+
+            // Earth
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, earthMap);
+            renderEarth(earthShader, view, projection, 
+                        rendered.lightPos, camera.Position, static_cast<float>(rendered.simElapsedTime));
+            earth.draw();
+
+            // Cubesat
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, cubesatDiffuseMap);
+            glActiveTexture(GL_TEXTURE4);
+            glBindTexture(GL_TEXTURE_2D, cubesatSpecularMap);
+            glActiveTexture(GL_TEXTURE5);
+            glBindTexture(GL_TEXTURE_2D, cubesatTopMap);
+            glActiveTexture(GL_TEXTURE6);
+            glBindTexture(GL_TEXTURE_2D, cubesatBottomMap);
+            renderCubesat(cubesatShader, view, projection, 
+                          rendered.lightPos, camera.Position, rendered.cubesatPos, 
+                          rendered.cubesatOrientation);
+            cubesat.draw();
+        }
 
         // Telemetry
+        if (replayClock)
+        {
+            std::ostringstream replayStatus;
+            replayStatus << 'x' << replayClock->getSpeed() << (replayClock->isPaused() ? " paused" : "");
+            telemetry.updateEntry("Replay:", replayStatus.str());
+        }
         telemetry.updateAndRender(
-            state.wheels.getTorque(),
-            state.wheels.getWheelAngularVelocity(0),
-            state.wheels.getWheelAngularVelocity(1),
-            state.wheels.getWheelAngularVelocity(2),
-            glm::length(state.cubesatPos) / SCALE_FACTOR -  Physics::EARTH_RADIUS,
-            state.simElapsedTime,
+            glm::vec3(shown.reactionTorque[0], shown.reactionTorque[1], shown.reactionTorque[2]),
+            shown.wheelSpeeds[0],
+            shown.wheelSpeeds[1],
+            shown.wheelSpeeds[2],
+            glm::length(glm::vec3(shown.position[0], shown.position[1], shown.position[2])) - Physics::EARTH_RADIUS,
+            static_cast<float>(shown.time),
             Window::SCR_WIDTH,
             Window::SCR_HEIGHT
         ); 
+        charts.updateAndRender(shown, glm::degrees(nadirPointingError(rendered)), Window::SCR_WIDTH, Window::SCR_HEIGHT);
 
-        glfwSwapBuffers(window);
+        {
+            PROFILE_ZONE("glfwSwapBuffers"); // Includes any wait for vsync
+            glfwSwapBuffers(window);
+        }
         glfwPollEvents();
     }
 
@@ -204,6 +1124,17 @@ int main(int argc, char *argv[])
     glDeleteBuffers(1, &skyboxVBO);
 
     glfwTerminate();
+    physics.stop();
+    saveScenarioOutputs(true);
+
+    if (pil)
+    {
+        const StreamingStats& latency = pil->getLatencyStats();
+        std::cout << std::setprecision(4) << "PIL round trip (us): n=" << latency.count()
+                  << " mean=" << latency.mean() << " p50=" << latency.percentile(50.0)
+                  << " p99=" << latency.percentile(99.0) << " max=" << latency.max()
+                  << ", timeouts=" << pil->getTimeouts() << ", stale cycles=" << pil->getStaleCycles() << '\n';
+    }
     return 0;
 }
 
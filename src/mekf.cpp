@@ -0,0 +1,242 @@
+#include "mekf.h"
+
+#include <cmath>
+
+namespace
+{
+    template <int R, int C>
+    void setBlock3(Matrix<R, C>& m, int row, int col, const Matrix<3, 3>& b)
+    {
+        m.template setBlock<3, 3>(row, col, b);
+    }
+
+    Matrix<3, 3> crossMatrix(const glm::dvec3& v)
+    {
+        return skew(v.x, v.y, v.z);
+    }
+}
+
+template <int N>
+MultiplicativeEkf<N>::MultiplicativeEkf(const EstimatorConfig& config)
+    : m_config { config }
+{
+    double att = m_config.initialAttitudeSigma * m_config.initialAttitudeSigma;
+    double bias = m_config.initialBiasSigma * m_config.initialBiasSigma;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        m_P(i, i) = att;
+        m_P(3 + i, 3 + i) = bias;
+    }
+    if constexpr (N == 9)
+    {
+        double mag = m_config.initialMagBiasSigma * m_config.initialMagBiasSigma;
+        for (int i = 0; i < 3; ++i)
+            m_P(6 + i, 6 + i) = mag;
+    }
+}
+
+template <int N>
+void MultiplicativeEkf<N>::step(const SensorReadings& readings, const glm::vec3& sunRef,
+                                const glm::vec3& magRef, float dt)
+{
+    m_sinceTick += dt;
+    m_tickAccum += dt;
+
+    double period = (m_config.rate > 0.0f) ? 1.0 / m_config.rate : 0.0;
+    if (m_tickAccum < period) { return; }
+    m_tickAccum = (period > 0.0) ? std::fmod(m_tickAccum, period) : 0.0;
+
+    double tickDt = m_sinceTick;
+    m_sinceTick = 0.0;
+
+    if (readings.gyro.valid)
+        m_lastGyro = glm::dvec3(readings.gyro.value);
+
+    // Wait for the first star tracker fix to seed the reference attitude
+    if (!m_initialized)
+    {
+        if (!readings.starTracker.valid) { return; }
+        m_q = glm::dquat(readings.starTracker.value);
+        m_lastStarTrackerTime = readings.starTracker.time;
+        m_initialized = true;
+        return;
+    }
+
+    predict(m_lastGyro, tickDt);
+
+    // Measurements are applied at the tick time; their latency is not compensated
+    if (readings.starTracker.valid && readings.starTracker.time > m_lastStarTrackerTime)
+    {
+        updateAttitude(glm::dquat(readings.starTracker.value), m_config.starTrackerSigma);
+        m_lastStarTrackerTime = readings.starTracker.time;
+    }
+
+    if (readings.sunVector.valid && readings.sunVector.time > m_lastSunTime)
+    {
+        updateVector(glm::dvec3(readings.sunVector.value), glm::dvec3(sunRef), m_config.sunSensorSigma, false);
+        m_lastSunTime = readings.sunVector.time;
+    }
+
+    if (readings.magField.valid && readings.magField.time > m_lastMagTime)
+    {
+        // Without a bias state the bias counts as noise. It is constant rather than white,
+        // so this still overstates what repeated readings add, but it stops a few hundred
+        // nT of bias from pulling the attitude away from the star tracker.
+        double magSigma { m_config.magSigma };
+        if constexpr (N == 6)
+            magSigma = std::sqrt(magSigma * magSigma + m_config.initialMagBiasSigma * m_config.initialMagBiasSigma);
+        updateVector(glm::dvec3(readings.magField.value), glm::dvec3(magRef), magSigma, true);
+        m_lastMagTime = readings.magField.time;
+    }
+}
+
+template <int N>
+void MultiplicativeEkf<N>::predict(const glm::dvec3& gyroRate, double dt)
+{
+    if (dt <= 0.0) { return; }
+
+    glm::dvec3 omega = gyroRate - m_gyroBias;
+
+    // Reference attitude: exact rotation over the interval (body-frame rate)
+    double rate = glm::length(omega);
+    if (rate > 1e-12)
+    {
+        double halfAngle = 0.5 * rate * dt;
+        glm::dvec3 axis = omega / rate;
+        glm::dquat dq(std::cos(halfAngle), std::sin(halfAngle) * axis);
+        m_q = glm::normalize(m_q * dq);
+    }
+
+    // Error-state transition, second order in dt
+    Matrix<3, 3> W = crossMatrix(omega);
+    Matrix<3, 3> I3 = Matrix<3, 3>::identity();
+    Matrix<3, 3> phi11 = I3 - W * dt + (W * W) * (0.5 * dt * dt);
+    Matrix<3, 3> phi12 = I3 * (-dt) + W * (0.5 * dt * dt);
+
+    Covariance phi = Covariance::identity();
+    setBlock3(phi, 0, 0, phi11);
+    setBlock3(phi, 0, 3, phi12);
+
+    double sv2 = m_config.gyroNoise * m_config.gyroNoise;
+    double su2 = m_config.gyroBiasWalk * m_config.gyroBiasWalk;
+
+    Covariance Q {};
+    for (int i = 0; i < 3; ++i)
+    {
+        Q(i, i) = sv2 * dt + su2 * dt * dt * dt / 3.0;
+        Q(i, 3 + i) = -su2 * dt * dt / 2.0;
+        Q(3 + i, i) = Q(i, 3 + i);
+        Q(3 + i, 3 + i) = su2 * dt;
+    }
+    if constexpr (N == 9)
+    {
+        double sm2 = m_config.magBiasWalk * m_config.magBiasWalk;
+        for (int i = 0; i < 3; ++i)
+            Q(6 + i, 6 + i) = sm2 * dt;
+    }
+
+    m_P = phi * m_P * phi.transposed() + Q;
+    symmetrize(m_P);
+}
+
+template <int N>
+void MultiplicativeEkf<N>::updateAttitude(const glm::dquat& measured, double sigma)
+{
+    glm::dquat dq = glm::conjugate(m_q) * measured;
+    if (dq.w < 0.0) { dq = -dq; }
+
+    Vector<3> residual {};
+    residual(0, 0) = 2.0 * dq.x;
+    residual(1, 0) = 2.0 * dq.y;
+    residual(2, 0) = 2.0 * dq.z;
+
+    Matrix<3, N> H {};
+    setBlock3(H, 0, 0, Matrix<3, 3>::identity());
+
+    applyUpdate<3>(H, residual, Matrix<3, 3>::identity() * (sigma * sigma));
+}
+
+template <int N>
+void MultiplicativeEkf<N>::updateVector(const glm::dvec3& measuredBody, const glm::dvec3& reference,
+                                        double sigma, bool magnetometer)
+{
+    glm::dvec3 predicted = glm::conjugate(m_q) * reference;
+
+    Matrix<3, N> H {};
+    setBlock3(H, 0, 0, crossMatrix(predicted));
+
+    if constexpr (N == 9)
+    {
+        if (magnetometer)
+        {
+            predicted += m_magBias;
+            setBlock3(H, 0, 6, Matrix<3, 3>::identity());
+        }
+    }
+
+    glm::dvec3 diff = measuredBody - predicted;
+    Vector<3> residual {};
+    residual(0, 0) = diff.x;
+    residual(1, 0) = diff.y;
+    residual(2, 0) = diff.z;
+
+    applyUpdate<3>(H, residual, Matrix<3, 3>::identity() * (sigma * sigma));
+}
+
+template <int N>
+template <int M>
+void MultiplicativeEkf<N>::applyUpdate(const Matrix<M, N>& H, const Vector<M>& residual,
+                                       const Matrix<M, M>& measCov)
+{
+    Matrix<N, M> PHt = m_P * H.transposed();
+    Matrix<M, M> S = H * PHt + measCov;
+
+    // S is symmetric, so K^T = S^-1 (H P)
+    Matrix<M, N> Kt = PHt.transposed();
+    if (!choleskySolve(S, Kt)) { return; }
+    Matrix<N, M> K = Kt.transposed();
+
+    // Joseph form keeps P symmetric positive definite
+    Covariance IKH = Covariance::identity() - K * H;
+    m_P = IKH * m_P * IKH.transposed() + K * measCov * Kt;
+    symmetrize(m_P);
+
+    reset(K * residual);
+}
+
+template <int N>
+void MultiplicativeEkf<N>::reset(const StateVector& dx)
+{
+    glm::dvec3 dTheta(dx(0, 0), dx(1, 0), dx(2, 0));
+    glm::dquat dq(1.0, 0.5 * dTheta.x, 0.5 * dTheta.y, 0.5 * dTheta.z);
+    m_q = glm::normalize(m_q * dq);
+
+    m_gyroBias += glm::dvec3(dx(3, 0), dx(4, 0), dx(5, 0));
+    if constexpr (N == 9)
+        m_magBias += glm::dvec3(dx(6, 0), dx(7, 0), dx(8, 0));
+}
+
+template <int N>
+bool MultiplicativeEkf<N>::isInitialized() const { return m_initialized; }
+
+template <int N>
+glm::quat MultiplicativeEkf<N>::getAttitude() const { return glm::quat(m_q); }
+
+template <int N>
+glm::vec3 MultiplicativeEkf<N>::getAngularVelocity() const
+{
+    return glm::vec3(m_q * (m_lastGyro - m_gyroBias));
+}
+
+template <int N>
+glm::vec3 MultiplicativeEkf<N>::getGyroBias() const { return glm::vec3(m_gyroBias); }
+
+template <int N>
+const typename MultiplicativeEkf<N>::Covariance& MultiplicativeEkf<N>::getCovariance() const { return m_P; }
+
+template <int N>
+const EstimatorConfig& MultiplicativeEkf<N>::getConfig() const { return m_config; }
+
+template class MultiplicativeEkf<6>;
+template class MultiplicativeEkf<9>;
@@ -0,0 +1,181 @@
+#include "monte_carlo.h"
+#include "functions_main.h"
+#include "nadir_controller.h"
+#include "parallel.h"
+#include "random_stream.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+    // Keeps dispersion draws disjoint from the sensor noise streams sharing the seed
+    constexpr std::uint64_t DISPERSION_KEY { 0x9E3779B97F4A7C15ull };
+
+    glm::quat randomAttitude(RandomStream& rng)
+    {
+        float u1 = rng.uniform();
+        float u2 = rng.uniform() * glm::two_pi<float>();
+        float u3 = rng.uniform() * glm::two_pi<float>();
+
+        float a = std::sqrt(1.0f - u1);
+        float b = std::sqrt(u1);
+        return glm::normalize(glm::quat(b * std::cos(u3), a * std::sin(u2), a * std::cos(u2), b * std::sin(u3)));
+    }
+
+    glm::vec3 randomDirection(RandomStream& rng)
+    {
+        glm::vec3 v(rng.normal(), rng.normal(), rng.normal());
+        float len = glm::length(v);
+        return (len > 1e-6f) ? v / len : glm::vec3(1.0f, 0.0f, 0.0f);
+    }
+
+    float dispersed(RandomStream& rng, float nominal, float sigma)
+    {
+        return nominal * std::max(0.1f, 1.0f + sigma * rng.normal());
+    }
+}
+
+void sampleDispersedState(const DispersionConfig& config, std::uint64_t runIdx, SimulationState& state)
+{
+    RandomStream rng(config.seed ^ DISPERSION_KEY, runIdx);
+
+    // Random phase along the nominal circular orbit (orbit normal is +Y)
+    float phase = rng.uniform() * glm::two_pi<float>();
+    glm::quat orbitPhase = glm::angleAxis(phase, glm::vec3(0.0f, 1.0f, 0.0f));
+    state.cubesatPos = orbitPhase * state.cubesatPos;
+    state.cubesatVel = orbitPhase * calculateCubesatVel();
+
+    state.inertia = glm::mat3(
+        dispersed(rng, CUBESAT_INERTIA[0][0], config.inertiaSigma), 0.0f, 0.0f,
+        0.0f, dispersed(rng, CUBESAT_INERTIA[1][1], config.inertiaSigma), 0.0f,
+        0.0f, 0.0f, dispersed(rng, CUBESAT_INERTIA[2][2], config.inertiaSigma)
+    );
+    state.inverseInertia = glm::inverse(state.inertia);
+
+    state.wheels = ReactionWheelSystem(dispersed(rng, WHEEL_INERTIA, config.wheelInertiaSigma),
+                                       dispersed(rng, WHEEL_MAX_TORQUE, config.wheelTorqueSigma));
+
+    state.sensors = SensorSuite(SensorConfig {}, config.seed, static_cast<std::uint32_t>(runIdx));
+
+    glm::quat attitude = randomAttitude(rng);
+    glm::vec3 bodyRates = randomDirection(rng) * (rng.uniform() * config.maxBodyRate);
+    initTumble(state, attitude, bodyRates);
+}
+
+RunMetrics runDispersedCase(const DispersionConfig& config, std::uint64_t runIdx, StreamingStats* pointingErrorDeg)
+{
+    SimulationState state;
+    sampleDispersedState(config, runIdx, state);
+    return simulateAndScore(state, config, pointingErrorDeg);
+}
+
+RunMetrics simulateAndScore(SimulationState& state, const DispersionConfig& config, StreamingStats* pointingErrorDeg)
+{
+    RunMetrics metrics;
+    const double startTime { state.simElapsedTime };
+    const double adcsStartTime { state.adcs.getTime() }; // The mode manager keeps its own clock
+    double lastExceedTime { startTime };
+    bool everExceeded { false };
+    double steadyStateStart = startTime + config.duration * (1.0f - config.steadyStateFraction);
+
+    // Rounded like the headless and --checkpoint runs, so a sweep job is not a step short
+    const long long steps { std::llround(config.duration / config.dt) };
+    for (long long i = 0; i < steps; ++i)
+    {
+        stepSimulation(state, config.dt, 1);
+
+        for (int w = 0; w < numWheels; ++w)
+            metrics.peakWheelSpeed = std::max(metrics.peakWheelSpeed,
+                                              std::abs(state.wheels.getWheelAngularVelocity(w)));
+
+        float error = nadirPointingError(state);
+        if (error > config.settleAngle)
+        {
+            lastExceedTime = state.simElapsedTime;
+            everExceeded = true;
+        }
+
+        if (pointingErrorDeg && state.simElapsedTime >= steadyStateStart)
+            pointingErrorDeg->add(glm::degrees(error));
+
+        metrics.finalPointingError = error;
+    }
+
+    bool settled = metrics.finalPointingError <= config.settleAngle;
+    metrics.settlingTime = settled ? (everExceeded ? static_cast<float>(lastExceedTime - startTime) : 0.0f) : -1.0f;
+
+    // Relative to the start of the run like settlingTime; 0 when it started in NADIR
+    double nadirEntry { state.adcs.getNadirEntryTime() };
+    metrics.nadirEntryTime = (nadirEntry >= 0.0) ? static_cast<float>(std::max(0.0, nadirEntry - adcsStartTime)) : -1.0f;
+
+    return metrics;
+}
+
+MonteCarloSummary runMonteCarlo(const DispersionConfig& config)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // One summary per worker, merged at the end; nothing is shared while running
+    unsigned int threads = resolveThreadCount(config.threads);
+    std::vector<MonteCarloSummary> perWorker(threads);
+
+    parallelFor(static_cast<std::size_t>(config.runs), threads, [&](std::size_t runIdx, unsigned int worker) {
+        MonteCarloSummary& acc = perWorker[worker];
+        RunMetrics m = runDispersedCase(config, runIdx, &acc.pointingErrorDeg);
+
+        ++acc.runs;
+        acc.peakWheelSpeed.add(m.peakWheelSpeed);
+        if (m.settlingTime >= 0.0f)
+        {
+            ++acc.settledRuns;
+            acc.settlingTime.add(m.settlingTime);
+        }
+        if (m.nadirEntryTime >= 0.0f)
+            acc.timeToNadir.add(m.nadirEntryTime);
+    });
+
+    MonteCarloSummary summary;
+    for (const auto& acc : perWorker)
+    {
+        summary.runs += acc.runs;
+        summary.settledRuns += acc.settledRuns;
+        summary.settlingTime.merge(acc.settlingTime);
+        summary.timeToNadir.merge(acc.timeToNadir);
+        summary.peakWheelSpeed.merge(acc.peakWheelSpeed);
+        summary.pointingErrorDeg.merge(acc.pointingErrorDeg);
+    }
+
+    summary.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return summary;
+}
+
+void printMonteCarloSummary(const MonteCarloSummary& summary, std::ostream& out)
+{
+    auto row = [&out](const char* name, const StreamingStats& s) {
+        out << std::left << std::setw(24) << name << std::right
+            << std::setw(8) << s.count()
+            << std::setw(12) << s.mean()
+            << std::setw(12) << s.percentile(50.0)
+            << std::setw(12) << s.percentile(95.0)
+            << std::setw(12) << s.percentile(99.0)
+            << std::setw(12) << s.max() << '\n';
+    };
+
+    out << std::setprecision(4);
+    out << "Monte Carlo: " << summary.runs << " runs, " << summary.settledRuns << " settled, "
+        << summary.wallSeconds << " s wall\n";
+    out << std::left << std::setw(24) << "metric" << std::right
+        << std::setw(8) << "n" << std::setw(12) << "mean" << std::setw(12) << "p50"
+        << std::setw(12) << "p95" << std::setw(12) << "p99" << std::setw(12) << "max" << '\n';
+
+    row("settling time (s)", summary.settlingTime);
+    row("time to nadir (s)", summary.timeToNadir);
+    row("peak wheel (rad/s)", summary.peakWheelSpeed);
+    row("pointing error (deg)", summary.pointingErrorDeg);
+}
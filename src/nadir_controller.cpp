@@ -16,10 +16,27 @@ constexpr float zeta = 1.0f;
 const glm::vec3 Kp = inertiaDiag * (wn * wn);
 const glm::vec3 Kd = inertiaDiag * (2.0f * zeta * wn);
 
+// Equilibrium slew rate when the proportional term is saturated
+constexpr float MAX_SLEW_RATE = 0.02f; // rad/s
+
 constexpr float ANGLE_DEADBAND_DEG = 1.0f;
 constexpr float RATE_DEADBAND      = 0.0005f;
 
+float nadirPointingError(const SimulationState& state)
+{
+    glm::vec3 nadir = glm::normalize(-state.cubesatPos);
+    glm::vec3 boresight = state.cubesatOrientation * glm::vec3(0.0f, 0.0f, 1.0f);
+
+    return std::acos(glm::clamp(glm::dot(nadir, boresight), -1.0f, 1.0f));
+}
+
 glm::vec3 computeNadirTorque(const SimulationState& state)
+{
+    return computeNadirTorque(state, state.cubesatOrientation, state.cubesatAngularVel);
+}
+
+glm::vec3 computeNadirTorque(const SimulationState& state, const glm::quat& attitude,
+                             const glm::vec3& angularVel)
 {
     glm::vec3 r = state.cubesatPos;
     glm::vec3 v = state.cubesatVel;
@@ -33,7 +50,19 @@ glm::vec3 computeNadirTorque(const SimulationState& state)
     glm::mat3 R_desired(x_dir, y_dir, z_dir);
     glm::quat q_desired = glm::normalize(glm::quat_cast(R_desired));
 
-    glm::quat q_err = q_desired * glm::inverse(state.cubesatOrientation);
+    // Orbital rate
+    float mu = Physics::G * Physics::EARTH_MASS;
+    float r_unscaled = glm::length(r) / SCALE_FACTOR;
+    float orbitalRate = std::sqrt(mu / (r_unscaled * r_unscaled * r_unscaled));
+    glm::vec3 desiredAngVel = R_desired * glm::vec3(0.0f, orbitalRate, 0.0f);
+
+    return computeTrackingTorque(attitude, angularVel, q_desired, desiredAngVel);
+}
+
+glm::vec3 computeTrackingTorque(const glm::quat& attitude, const glm::vec3& angularVel,
+                                const glm::quat& desired, const glm::vec3& desiredAngVel)
+{
+    glm::quat q_err = desired * glm::inverse(attitude);
     if (q_err.w < 0.0f) q_err = -q_err;
     q_err = glm::normalize(q_err);
 
@@ -41,19 +70,13 @@ glm::vec3 computeNadirTorque(const SimulationState& state)
     float errorAngle = glm::angle(q_err);
     if (glm::any(glm::isnan(errorAxis))) { errorAxis = glm::vec3(0.0f); errorAngle = 0.0f; }
 
-    // Orbital rate
-    float mu = Physics::G * Physics::EARTH_MASS;
-    float r_unscaled = glm::length(r);
-    float orbitalRate = std::sqrt(mu / (r_unscaled * r_unscaled * r_unscaled));
-    glm::vec3 desiredAngVel = R_desired * glm::vec3(0.0f, orbitalRate, 0.0f);
-
-    glm::vec3 angVelError = state.cubesatAngularVel - desiredAngVel;
+    glm::vec3 angVelError = angularVel - desiredAngVel;
  
-    // If pointing error is large, focus only on attitude correction
-    glm::vec3 proportional = Kp * errorAngle * errorAxis;
-    glm::vec3 derivative = (glm::degrees(errorAngle) > 20.0f)
-                            ? inertiaDiag * -state.cubesatAngularVel
-                            : Kd * angVelError;
+    // Output is the wheel torque command; the body feels the opposite torque.
+    // Large initial errors and tumbling are handled by the ADCS mode logic.
+    glm::vec3 proportional = glm::clamp(Kp * errorAngle * errorAxis,
+                                        -Kd * MAX_SLEW_RATE, Kd * MAX_SLEW_RATE);
+    glm::vec3 derivative = -Kd * angVelError;
 
     glm::vec3 controlTorque = -(proportional + derivative);
 
@@ -62,4 +85,3 @@ glm::vec3 computeNadirTorque(const SimulationState& state)
 
     return controlTorque;
 }
-
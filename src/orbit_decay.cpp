@@ -0,0 +1,255 @@
+#include "orbit_decay.h"
+#include "environment.h"
+#include "parallel.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+    struct AtmosphereLayer
+    {
+        double baseAltitude; // km
+        double baseDensity;  // kg/m^3
+        double scaleHeight;  // km
+    };
+
+    constexpr AtmosphereLayer ATMOSPHERE[] {
+        { 0.0, 1.225, 7.249 },         { 25.0, 3.899e-2, 6.349 },   { 30.0, 1.774e-2, 6.682 },
+        { 40.0, 3.972e-3, 7.554 },     { 50.0, 1.057e-3, 8.382 },   { 60.0, 3.206e-4, 7.714 },
+        { 70.0, 8.770e-5, 6.549 },     { 80.0, 1.905e-5, 5.799 },   { 90.0, 3.396e-6, 5.382 },
+        { 100.0, 5.297e-7, 5.877 },    { 110.0, 9.661e-8, 7.263 },  { 120.0, 2.438e-8, 9.473 },
+        { 130.0, 8.484e-9, 12.636 },   { 140.0, 3.845e-9, 16.149 }, { 150.0, 2.070e-9, 22.523 },
+        { 180.0, 5.464e-10, 29.740 },  { 200.0, 2.789e-10, 37.105 }, { 250.0, 7.248e-11, 45.546 },
+        { 300.0, 2.418e-11, 53.628 },  { 350.0, 9.518e-12, 53.298 }, { 400.0, 3.725e-12, 58.515 },
+        { 450.0, 1.585e-12, 60.828 },  { 500.0, 6.967e-13, 63.822 }, { 600.0, 1.454e-13, 71.835 },
+        { 700.0, 3.614e-14, 88.667 },  { 800.0, 1.170e-14, 124.64 }, { 900.0, 5.245e-15, 181.05 },
+        { 1000.0, 3.019e-15, 268.00 },
+    };
+
+    // Orbit averages use this many equally spaced eccentric anomalies. The integrand is
+    // periodic and smooth, so the trapezoid rule converges geometrically; 64 points
+    // resolve the perigee density peak up to a*e of several scale heights.
+    constexpr int AVERAGING_POINTS { 64 };
+
+    struct MeanRates
+    {
+        double semiMajorAxis; // m/s
+        double eccentricity;  // 1/s
+    };
+
+    // Gauss's equations for a purely tangential drag acceleration -rho B v^2 / 2,
+    // averaged over one orbit (dM = (1 - e cos E) dE)
+    MeanRates dragRates(double a, double e, double ballistic)
+    {
+        const double mu { Orbit::EARTH_MU };
+        double sumA { 0.0 }, sumE { 0.0 };
+        for (int k = 0; k < AVERAGING_POINTS; ++k)
+        {
+            double cE { std::cos(glm::two_pi<double>() * k / AVERAGING_POINTS) };
+            double w { 1.0 - e * cE };
+            double r { a * w };
+            double rho { atmosphericDensity(r - Orbit::EARTH_RADIUS) };
+            double v { std::sqrt(mu * (2.0 / r - 1.0 / a)) };
+            double cosNu { (cE - e) / w };
+
+            sumA += rho * v * v * v * w;
+            sumE += rho * v * (e + cosNu) * w;
+        }
+        return { -ballistic * a * a / mu * sumA / AVERAGING_POINTS, -ballistic * sumE / AVERAGING_POINTS };
+    }
+
+    struct SecularRates
+    {
+        double raan, argPeriapsis, meanAnomaly; // rad/s
+    };
+
+    SecularRates j2Rates(double a, double e, double inclination)
+    {
+        double n { std::sqrt(Orbit::EARTH_MU / (a * a * a)) };
+        double p { a * (1.0 - e * e) };
+        double k { 0.75 * n * Orbit::EARTH_J2 * (Orbit::EARTH_RADIUS / p) * (Orbit::EARTH_RADIUS / p) };
+        double c2 { std::cos(inclination) * std::cos(inclination) };
+        return { -2.0 * k * std::cos(inclination), k * (5.0 * c2 - 1.0),
+                 n + k * std::sqrt(1.0 - e * e) * (3.0 * c2 - 1.0) };
+    }
+
+    double trueToMean(double nu, double e)
+    {
+        double ecc { 2.0 * std::atan(std::sqrt((1.0 - e) / (1.0 + e)) * std::tan(0.5 * nu)) };
+        return ecc - e * std::sin(ecc);
+    }
+
+    double meanToTrue(double m, double e)
+    {
+        double ecc { m };
+        for (int i = 0; i < 20; ++i)
+        {
+            double step { (ecc - e * std::sin(ecc) - m) / (1.0 - e * std::cos(ecc)) };
+            ecc -= step;
+            if (std::abs(step) < 1e-13) { break; }
+        }
+        return 2.0 * std::atan(std::sqrt((1.0 + e) / (1.0 - e)) * std::tan(0.5 * ecc));
+    }
+
+    // Point mass gravity, J2 and drag in a non-rotating atmosphere
+    glm::dvec3 perturbedAcceleration(const glm::dvec3& pos, const glm::dvec3& vel, const glm::dvec3& spin,
+                                     double ballistic)
+    {
+        double r { glm::length(pos) };
+        double z { glm::dot(pos, spin) / r };
+        double k { 1.5 * Orbit::EARTH_J2 * Orbit::EARTH_MU * Orbit::EARTH_RADIUS * Orbit::EARTH_RADIUS / (r * r * r * r) };
+        glm::dvec3 j2 = -k * ((1.0 - 5.0 * z * z) * (pos / r) + 2.0 * z * spin);
+
+        double rho { atmosphericDensity(r - Orbit::EARTH_RADIUS) };
+        glm::dvec3 drag = -0.5 * ballistic * rho * glm::length(vel) * vel;
+
+        return gravityAcceleration(pos) + j2 + drag;
+    }
+
+    DecayResult decay(const DecaySatellite& sat, const DecayConfig& config)
+    {
+        const double b { sat.ballisticCoefficient };
+        DecayResult result;
+
+        double a { sat.elements.semiMajorAxis };
+        double e { sat.elements.eccentricity };
+        double inclination { sat.elements.inclination };
+        double raan { sat.elements.raan };
+        double argp { sat.elements.argPeriapsis };
+        double m { trueToMean(sat.elements.trueAnomaly, e) };
+        double t { 0.0 };
+
+        auto meanElements = [&]() {
+            return OrbitalElements { a, e, inclination, raan, argp, meanToTrue(m, e) };
+        };
+
+        while (t < config.maxDuration)
+        {
+            double perigeeAltitude { a * (1.0 - e) - Orbit::EARTH_RADIUS };
+            if (perigeeAltitude < config.reentryAltitude)
+            {
+                result.reentered = true;
+                result.lifetime = t;
+                result.finalElements = meanElements();
+                return result;
+            }
+            if (perigeeAltitude < config.switchAltitude) { break; }
+
+            double period { glm::two_pi<double>() * std::sqrt(a * a * a / Orbit::EARTH_MU) };
+            MeanRates k1 = dragRates(a, e, b);
+
+            // Whole orbits per step, as many as keep both apsides within the drop limit
+            double apsisRate { std::max(std::abs(k1.semiMajorAxis * (1.0 - e) - a * k1.eccentricity),
+                                        std::abs(k1.semiMajorAxis * (1.0 + e) + a * k1.eccentricity)) };
+            double orbits { static_cast<double>(config.maxOrbitsPerStep) };
+            if (apsisRate > 0.0)
+                orbits = glm::clamp(std::floor(config.maxApsisDropPerStep / (apsisRate * period)), 1.0, orbits);
+            double h { std::min(orbits * period, config.maxDuration - t) };
+
+            double aMid { a + 0.5 * h * k1.semiMajorAxis };
+            double eMid { std::max(0.0, e + 0.5 * h * k1.eccentricity) };
+            MeanRates k2 = dragRates(aMid, eMid, b);
+            SecularRates j2 = j2Rates(aMid, eMid, inclination);
+
+            a += h * k2.semiMajorAxis;
+            e = std::max(0.0, e + h * k2.eccentricity);
+            raan = std::remainder(raan + h * j2.raan, glm::two_pi<double>());
+            argp = std::remainder(argp + h * j2.argPeriapsis, glm::two_pi<double>());
+            m = std::remainder(m + h * j2.meanAnomaly, glm::two_pi<double>());
+            t += h;
+            ++result.averagedSteps;
+        }
+
+        if (t >= config.maxDuration)
+        {
+            result.lifetime = config.maxDuration;
+            result.finalElements = meanElements();
+            return result;
+        }
+
+        // Numerical phase from the mean state; the J2 short period terms are ignored
+        const glm::dvec3 spin { glm::normalize(glm::dvec3(earthSpinAxis())) };
+        OrbitSample s = elementsToState(meanElements(), t);
+        auto accel = [&](const glm::dvec3& p, const glm::dvec3& v) { return perturbedAcceleration(p, v, spin, b); };
+
+        double altitude { glm::length(s.pos) - Orbit::EARTH_RADIUS };
+        while (s.time < config.maxDuration)
+        {
+            double dt { std::min(config.numericalStep, config.maxDuration - s.time) };
+
+            glm::dvec3 k1v = accel(s.pos, s.vel);
+            glm::dvec3 k1r = s.vel;
+            glm::dvec3 k2v = accel(s.pos + 0.5 * dt * k1r, s.vel + 0.5 * dt * k1v);
+            glm::dvec3 k2r = s.vel + 0.5 * dt * k1v;
+            glm::dvec3 k3v = accel(s.pos + 0.5 * dt * k2r, s.vel + 0.5 * dt * k2v);
+            glm::dvec3 k3r = s.vel + 0.5 * dt * k2v;
+            glm::dvec3 k4v = accel(s.pos + dt * k3r, s.vel + dt * k3v);
+            glm::dvec3 k4r = s.vel + dt * k3v;
+
+            s.pos += dt / 6.0 * (k1r + 2.0 * k2r + 2.0 * k3r + k4r);
+            s.vel += dt / 6.0 * (k1v + 2.0 * k2v + 2.0 * k3v + k4v);
+            s.time += dt;
+            ++result.numericalSteps;
+
+            double nextAltitude { glm::length(s.pos) - Orbit::EARTH_RADIUS };
+            if (nextAltitude < config.reentryAltitude)
+            {
+                double f { (altitude - config.reentryAltitude) / (altitude - nextAltitude) };
+                result.reentered = true;
+                result.lifetime = s.time - dt + f * dt;
+                result.finalElements = stateToElements(s);
+                return result;
+            }
+            altitude = nextAltitude;
+        }
+
+        result.lifetime = config.maxDuration;
+        result.finalElements = stateToElements(s);
+        return result;
+    }
+}
+
+double atmosphericDensity(double altitude)
+{
+    double km { altitude * 1.0e-3 };
+    const AtmosphereLayer* layer = &ATMOSPHERE[0];
+    for (const AtmosphereLayer& l : ATMOSPHERE)
+    {
+        if (l.baseAltitude > km) { break; }
+        layer = &l;
+    }
+    return layer->baseDensity * std::exp(-(km - layer->baseAltitude) / layer->scaleHeight);
+}
+
+std::vector<DecayResult> estimateOrbitLifetimes(const std::vector<DecaySatellite>& satellites,
+                                                const DecayConfig& config)
+{
+    std::vector<DecayResult> results(satellites.size());
+    parallelFor(satellites.size(), config.threads, [&](std::size_t i, unsigned int) {
+        results[i] = decay(satellites[i], config);
+    });
+    return results;
+}
+
+void writeDecayCsv(std::ostream& out, const std::vector<DecaySatellite>& satellites,
+                   const std::vector<DecayResult>& results)
+{
+    out << "satellite,perigee_km,apogee_km,inclination_deg,ballistic_m2_per_kg,reentered,lifetime_days,"
+           "averaged_steps,numerical_steps\n";
+    out << std::fixed;
+    for (std::size_t i = 0; i < satellites.size() && i < results.size(); ++i)
+    {
+        const OrbitalElements& el = satellites[i].elements;
+        const DecayResult& r = results[i];
+        out << i << ',' << std::setprecision(3)
+            << (el.semiMajorAxis * (1.0 - el.eccentricity) - Orbit::EARTH_RADIUS) * 1.0e-3 << ','
+            << (el.semiMajorAxis * (1.0 + el.eccentricity) - Orbit::EARTH_RADIUS) * 1.0e-3 << ','
+            << glm::degrees(el.inclination) << ',' << std::setprecision(6) << satellites[i].ballisticCoefficient << ','
+            << (r.reentered ? 1 : 0) << ',' << std::setprecision(3) << r.lifetime / 86400.0 << ','
+            << r.averagedSteps << ',' << r.numericalSteps << '\n';
+    }
+}
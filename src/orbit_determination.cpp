@@ -0,0 +1,310 @@
+#include "orbit_determination.h"
+#include "environment.h"
+#include "functions_main.h"
+#include "parallel.h"
+#include "random_stream.h"
+#include "simulation_state.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+    // Keeps measurement noise disjoint from other streams sharing the seed
+    constexpr std::uint64_t TRACKING_KEY { 0xD1B54A32D192ED03ull };
+
+    struct StationGeometry
+    {
+        glm::dvec3 pos;
+        glm::dvec3 vel;
+        glm::dvec3 up;
+        glm::dvec3 east;
+        glm::dvec3 north;
+    };
+
+    StationGeometry stationAt(const GroundStation& gs, double time)
+    {
+        const glm::dvec3 spin { glm::normalize(glm::dvec3(earthSpinAxis())) };
+
+        StationGeometry st;
+        st.pos = earthFixedToInertial(geodeticToEarthFixed(gs.latitude, gs.longitude, gs.altitude), time);
+        st.vel = Orbit::EARTH_ROTATION_RATE * glm::cross(spin, st.pos);
+        st.up = glm::normalize(st.pos);
+        st.east = glm::normalize(glm::cross(spin, st.up));
+        st.north = glm::cross(st.up, st.east);
+        return st;
+    }
+
+    using Row = Matrix<1, 6>;
+
+    struct Predicted
+    {
+        double range, rangeRate, azimuth, elevation;
+        Row dRange, dRangeRate, dAzimuth, dElevation; // d/d(satellite state)
+        bool azimuthValid;                            // False near zenith, where azimuth is singular
+    };
+
+    Predicted predict(const OrbitSample& sat, const StationGeometry& st)
+    {
+        glm::dvec3 rho = sat.pos - st.pos;
+        glm::dvec3 dv = sat.vel - st.vel;
+        double range { glm::length(rho) };
+        glm::dvec3 u = rho / range;
+
+        Predicted p;
+        p.range = range;
+        p.rangeRate = glm::dot(u, dv);
+
+        double sinEl { glm::dot(u, st.up) };
+        p.elevation = std::asin(glm::clamp(sinEl, -1.0, 1.0));
+        double e { glm::dot(rho, st.east) };
+        double n { glm::dot(rho, st.north) };
+        p.azimuth = std::atan2(e, n);
+        double horizontal2 { e * e + n * n };
+        p.azimuthValid = horizontal2 > 0.01 * range * range;
+
+        glm::dvec3 dRateDr = (dv - p.rangeRate * u) / range;
+        glm::dvec3 dElDr = (st.up - sinEl * u) / (range * std::max(std::cos(p.elevation), 1e-6));
+        glm::dvec3 dAzDr = (n * st.east - e * st.north) / std::max(horizontal2, 1e-12);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            p.dRange(0, i) = u[i];
+            p.dRangeRate(0, i) = dRateDr[i];
+            p.dRangeRate(0, i + 3) = u[i];
+            p.dElevation(0, i) = dElDr[i];
+            p.dAzimuth(0, i) = dAzDr[i];
+        }
+        return p;
+    }
+
+    // Normal equations of one chunk, in the coordinates of the chunk's boundary state
+    struct ChunkNormals
+    {
+        StateMatrix lambda;
+        StateVector rhs;
+        StateMatrix toNextBoundary { StateMatrix::identity() };
+
+        double rangeSq { 0.0 }, rangeRateSq { 0.0 }, angleSq { 0.0 };
+        std::size_t rangeCount { 0 }, rangeRateCount { 0 }, angleCount { 0 };
+
+        void add(const Row& h, double residual, double sigma)
+        {
+            double w { 1.0 / (sigma * sigma) };
+            lambda += (h.transposed() * h) * w;
+            rhs += h.transposed() * (residual * w);
+        }
+    };
+
+    double rms(double sumSq, std::size_t count)
+    {
+        return (count > 0) ? std::sqrt(sumSq / static_cast<double>(count)) : 0.0;
+    }
+}
+
+std::vector<TrackingObservation> simulateTracking(const SimulationState& initial,
+                                                  const std::vector<GroundStation>& stations,
+                                                  const TrackingConfig& config)
+{
+    SimulationState truth = initial;
+    RandomStream noise(config.seed ^ TRACKING_KEY, 0);
+
+    int stepsPerSample = std::max(1, static_cast<int>(std::lround(config.interval / config.truthStep)));
+    int samples = static_cast<int>(config.duration / config.interval);
+    double time { initial.simElapsedTime };
+
+    std::vector<TrackingObservation> observations;
+    for (int k = 0; k <= samples; ++k)
+    {
+        if (k > 0)
+        {
+            for (int i = 0; i < stepsPerSample; ++i)
+                propagateOrbit(truth, config.truthStep);
+            time += stepsPerSample * static_cast<double>(config.truthStep);
+        }
+
+        OrbitSample sat = orbitSampleFromState(truth);
+        sat.time = time;
+
+        for (std::size_t j = 0; j < stations.size(); ++j)
+        {
+            Predicted p = predict(sat, stationAt(stations[j], time));
+            if (p.elevation < stations[j].minElevation) { continue; }
+
+            TrackingObservation obs;
+            obs.time = time;
+            obs.station = static_cast<int>(j);
+            obs.range = p.range + config.sigmas.range * noise.normal();
+            obs.rangeRate = p.rangeRate + config.sigmas.rangeRate * noise.normal();
+            obs.azimuth = p.azimuth + config.sigmas.angle * noise.normal();
+            obs.elevation = p.elevation + config.sigmas.angle * noise.normal();
+            observations.push_back(obs);
+        }
+    }
+    return observations;
+}
+
+OdSolution estimateInitialState(const OrbitSample& initialGuess,
+                                const std::vector<TrackingObservation>& unsorted,
+                                const std::vector<GroundStation>& stations,
+                                const OdConfig& config)
+{
+    std::vector<TrackingObservation> observations = unsorted;
+    std::stable_sort(observations.begin(), observations.end(),
+                     [](const TrackingObservation& a, const TrackingObservation& b) { return a.time < b.time; });
+
+    const std::size_t chunkSize { std::max<std::size_t>(1, config.chunkSize) };
+    const std::size_t chunks { (observations.size() + chunkSize - 1) / chunkSize };
+    unsigned int threads = resolveThreadCount(config.threads);
+
+    // Weak prior keeps the first iterations well posed when tracking is sparse
+    StateMatrix priorInfo;
+    for (int i = 0; i < 3; ++i)
+    {
+        priorInfo(i, i) = 1.0 / (config.aprioriPositionSigma * config.aprioriPositionSigma);
+        priorInfo(i + 3, i + 3) = 1.0 / (config.aprioriVelocitySigma * config.aprioriVelocitySigma);
+    }
+    const StateVector prior = toStateVector(initialGuess);
+
+    OdSolution solution;
+    solution.estimate = initialGuess;
+
+    // The reference trajectory steps on a fixed grid from the epoch, so where the chunks
+    // split it does not change the result
+    const double epoch { initialGuess.time };
+    auto stepBefore = [&](double time) {
+        return epoch + std::max(0.0, std::floor((time - epoch) / config.step + 1e-9)) * config.step;
+    };
+
+    std::vector<OrbitSample> boundaries(chunks);
+    std::vector<ChunkNormals> normals(chunks);
+
+    for (int iter = 0; iter < config.maxIterations && !solution.converged; ++iter)
+    {
+        // Reference trajectory to each chunk boundary; plain propagation, no STM. The
+        // first chunk starts at the epoch so its coordinates are the estimated state.
+        // Later boundaries sit on the whole step before the chunk's first observation.
+        OrbitSample s = solution.estimate;
+        for (std::size_t c = 0; c < chunks; ++c)
+        {
+            if (c > 0) { propagateOrbitMetersTo(s, stepBefore(observations[c * chunkSize].time), config.step); }
+            boundaries[c] = s;
+        }
+
+        parallelFor(chunks, threads, [&](std::size_t c, unsigned int) {
+            ChunkNormals acc;
+            StmPropagator propagator(boundaries[c]);
+
+            std::size_t end { std::min(observations.size(), (c + 1) * chunkSize) };
+            for (std::size_t k = c * chunkSize; k < end; ++k)
+            {
+                // The reference only ever takes whole steps; an observation between two is
+                // reached by a partial step on a copy
+                const TrackingObservation& obs = observations[k];
+                propagator.propagateTo(stepBefore(obs.time), config.step);
+                StmPropagator atObservation = propagator;
+                atObservation.propagateTo(obs.time, config.step);
+                const StateMatrix& phi = atObservation.getStm();
+
+                Predicted p = predict(atObservation.getState(), stationAt(stations[static_cast<std::size_t>(obs.station)], obs.time));
+
+                if (config.useRange)
+                {
+                    double r { obs.range - p.range };
+                    acc.add(p.dRange * phi, r, config.sigmas.range);
+                    acc.rangeSq += r * r;
+                    ++acc.rangeCount;
+                }
+                if (config.useRangeRate)
+                {
+                    double r { obs.rangeRate - p.rangeRate };
+                    acc.add(p.dRangeRate * phi, r, config.sigmas.rangeRate);
+                    acc.rangeRateSq += r * r;
+                    ++acc.rangeRateCount;
+                }
+                if (config.useAngles)
+                {
+                    double r { obs.elevation - p.elevation };
+                    acc.add(p.dElevation * phi, r, config.sigmas.angle);
+                    acc.angleSq += r * r;
+                    ++acc.angleCount;
+
+                    if (p.azimuthValid)
+                    {
+                        double ra { std::remainder(obs.azimuth - p.azimuth, glm::two_pi<double>()) };
+                        acc.add(p.dAzimuth * phi, ra, config.sigmas.angle);
+                        acc.angleSq += ra * ra;
+                        ++acc.angleCount;
+                    }
+                }
+            }
+
+            if (c + 1 < chunks)
+            {
+                propagator.propagateTo(boundaries[c + 1].time, config.step);
+                acc.toNextBoundary = propagator.getStm();
+            }
+            normals[c] = acc;
+        });
+
+        // Map every chunk back to the epoch: Phi(t_c, t0) is the chain of boundary STMs
+        StateMatrix lambda = priorInfo;
+        StateVector rhs = priorInfo * (prior - toStateVector(solution.estimate));
+        StateMatrix toBoundary = StateMatrix::identity();
+        double rangeSq { 0.0 }, rangeRateSq { 0.0 }, angleSq { 0.0 };
+        std::size_t rangeCount { 0 }, rangeRateCount { 0 }, angleCount { 0 };
+        for (const ChunkNormals& n : normals)
+        {
+            StateMatrix phiT = toBoundary.transposed();
+            lambda += phiT * n.lambda * toBoundary;
+            rhs += phiT * n.rhs;
+            toBoundary = n.toNextBoundary * toBoundary;
+
+            rangeSq += n.rangeSq; rangeRateSq += n.rangeRateSq; angleSq += n.angleSq;
+            rangeCount += n.rangeCount; rangeRateCount += n.rangeRateCount; angleCount += n.angleCount;
+        }
+        symmetrize(lambda);
+
+        StateVector correction = rhs;
+        if (!choleskySolve(lambda, correction)) { break; }
+
+        solution.estimate.pos += glm::dvec3(correction(0, 0), correction(1, 0), correction(2, 0));
+        solution.estimate.vel += glm::dvec3(correction(3, 0), correction(4, 0), correction(5, 0));
+
+        StateMatrix covariance = StateMatrix::identity();
+        choleskySolve(lambda, covariance);
+        solution.covariance = covariance;
+
+        solution.iterations = iter + 1;
+        solution.measurements = rangeCount + rangeRateCount + angleCount;
+        solution.rmsRange = rms(rangeSq, rangeCount);
+        solution.rmsRangeRate = rms(rangeRateSq, rangeRateCount);
+        solution.rmsAngle = rms(angleSq, angleCount);
+
+        double positionCorrection { std::sqrt(correction(0, 0) * correction(0, 0) + correction(1, 0) * correction(1, 0)
+                                              + correction(2, 0) * correction(2, 0)) };
+        solution.converged = positionCorrection < config.convergence;
+    }
+    return solution;
+}
+
+void printOdSolution(const OdSolution& solution, const OrbitSample* truth, std::ostream& out)
+{
+    auto sigma = [&solution](int i) { return std::sqrt(std::max(0.0, solution.covariance(i, i))); };
+
+    out << std::setprecision(6);
+    out << "Orbit determination: " << (solution.converged ? "converged" : "NOT converged") << " after "
+        << solution.iterations << " iterations, " << solution.measurements << " measurements\n";
+    out << "  residual RMS: range " << solution.rmsRange << " m, range rate " << solution.rmsRangeRate
+        << " m/s, angles " << glm::degrees(solution.rmsAngle) << " deg\n";
+    out << "  formal sigma: position " << glm::length(glm::dvec3(sigma(0), sigma(1), sigma(2)))
+        << " m, velocity " << glm::length(glm::dvec3(sigma(3), sigma(4), sigma(5))) << " m/s\n";
+    if (truth)
+    {
+        out << "  error vs truth: position " << glm::length(solution.estimate.pos - truth->pos)
+            << " m, velocity " << glm::length(solution.estimate.vel - truth->vel) << " m/s\n";
+    }
+}
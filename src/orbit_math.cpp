@@ -0,0 +1,251 @@
+#include "orbit_math.h"
+#include "environment.h"
+#include "simulation_state.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double CIRCULAR_ECCENTRICITY { 1.0e-10 };
+
+    // Inertial equatorial basis: x is world +Z (perpendicular to the tilted spin axis)
+    struct EquatorialBasis
+    {
+        glm::dvec3 x;
+        glm::dvec3 y;
+        glm::dvec3 z;
+    };
+
+    const EquatorialBasis& equatorialBasis()
+    {
+        static const EquatorialBasis basis = [] {
+            EquatorialBasis b;
+            b.z = glm::normalize(glm::dvec3(earthSpinAxis()));
+            b.x = glm::dvec3(0.0, 0.0, 1.0);
+            b.y = glm::cross(b.z, b.x);
+            return b;
+        }();
+        return basis;
+    }
+
+    double signedAngle(const glm::dvec3& from, const glm::dvec3& to, const glm::dvec3& axis)
+    {
+        return std::atan2(glm::dot(glm::cross(from, to), axis), glm::dot(from, to));
+    }
+}
+
+OrbitSample orbitSampleFromState(const SimulationState& state)
+{
+    OrbitSample s;
+    s.time = state.simElapsedTime;
+    s.pos = glm::dvec3(state.cubesatPos) / static_cast<double>(SCALE_FACTOR);
+    s.vel = glm::dvec3(state.cubesatVel);
+    return s;
+}
+
+glm::dvec3 gravityAcceleration(const glm::dvec3& pos)
+{
+    double r { glm::length(pos) };
+    return -Orbit::EARTH_MU / (r * r * r) * pos;
+}
+
+void propagateOrbitMeters(OrbitSample& sample, double dt)
+{
+    glm::dvec3 accel0 = gravityAcceleration(sample.pos);
+    sample.pos += sample.vel * dt + 0.5 * accel0 * dt * dt;
+    glm::dvec3 accel1 = gravityAcceleration(sample.pos);
+    sample.vel += 0.5 * (accel0 + accel1) * dt;
+    sample.time += dt;
+}
+
+double nextStepTo(double from, double time, double dt)
+{
+    double remaining { time - from };
+    if (remaining <= 1e-9 * dt) { return 0.0; }
+    return (remaining < 1.5 * dt) ? remaining : dt;
+}
+
+void propagateOrbitMetersTo(OrbitSample& sample, double time, double dt)
+{
+    for (double h = nextStepTo(sample.time, time, dt); h > 0.0; h = nextStepTo(sample.time, time, dt))
+        propagateOrbitMeters(sample, h);
+}
+
+OrbitalElements stateToElements(const OrbitSample& sample)
+{
+    const EquatorialBasis& eq = equatorialBasis();
+    const double mu { Orbit::EARTH_MU };
+
+    double r { glm::length(sample.pos) };
+    double v2 { glm::dot(sample.vel, sample.vel) };
+    glm::dvec3 h = glm::cross(sample.pos, sample.vel);
+    glm::dvec3 hHat = glm::normalize(h);
+    glm::dvec3 eVec = ((v2 - mu / r) * sample.pos - glm::dot(sample.pos, sample.vel) * sample.vel) / mu;
+
+    OrbitalElements el;
+    el.semiMajorAxis = 1.0 / (2.0 / r - v2 / mu);
+    el.eccentricity = glm::length(eVec);
+    el.inclination = std::acos(glm::clamp(glm::dot(hHat, eq.z), -1.0, 1.0));
+
+    // Equatorial orbits have no node; measure from the equatorial x axis instead
+    glm::dvec3 node = glm::cross(eq.z, h);
+    glm::dvec3 nodeHat = (glm::length(node) > 1e-12 * glm::length(h)) ? glm::normalize(node) : eq.x;
+    el.raan = std::atan2(glm::dot(nodeHat, eq.y), glm::dot(nodeHat, eq.x));
+
+    glm::dvec3 periapsisHat = nodeHat;
+    if (el.eccentricity > CIRCULAR_ECCENTRICITY)
+    {
+        periapsisHat = eVec / el.eccentricity;
+        el.argPeriapsis = signedAngle(nodeHat, periapsisHat, hHat);
+    }
+    el.trueAnomaly = signedAngle(periapsisHat, sample.pos / r, hHat);
+    return el;
+}
+
+OrbitSample elementsToState(const OrbitalElements& el, double time)
+{
+    const EquatorialBasis& eq = equatorialBasis();
+
+    double p { el.semiMajorAxis * (1.0 - el.eccentricity * el.eccentricity) };
+    double r { p / (1.0 + el.eccentricity * std::cos(el.trueAnomaly)) };
+    double vScale { std::sqrt(Orbit::EARTH_MU / p) };
+
+    // Perifocal frame expressed in equatorial coordinates (z-x-z rotation by raan, i, argp)
+    double cO { std::cos(el.raan) }, sO { std::sin(el.raan) };
+    double ci { std::cos(el.inclination) }, si { std::sin(el.inclination) };
+    double cw { std::cos(el.argPeriapsis) }, sw { std::sin(el.argPeriapsis) };
+
+    glm::dvec3 pEq(cO * cw - sO * sw * ci, sO * cw + cO * sw * ci, sw * si);
+    glm::dvec3 qEq(-cO * sw - sO * cw * ci, -sO * sw + cO * cw * ci, cw * si);
+
+    auto toWorld = [&eq](const glm::dvec3& v) { return v.x * eq.x + v.y * eq.y + v.z * eq.z; };
+    glm::dvec3 pHat = toWorld(pEq);
+    glm::dvec3 qHat = toWorld(qEq);
+
+    double cv { std::cos(el.trueAnomaly) }, sv { std::sin(el.trueAnomaly) };
+
+    OrbitSample s;
+    s.time = time;
+    s.pos = r * (cv * pHat + sv * qHat);
+    s.vel = vScale * (-sv * pHat + (el.eccentricity + cv) * qHat);
+    return s;
+}
+
+std::vector<OrbitSample> spreadConstellation(const OrbitalElements& nominal, int satellites, double time)
+{
+    int planes = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(satellites))));
+    int perPlane = (satellites + planes - 1) / planes;
+
+    std::vector<OrbitSample> constellation;
+    constellation.reserve(static_cast<std::size_t>(std::max(0, satellites)));
+    for (int i = 0; i < satellites; ++i)
+    {
+        OrbitalElements el = nominal;
+        el.raan += 6.283185307179586 * (i % planes) / planes;
+        el.trueAnomaly += 6.283185307179586 * (i / planes) / perPlane;
+        constellation.push_back(elementsToState(el, time));
+    }
+    return constellation;
+}
+
+KeplerPropagator::KeplerPropagator(const OrbitSample& epoch)
+    : m_epochTime { epoch.time }
+{
+    const double mu { Orbit::EARTH_MU };
+
+    double r { glm::length(epoch.pos) };
+    double v2 { glm::dot(epoch.vel, epoch.vel) };
+    double rv { glm::dot(epoch.pos, epoch.vel) };
+    glm::dvec3 hHat = glm::normalize(glm::cross(epoch.pos, epoch.vel));
+    glm::dvec3 eVec = ((v2 - mu / r) * epoch.pos - rv * epoch.vel) / mu;
+
+    m_a = 1.0 / (2.0 / r - v2 / mu);
+    m_e = glm::length(eVec);
+    m_meanMotion = std::sqrt(mu / (m_a * m_a * m_a));
+
+    if (m_e > CIRCULAR_ECCENTRICITY)
+    {
+        m_p = eVec / m_e;
+        // E from e*cos(E) = 1 - r/a and e*sin(E) = r.v / sqrt(mu*a)
+        double e0 { std::atan2(rv / std::sqrt(mu * m_a), 1.0 - r / m_a) };
+        m_meanAnomalyAtEpoch = e0 - m_e * std::sin(e0);
+    }
+    else
+    {
+        m_e = 0.0;
+        m_p = epoch.pos / r;
+        m_meanAnomalyAtEpoch = 0.0;
+    }
+    m_q = glm::cross(hHat, m_p);
+}
+
+double KeplerPropagator::eccentricAnomaly(double time) const
+{
+    double m { m_meanAnomalyAtEpoch + m_meanMotion * (time - m_epochTime) };
+    m = std::remainder(m, 6.283185307179586);
+
+    // Newton on Kepler's equation; starting at pi for high e keeps it monotone
+    double e { (m_e < 0.8) ? m : 3.141592653589793 };
+    for (int i = 0; i < 20; ++i)
+    {
+        double f { e - m_e * std::sin(e) - m };
+        double step { f / (1.0 - m_e * std::cos(e)) };
+        e -= step;
+        if (std::abs(step) < 1e-13) { break; }
+    }
+    return e;
+}
+
+glm::dvec3 KeplerPropagator::position(double time) const
+{
+    double e { eccentricAnomaly(time) };
+    double b { m_a * std::sqrt(1.0 - m_e * m_e) };
+    return m_a * (std::cos(e) - m_e) * m_p + b * std::sin(e) * m_q;
+}
+
+OrbitSample KeplerPropagator::state(double time) const
+{
+    double e { eccentricAnomaly(time) };
+    double cE { std::cos(e) };
+    double sE { std::sin(e) };
+    double b { m_a * std::sqrt(1.0 - m_e * m_e) };
+    double eDot { m_meanMotion / (1.0 - m_e * cE) };
+
+    OrbitSample s;
+    s.time = time;
+    s.pos = m_a * (cE - m_e) * m_p + b * sE * m_q;
+    s.vel = eDot * (-m_a * sE * m_p + b * cE * m_q);
+    return s;
+}
+
+double KeplerPropagator::getPeriod() const { return 6.283185307179586 / m_meanMotion; }
+
+glm::dvec3 inertialToEarthFixed(const glm::dvec3& pos, double time)
+{
+    const EquatorialBasis& eq = equatorialBasis();
+    double theta { Orbit::EARTH_ROTATION_RATE * time };
+    double c { std::cos(theta) }, s { std::sin(theta) };
+
+    double x { glm::dot(pos, eq.x) };
+    double y { glm::dot(pos, eq.y) };
+    return glm::dvec3(c * x + s * y, -s * x + c * y, glm::dot(pos, eq.z));
+}
+
+glm::dvec3 earthFixedToInertial(const glm::dvec3& pos, double time)
+{
+    const EquatorialBasis& eq = equatorialBasis();
+    double theta { Orbit::EARTH_ROTATION_RATE * time };
+    double c { std::cos(theta) }, s { std::sin(theta) };
+
+    double x { c * pos.x - s * pos.y };
+    double y { s * pos.x + c * pos.y };
+    return x * eq.x + y * eq.y + pos.z * eq.z;
+}
+
+glm::dvec3 geodeticToEarthFixed(double latitude, double longitude, double altitude)
+{
+    double r { Orbit::EARTH_RADIUS + altitude };
+    double cl { std::cos(latitude) };
+    return glm::dvec3(r * cl * std::cos(longitude), r * cl * std::sin(longitude), r * std::sin(latitude));
+}
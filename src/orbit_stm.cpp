@@ -0,0 +1,151 @@
+#include "orbit_stm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+StateVector toStateVector(const OrbitSample& sample)
+{
+    StateVector x;
+    for (int i = 0; i < 3; ++i)
+    {
+        x(i, 0) = sample.pos[i];
+        x(i + 3, 0) = sample.vel[i];
+    }
+    return x;
+}
+
+Matrix<3, 3> gravityGradient(const glm::dvec3& pos)
+{
+    double r2 { glm::dot(pos, pos) };
+    double r { std::sqrt(r2) };
+    double k { Orbit::EARTH_MU / (r2 * r) };
+
+    // mu/r^3 * (3 r r^T / r^2 - I)
+    Matrix<3, 3> g;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            g(i, j) = k * (3.0 * pos[i] * pos[j] / r2 - (i == j ? 1.0 : 0.0));
+    return g;
+}
+
+namespace
+{
+    struct TangentBlocks
+    {
+        Matrix<3, 3> drdr;
+        Matrix<3, 3> dvdr;
+        Matrix<3, 3> dvdv;
+        double drdv; // Times identity
+    };
+
+    // r1 = r0 + v0 dt + a(r0) dt^2/2,  v1 = v0 + (a(r0) + a(r1)) dt/2
+    TangentBlocks verletTangentBlocks(const Matrix<3, 3>& g0, const Matrix<3, 3>& g1, double dt)
+    {
+        const Matrix<3, 3> eye = Matrix<3, 3>::identity();
+        TangentBlocks t;
+        t.drdr = eye + (0.5 * dt * dt) * g0;
+        t.drdv = dt;
+        t.dvdr = (0.5 * dt) * (g0 + g1 * t.drdr);
+        t.dvdv = eye + (0.5 * dt * dt) * g1;
+        return t;
+    }
+}
+
+StateMatrix verletTangentMap(const glm::dvec3& pos0, const glm::dvec3& pos1, double dt)
+{
+    TangentBlocks t = verletTangentBlocks(gravityGradient(pos0), gravityGradient(pos1), dt);
+
+    StateMatrix phi;
+    phi.setBlock(0, 0, t.drdr);
+    phi.setBlock(0, 3, t.drdv * Matrix<3, 3>::identity());
+    phi.setBlock(3, 0, t.dvdr);
+    phi.setBlock(3, 3, t.dvdv);
+    return phi;
+}
+
+StmPropagator::StmPropagator(const OrbitSample& epoch, int stmInterval)
+    : m_state { epoch }, m_blockStartGradient { gravityGradient(epoch.pos) },
+      m_stmInterval { std::max(1, stmInterval) }
+{
+}
+
+void StmPropagator::step(double dt)
+{
+    propagateOrbitMeters(m_state, dt);
+    m_blockTime += dt;
+    if (++m_stepsInBlock >= m_stmInterval) { syncStm(); }
+}
+
+void StmPropagator::propagateTo(double time, double dt)
+{
+    for (double h = nextStepTo(m_state.time, time, dt); h > 0.0; h = nextStepTo(m_state.time, time, dt))
+        step(h);
+    syncStm();
+}
+
+void StmPropagator::syncStm()
+{
+    if (m_stepsInBlock == 0) { return; }
+
+    // The end gradient is the next block's start gradient, so each block costs one
+    Matrix<3, 3> endGradient = gravityGradient(m_state.pos);
+    TangentBlocks t = verletTangentBlocks(m_blockStartGradient, endGradient, m_blockTime);
+
+    // Phi * STM using the structure of Phi (the position/velocity block is a multiple of I)
+    Matrix<3, 6> top = m_stm.block<3, 6>(0, 0);
+    Matrix<3, 6> bottom = m_stm.block<3, 6>(3, 0);
+    m_stm.setBlock(0, 0, t.drdr * top + t.drdv * bottom);
+    m_stm.setBlock(3, 0, t.dvdr * top + t.dvdv * bottom);
+
+    m_blockStartGradient = endGradient;
+    m_blockTime = 0.0;
+    m_stepsInBlock = 0;
+}
+
+const OrbitSample& StmPropagator::getState() const { return m_state; }
+
+const StateMatrix& StmPropagator::getStm() const { return m_stm; }
+
+int StmPropagator::getStmInterval() const { return m_stmInterval; }
+
+std::vector<CovarianceSample> propagateCovariance(const OrbitSample& epoch, const StateMatrix& initialCovariance,
+                                                  const std::vector<double>& epochs, double dt,
+                                                  int stmInterval)
+{
+    std::vector<CovarianceSample> samples;
+    StmPropagator propagator(epoch, stmInterval);
+
+    for (double target : epochs)
+    {
+        propagator.propagateTo(target, dt);
+
+        const StateMatrix& phi = propagator.getStm();
+        StateMatrix p = phi * initialCovariance * phi.transposed();
+        symmetrize(p);
+
+        samples.push_back({ target, propagator.getState(), p });
+    }
+    return samples;
+}
+
+void writeCovarianceCsv(std::ostream& out, const std::vector<CovarianceSample>& samples)
+{
+    out << "time_s,sigma_x_m,sigma_y_m,sigma_z_m,sigma_vx_mps,sigma_vy_mps,sigma_vz_mps";
+    for (int r = 0; r < 6; ++r)
+        for (int c = r; c < 6; ++c)
+            out << ",p" << r + 1 << c + 1;
+    out << '\n';
+
+    for (const CovarianceSample& s : samples)
+    {
+        out << std::fixed << std::setprecision(3) << s.time;
+        out << std::scientific << std::setprecision(9);
+        for (int i = 0; i < 6; ++i)
+            out << ',' << std::sqrt(std::max(0.0, s.covariance(i, i)));
+        for (int r = 0; r < 6; ++r)
+            for (int c = r; c < 6; ++c)
+                out << ',' << s.covariance(r, c);
+        out << '\n';
+    }
+}
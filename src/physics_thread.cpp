@@ -0,0 +1,97 @@
+#include "physics_thread.h"
+#include "constants.h"
+#include "functions_main.h"
+#include "profiler.h"
+#include "simulation_state.h"
+#include "telecommand.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    // Sleep while paused by a telecommand, between looks for the command that resumes
+    constexpr std::chrono::milliseconds HELD_POLL { 1 };
+}
+
+PhysicsThread::PhysicsThread(SimulationState& state, float simSpeed, int subSteps, std::function<void()> afterStep)
+    : m_state { state }, m_simSpeed { simSpeed }, m_subSteps { std::max(1, subSteps) },
+      m_afterStep { std::move(afterStep) }, m_snapshots { makeTelemetryFrame(state) }
+{
+}
+
+PhysicsThread::~PhysicsThread()
+{
+    stop();
+}
+
+void PhysicsThread::start()
+{
+    if (m_running.exchange(true)) { return; }
+    m_thread = std::thread(&PhysicsThread::run, this);
+}
+
+void PhysicsThread::stop()
+{
+    m_running.store(false);
+    if (m_thread.joinable()) { m_thread.join(); }
+}
+
+bool PhysicsThread::update() { return m_snapshots.update(); }
+
+const TelemetryFrame& PhysicsThread::latest() const { return m_snapshots.front(); }
+
+std::uint64_t PhysicsThread::getSteps() const { return m_steps.load(std::memory_order_relaxed); }
+
+std::uint64_t PhysicsThread::getDroppedBacklogs() const { return m_droppedBacklogs.load(std::memory_order_relaxed); }
+
+float PhysicsThread::currentSpeed() const
+{
+    return m_state.telecommands ? m_state.telecommands->getControl().simSpeed : m_simSpeed;
+}
+
+void PhysicsThread::run()
+{
+    setProfileThreadName("physics");
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point last = Clock::now();
+    double owed { 0.0 }; // s of simulated time the wall clock is ahead by
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        Clock::time_point now = Clock::now();
+        float speed { currentSpeed() };
+        float step { speed / (NOMINAL_FRAME_RATE * static_cast<float>(m_subSteps)) };
+
+        owed += std::chrono::duration<double>(now - last).count() * speed;
+        last = now;
+        if (owed > MAX_DELTA_TIME * speed)
+        {
+            owed = 0.0;
+            m_droppedBacklogs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (owed < step)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>((step - owed) / speed));
+            continue;
+        }
+
+        for (; owed >= step && m_running.load(std::memory_order_relaxed); owed -= step)
+        {
+            if (stepSimulation(m_state, step, 1) == 0)
+            {
+                // Held by a telecommand: nothing to publish, and no debt to run off later
+                owed = 0.0;
+                std::this_thread::sleep_for(HELD_POLL);
+                break;
+            }
+
+            m_snapshots.back() = makeTelemetryFrame(m_state);
+            m_snapshots.publish();
+            m_steps.fetch_add(1, std::memory_order_relaxed);
+            if (m_afterStep) { m_afterStep(); }
+        }
+    }
+}
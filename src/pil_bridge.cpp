@@ -0,0 +1,242 @@
+#include "pil_bridge.h"
+#include "simulation_state.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+PilBridge::PilBridge(std::string socketPath, PilSyncMode mode, float controlRate, int timeoutMs)
+    : m_socketPath { std::move(socketPath) }, m_mode { mode }, m_controlRate { controlRate },
+      m_timeoutMs { timeoutMs }
+{
+    // First update exchanges immediately
+    m_cycleAccum = (m_controlRate > 0.0f) ? 1.0f / m_controlRate : 0.0f;
+}
+
+PilBridge::~PilBridge()
+{
+    close();
+}
+
+bool PilBridge::open()
+{
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (m_socketPath.size() >= sizeof(addr.sun_path))
+    {
+        std::cerr << "PIL socket path too long: " << m_socketPath << '\n';
+        return false;
+    }
+    std::strncpy(addr.sun_path, m_socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0)
+    {
+        std::cerr << "PIL socket() failed: " << std::strerror(errno) << '\n';
+        return false;
+    }
+
+    ::unlink(m_socketPath.c_str());
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || ::listen(m_listenFd, 1) < 0)
+    {
+        std::cerr << "PIL bind/listen on " << m_socketPath << " failed: " << std::strerror(errno) << '\n';
+        close();
+        return false;
+    }
+
+    std::cout << "Waiting for flight software on " << m_socketPath << " ...\n";
+    m_fd = ::accept(m_listenFd, nullptr, nullptr);
+    if (m_fd < 0)
+    {
+        std::cerr << "PIL accept() failed: " << std::strerror(errno) << '\n';
+        close();
+        return false;
+    }
+
+    std::cout << "Flight software connected ("
+              << (m_mode == PilSyncMode::LOCKSTEP ? "lockstep" : "free-running") << ")\n";
+    return true;
+}
+
+void PilBridge::close()
+{
+    if (m_fd >= 0) { ::close(m_fd); }
+    if (m_listenFd >= 0)
+    {
+        ::close(m_listenFd);
+        ::unlink(m_socketPath.c_str());
+    }
+    m_fd = -1;
+    m_listenFd = -1;
+}
+
+bool PilBridge::isConnected() const { return m_fd >= 0; }
+
+PilSensorPacket PilBridge::buildPacket(const SimulationState& state) const
+{
+    const SensorReadings& readings = state.sensors.getReadings();
+
+    PilSensorPacket packet {};
+    packet.magic = PIL_SENSOR_MAGIC;
+    packet.sequence = m_sequence;
+    packet.simTime = state.simElapsedTime;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        packet.gyro[i] = readings.gyro.value[i];
+        packet.sunVector[i] = readings.sunVector.value[i];
+        packet.magField[i] = readings.magField.value[i];
+        packet.wheelSpeed[i] = state.wheels.getWheelAngularVelocity(i);
+    }
+
+    const glm::quat& q = readings.starTracker.value;
+    packet.starTracker[0] = q.w;
+    packet.starTracker[1] = q.x;
+    packet.starTracker[2] = q.y;
+    packet.starTracker[3] = q.z;
+
+    packet.validFlags = (readings.gyro.valid ? PIL_VALID_GYRO : 0)
+                      | (readings.starTracker.valid ? PIL_VALID_STAR_TRACKER : 0)
+                      | (readings.sunVector.valid ? PIL_VALID_SUN : 0)
+                      | (readings.magField.valid ? PIL_VALID_MAG : 0);
+    return packet;
+}
+
+bool PilBridge::sendAll(const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    while (size > 0)
+    {
+        ssize_t n = ::send(m_fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Drains whatever replies are available. With a timeout, keeps waiting until the
+// reply to `waitFor` arrives or the timeout expires.
+bool PilBridge::receiveReplies(int timeoutMs, std::uint32_t waitFor)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while (true)
+    {
+        int remainingMs { 0 };
+        if (timeoutMs > 0)
+        {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            remainingMs = static_cast<int>(std::max<long long>(left, 0));
+        }
+
+        pollfd pfd { m_fd, POLLIN, 0 };
+        int ready = ::poll(&pfd, 1, remainingMs);
+        if (ready < 0 && errno == EINTR) { continue; }
+        if (ready <= 0) { return false; }
+
+        ssize_t n = ::recv(m_fd, m_rxBuffer.data() + m_rxFill, m_rxBuffer.size() - m_rxFill, 0);
+        if (n <= 0)
+        {
+            std::cerr << "PIL link closed by flight software\n";
+            close();
+            return false;
+        }
+        m_rxFill += static_cast<std::size_t>(n);
+
+        bool gotTarget { false };
+        std::size_t offset { 0 };
+        while (m_rxFill - offset >= sizeof(PilActuatorPacket))
+        {
+            // A stream out of step with the packet boundaries is resynchronised by
+            // sliding a byte at a time to the next magic
+            std::uint32_t magic { 0 };
+            std::memcpy(&magic, m_rxBuffer.data() + offset, sizeof(magic));
+            if (magic != PIL_ACTUATOR_MAGIC)
+            {
+                ++offset;
+                continue;
+            }
+
+            PilActuatorPacket reply;
+            std::memcpy(&reply, m_rxBuffer.data() + offset, sizeof(reply));
+            offset += sizeof(reply);
+
+            if (applyReply(reply) && reply.sequence == waitFor) { gotTarget = true; }
+        }
+        std::memmove(m_rxBuffer.data(), m_rxBuffer.data() + offset, m_rxFill - offset);
+        m_rxFill -= offset;
+
+        if (gotTarget || timeoutMs == 0) { return gotTarget; }
+    }
+}
+
+bool PilBridge::applyReply(const PilActuatorPacket& reply)
+{
+    // Only a reply to a packet sent after the last one applied can carry a newer command
+    if (reply.sequence <= m_lastReplySequence || reply.sequence > m_sequence) { return false; }
+
+    if (m_sequence - reply.sequence < static_cast<std::uint32_t>(SEND_HISTORY))
+    {
+        auto sent = m_sendTimes[reply.sequence % SEND_HISTORY];
+        m_latencyUs.add(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        m_command.wheelTorque[i] = std::isfinite(reply.wheelTorque[i]) ? reply.wheelTorque[i] : 0.0f;
+        m_command.dipole[i] = std::isfinite(reply.dipole[i]) ? reply.dipole[i] : 0.0f;
+    }
+    m_lastReplySequence = reply.sequence;
+    return true;
+}
+
+const ActuatorCommand& PilBridge::update(const SimulationState& state, float dt)
+{
+    if (!isConnected()) { return m_command; }
+
+    m_cycleAccum += dt;
+    float period = (m_controlRate > 0.0f) ? 1.0f / m_controlRate : 0.0f;
+    if (m_cycleAccum < period) { return m_command; }
+    m_cycleAccum = (period > 0.0f) ? std::fmod(m_cycleAccum, period) : 0.0f;
+
+    ++m_sequence;
+    PilSensorPacket packet = buildPacket(state);
+    m_sendTimes[m_sequence % SEND_HISTORY] = std::chrono::steady_clock::now();
+    if (!sendAll(&packet, sizeof(packet)))
+    {
+        std::cerr << "PIL send failed: " << std::strerror(errno) << '\n';
+        close();
+        return m_command;
+    }
+
+    if (m_mode == PilSyncMode::LOCKSTEP)
+    {
+        if (!receiveReplies(m_timeoutMs, m_sequence)) { ++m_timeouts; }
+    }
+    else
+    {
+        receiveReplies(0, m_sequence);
+        if (m_lastReplySequence + 1 < m_sequence) { ++m_staleCycles; }
+    }
+
+    return m_command;
+}
+
+const StreamingStats& PilBridge::getLatencyStats() const { return m_latencyUs; }
+
+std::uint64_t PilBridge::getTimeouts() const { return m_timeouts; }
+
+std::uint64_t PilBridge::getStaleCycles() const { return m_staleCycles; }
@@ -0,0 +1,73 @@
+#include "png_writer.h"
+
+#include <zlib.h>
+
+#include <fstream>
+
+namespace
+{
+    void putBigEndian(std::vector<std::uint8_t>& out, std::uint32_t v)
+    {
+        out.push_back(static_cast<std::uint8_t>(v >> 24));
+        out.push_back(static_cast<std::uint8_t>(v >> 16));
+        out.push_back(static_cast<std::uint8_t>(v >> 8));
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    // Length, type, data, then a CRC over type and data
+    void writeChunk(std::ofstream& out, const char type[4], const std::vector<std::uint8_t>& data)
+    {
+        std::vector<std::uint8_t> header;
+        putBigEndian(header, static_cast<std::uint32_t>(data.size()));
+        header.insert(header.end(), type, type + 4);
+
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+        if (!data.empty()) { crc = crc32(crc, data.data(), static_cast<uInt>(data.size())); }
+
+        std::vector<std::uint8_t> trailer;
+        putBigEndian(trailer, static_cast<std::uint32_t>(crc));
+
+        out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        out.write(reinterpret_cast<const char*>(trailer.data()), static_cast<std::streamsize>(trailer.size()));
+    }
+}
+
+bool writePngRgb(const std::string& path, int width, int height, const std::vector<std::uint8_t>& rgb)
+{
+    const std::size_t stride { static_cast<std::size_t>(width) * 3 };
+    if (width <= 0 || height <= 0 || rgb.size() < stride * static_cast<std::size_t>(height)) { return false; }
+
+    // Every scanline is prefixed with filter type 0 (none)
+    std::vector<std::uint8_t> raw;
+    raw.reserve((stride + 1) * static_cast<std::size_t>(height));
+    for (int y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        auto row = rgb.begin() + static_cast<std::ptrdiff_t>(stride * static_cast<std::size_t>(y));
+        raw.insert(raw.end(), row, row + static_cast<std::ptrdiff_t>(stride));
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<std::uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, raw.data(), static_cast<uLong>(raw.size()),
+                  Z_DEFAULT_COMPRESSION) != Z_OK)
+        return false;
+    compressed.resize(compressedSize);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) { return false; }
+
+    static const std::uint8_t signature[8] { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<std::uint8_t> ihdr;
+    putBigEndian(ihdr, static_cast<std::uint32_t>(width));
+    putBigEndian(ihdr, static_cast<std::uint32_t>(height));
+    ihdr.insert(ihdr.end(), { 8, 2, 0, 0, 0 }); // 8-bit depth, truecolour, deflate, no filter, no interlace
+
+    writeChunk(out, "IHDR", ihdr);
+    writeChunk(out, "IDAT", compressed);
+    writeChunk(out, "IEND", {});
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,193 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Zones are stored in fixed blocks, so a long run grows without copying what it has
+    constexpr std::size_t BLOCK_ZONES { std::size_t { 1 } << 16 };
+
+    struct ZoneEvent
+    {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    struct ThreadBuffer
+    {
+        std::uint32_t id;
+        std::string name;
+        std::vector<std::unique_ptr<ZoneEvent[]>> blocks;
+        std::atomic<std::size_t> count { 0 };
+        std::atomic<std::uint64_t> dropped { 0 };
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> threads; // Outlive their threads
+        std::uint64_t startTicks { 0 };
+        std::uint64_t stopTicks { 0 };
+        std::chrono::steady_clock::time_point startTime;
+        std::chrono::steady_clock::time_point stopTime;
+        bool started { false };
+        bool stopped { false };
+    };
+
+    Registry& registry()
+    {
+        static Registry r;
+        return r;
+    }
+
+    thread_local ThreadBuffer* t_buffer { nullptr };
+    thread_local const char* t_name { nullptr };
+
+    ThreadBuffer& threadBuffer()
+    {
+        if (!t_buffer)
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.threads.push_back(std::make_unique<ThreadBuffer>());
+            t_buffer = r.threads.back().get();
+            t_buffer->id = static_cast<std::uint32_t>(r.threads.size());
+            if (t_name) { t_buffer->name = t_name; }
+        }
+        return *t_buffer;
+    }
+
+    void writeEscaped(std::ostream& out, const std::string& text)
+    {
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\') { out << '\\'; }
+            out << c;
+        }
+    }
+}
+
+void recordProfileZone(const char* name, std::uint64_t start, std::uint64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    std::size_t n { buffer.count.load(std::memory_order_relaxed) };
+    if (n >= MAX_ZONES_PER_THREAD)
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (n % BLOCK_ZONES == 0 && n / BLOCK_ZONES == buffer.blocks.size())
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffer.blocks.push_back(std::make_unique<ZoneEvent[]>(BLOCK_ZONES));
+    }
+
+    buffer.blocks[n / BLOCK_ZONES][n % BLOCK_ZONES] = { name, start, end };
+    buffer.count.store(n + 1, std::memory_order_release);
+}
+
+void startProfiling()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (!PROFILING_COMPILED_IN || r.started) { return; }
+
+    r.started = true;
+    r.startTime = std::chrono::steady_clock::now();
+    r.startTicks = readProfileClock();
+    ProfilerDetail::active.store(true, std::memory_order_relaxed);
+}
+
+void stopProfiling()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (!r.started || r.stopped) { return; }
+
+    ProfilerDetail::active.store(false, std::memory_order_relaxed);
+    r.stopped = true;
+    r.stopTicks = readProfileClock();
+    r.stopTime = std::chrono::steady_clock::now();
+}
+
+void setProfileThreadName(const char* name)
+{
+    t_name = name;
+    if (t_buffer)
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        t_buffer->name = name;
+    }
+}
+
+bool writeChromeTrace(const std::string& path)
+{
+    stopProfiling();
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) { return false; }
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // Clock ticks per microsecond over the whole trace
+    double micros { std::chrono::duration<double, std::micro>(r.stopTime - r.startTime).count() };
+    double ticksPerMicro { (micros > 0.0) ? static_cast<double>(r.stopTicks - r.startTicks) / micros : 1.0 };
+    if (!(ticksPerMicro > 0.0)) { ticksPerMicro = 1.0; }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CubeSatSim\"}}";
+
+    char line[256];
+    for (const std::unique_ptr<ThreadBuffer>& thread : r.threads)
+    {
+        if (!thread->name.empty())
+        {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id
+                << ",\"args\":{\"name\":\"";
+            writeEscaped(out, thread->name);
+            out << "\"}}";
+        }
+
+        std::size_t count { thread->count.load(std::memory_order_acquire) };
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const ZoneEvent& e = thread->blocks[i / BLOCK_ZONES][i % BLOCK_ZONES];
+            double ts { static_cast<double>(static_cast<std::int64_t>(e.start - r.startTicks)) / ticksPerMicro };
+            double dur { static_cast<double>(e.end - e.start) / ticksPerMicro };
+            int n { std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                  e.name, thread->id, ts, dur) };
+            out.write(line, std::min<int>(n, sizeof(line) - 1));
+        }
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+std::uint64_t getProfileZoneCount()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::uint64_t total { 0 };
+    for (const std::unique_ptr<ThreadBuffer>& thread : r.threads)
+        total += thread->count.load(std::memory_order_acquire);
+    return total;
+}
+
+std::uint64_t getProfileZonesDropped()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::uint64_t total { 0 };
+    for (const std::unique_ptr<ThreadBuffer>& thread : r.threads)
+        total += thread->dropped.load(std::memory_order_relaxed);
+    return total;
+}
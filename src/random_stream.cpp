@@ -0,0 +1,127 @@
+#include "random_stream.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr std::uint32_t PHILOX_M0 { 0xD2511F53u };
+    constexpr std::uint32_t PHILOX_M1 { 0xCD9E8D57u };
+    constexpr std::uint32_t PHILOX_W0 { 0x9E3779B9u };
+    constexpr std::uint32_t PHILOX_W1 { 0xBB67AE85u };
+    constexpr int PHILOX_ROUNDS { 10 };
+
+    // Each Philox call yields 4 words, so a block is LANES independent counters
+    constexpr int LANES { RandomStream::BLOCK_SIZE / 4 };
+
+    constexpr float TWO_PI { 6.28318530718f };
+    constexpr float INV_2_24 { 1.0f / 16777216.0f };
+}
+
+RandomStream::RandomStream(std::uint64_t seed, std::uint64_t streamId)
+    : m_seed { seed }, m_streamId { streamId }
+{
+}
+
+// Structure-of-arrays layout: each round is a straight loop over lanes with no
+// cross-lane dependency, which the compiler turns into SIMD multiplies.
+void RandomStream::generateBlock(std::array<std::uint32_t, BLOCK_SIZE>& bits)
+{
+    std::uint32_t x0[LANES], x1[LANES], x2[LANES], x3[LANES];
+    for (int l = 0; l < LANES; ++l)
+    {
+        std::uint64_t ctr = m_counter * LANES + l;
+        x0[l] = static_cast<std::uint32_t>(ctr);
+        x1[l] = static_cast<std::uint32_t>(ctr >> 32);
+        x2[l] = static_cast<std::uint32_t>(m_streamId);
+        x3[l] = static_cast<std::uint32_t>(m_streamId >> 32);
+    }
+
+    std::uint32_t k0 = static_cast<std::uint32_t>(m_seed);
+    std::uint32_t k1 = static_cast<std::uint32_t>(m_seed >> 32);
+
+    for (int round = 0; round < PHILOX_ROUNDS; ++round)
+    {
+        for (int l = 0; l < LANES; ++l)
+        {
+            std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * x0[l];
+            std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * x2[l];
+
+            std::uint32_t y0 = static_cast<std::uint32_t>(p1 >> 32) ^ x1[l] ^ k0;
+            std::uint32_t y1 = static_cast<std::uint32_t>(p1);
+            std::uint32_t y2 = static_cast<std::uint32_t>(p0 >> 32) ^ x3[l] ^ k1;
+            std::uint32_t y3 = static_cast<std::uint32_t>(p0);
+
+            x0[l] = y0; x1[l] = y1; x2[l] = y2; x3[l] = y3;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    for (int l = 0; l < LANES; ++l)
+    {
+        bits[4 * l + 0] = x0[l];
+        bits[4 * l + 1] = x1[l];
+        bits[4 * l + 2] = x2[l];
+        bits[4 * l + 3] = x3[l];
+    }
+
+    ++m_counter;
+}
+
+void RandomStream::refillUniforms()
+{
+    std::array<std::uint32_t, BLOCK_SIZE> bits;
+    generateBlock(bits);
+
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+        m_uniforms[i] = static_cast<float>(bits[i] >> 8) * INV_2_24;
+
+    m_uniformIdx = 0;
+}
+
+// Box-Muller on the whole block at once
+void RandomStream::refillNormals()
+{
+    std::array<std::uint32_t, BLOCK_SIZE> bits;
+    generateBlock(bits);
+
+    for (int i = 0; i < BLOCK_SIZE; i += 2)
+    {
+        float u1 = (static_cast<float>(bits[i] >> 8) + 1.0f) * INV_2_24; // (0, 1]
+        float u2 = static_cast<float>(bits[i + 1] >> 8) * INV_2_24;
+
+        float radius = std::sqrt(-2.0f * std::log(u1));
+        m_normals[i] = radius * std::cos(TWO_PI * u2);
+        m_normals[i + 1] = radius * std::sin(TWO_PI * u2);
+    }
+
+    m_normalIdx = 0;
+}
+
+float RandomStream::uniform()
+{
+    if (m_uniformIdx == BLOCK_SIZE) { refillUniforms(); }
+    return m_uniforms[m_uniformIdx++];
+}
+
+float RandomStream::normal()
+{
+    if (m_normalIdx == BLOCK_SIZE) { refillNormals(); }
+    return m_normals[m_normalIdx++];
+}
+
+void RandomStream::fillUniform(float* out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = uniform();
+}
+
+void RandomStream::fillNormal(float* out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = normal();
+}
+
+std::uint64_t RandomStream::getSeed() const { return m_seed; }
+
+std::uint64_t RandomStream::getStreamId() const { return m_streamId; }
@@ -1,19 +1,18 @@
 #include "reaction_wheel.h"
 #include <glm/glm.hpp>
 
-ReactionWheel::ReactionWheel(glm::vec3 axis, float inertia)
-    : m_axis(glm::normalize(axis)), m_inertia(inertia), m_angularVel(0.0f) {}
+ReactionWheel::ReactionWheel(glm::vec3 axis, float inertia, float maxTorque, float maxSpeed)
+    : m_axis(glm::normalize(axis)), m_inertia(inertia), m_maxTorque(maxTorque), m_maxSpeed(maxSpeed),
+      m_angularVel(0.0f) {}
 
 void ReactionWheel::applyTorque(float torque, float dt)
 {
-    constexpr float maxTorque = 0.00005f; // N*m; value is typical for CubeSat wheels
-    float limitedTorque = glm::clamp(torque, -maxTorque, maxTorque);
+    float limitedTorque = glm::clamp(torque, -m_maxTorque, m_maxTorque);
 
     float angularAcc = limitedTorque / m_inertia;
     m_angularVel += angularAcc * dt;
  
-    constexpr float maxWheelSpeed = 6000.0f * 2.0f * 3.14159f / 60.0f; // 6000 rpm
-    m_angularVel = glm::clamp(m_angularVel, -maxWheelSpeed, maxWheelSpeed);
+    m_angularVel = glm::clamp(m_angularVel, -m_maxSpeed, m_maxSpeed);
 }
 
 void ReactionWheel::update(float dt)
@@ -33,3 +32,9 @@ glm::vec3 ReactionWheel::getAngularMomentum() const
 
 glm::vec3 ReactionWheel::getAxis() const { return m_axis; }
 
+float ReactionWheel::getInertia() const { return m_inertia; }
+
+float ReactionWheel::getMaxTorque() const { return m_maxTorque; }
+
+float ReactionWheel::getMaxSpeed() const { return m_maxSpeed; }
+
@@ -1,10 +1,10 @@
 #include "reaction_wheel_system.h"
 
-ReactionWheelSystem::ReactionWheelSystem()
+ReactionWheelSystem::ReactionWheelSystem(float wheelInertia, float maxTorque, float maxSpeed)
     : m_wheels {
-        ReactionWheel(glm::vec3(1, 0, 0), 0.01f),
-        ReactionWheel(glm::vec3(0, 1, 0), 0.01f),
-        ReactionWheel(glm::vec3(0, 0, 1), 0.01f)
+        ReactionWheel(glm::vec3(1, 0, 0), wheelInertia, maxTorque, maxSpeed),
+        ReactionWheel(glm::vec3(0, 1, 0), wheelInertia, maxTorque, maxSpeed),
+        ReactionWheel(glm::vec3(0, 0, 1), wheelInertia, maxTorque, maxSpeed)
     }
 {
 }
@@ -32,10 +32,9 @@ glm::vec3 ReactionWheelSystem::getTotalMomentum() const
 
 glm::vec3 ReactionWheelSystem::computeReactionTorque(float dt)
 {
-    static glm::vec3 prevMomentum(0.0f);
     glm::vec3 currentMomentum = getTotalMomentum();
-    m_lastReactionTorque = -(currentMomentum - prevMomentum) / dt; // Store
-    prevMomentum = currentMomentum;
+    m_lastReactionTorque = -(currentMomentum - m_prevMomentum) / dt; // Store
+    m_prevMomentum = currentMomentum;
 
     return m_lastReactionTorque;
 }
@@ -0,0 +1,463 @@
+#include "scenario.h"
+#include "ccsds.h"
+#include "functions_main.h"
+#include "simulation_state.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace
+{
+    struct Value
+    {
+        enum Kind { NUMBER, BOOLEAN, STRING, ARRAY } kind { NUMBER };
+        double number { 0.0 };
+        bool boolean { false };
+        std::string text;
+        std::vector<double> array;
+    };
+
+    std::string trim(const std::string& s)
+    {
+        std::size_t b { s.find_first_not_of(" \t\r") };
+        if (b == std::string::npos) { return {}; }
+        return s.substr(b, s.find_last_not_of(" \t\r") - b + 1);
+    }
+
+    // Cuts a trailing # comment, ignoring any # inside a string
+    std::string stripComment(const std::string& line)
+    {
+        bool inString { false };
+        for (std::size_t i = 0; i < line.size(); ++i)
+        {
+            if (line[i] == '"' && (i == 0 || line[i - 1] != '\\')) { inString = !inString; }
+            if (line[i] == '#' && !inString) { return line.substr(0, i); }
+        }
+        return line;
+    }
+
+    bool parseNumber(const std::string& s, double& out)
+    {
+        if (s.empty()) { return false; }
+        char* end { nullptr };
+        out = std::strtod(s.c_str(), &end);
+        return end == s.c_str() + s.size();
+    }
+
+    bool parseValue(const std::string& s, Value& v)
+    {
+        if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
+        {
+            v.kind = Value::STRING;
+            for (std::size_t i = 1; i + 1 < s.size(); ++i)
+            {
+                if (s[i] == '\\' && i + 2 < s.size()) { ++i; }
+                v.text += s[i];
+            }
+            return true;
+        }
+        if (s == "true" || s == "false")
+        {
+            v.kind = Value::BOOLEAN;
+            v.boolean = (s == "true");
+            return true;
+        }
+        if (s.size() >= 2 && s.front() == '[' && s.back() == ']')
+        {
+            v.kind = Value::ARRAY;
+            std::string items { s.substr(1, s.size() - 2) };
+            if (trim(items).empty()) { return true; }
+
+            std::size_t start { 0 };
+            while (true)
+            {
+                std::size_t comma { items.find(',', start) };
+                double x { 0.0 };
+                if (!parseNumber(trim(items.substr(start, comma - start)), x)) { return false; }
+                v.array.push_back(x);
+                if (comma == std::string::npos) { return true; }
+                start = comma + 1;
+            }
+        }
+        v.kind = Value::NUMBER;
+        return parseNumber(s, v.number);
+    }
+
+    // Setter for one "table.key"; returns an empty string or what was wrong with the value
+    using Binding = std::function<std::string(const Value&)>;
+
+    Binding number(double& field, double scale = 1.0)
+    {
+        return [&field, scale](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER) { return "expected a number"; }
+            field = v.number * scale;
+            return {};
+        };
+    }
+
+    Binding number(float& field, double scale = 1.0)
+    {
+        return [&field, scale](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER) { return "expected a number"; }
+            field = static_cast<float>(v.number * scale);
+            return {};
+        };
+    }
+
+    Binding positive(float& field, double scale = 1.0)
+    {
+        return [&field, scale](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || !(v.number > 0.0)) { return "expected a positive number"; }
+            field = static_cast<float>(v.number * scale);
+            return {};
+        };
+    }
+
+    Binding positive(double& field)
+    {
+        return [&field](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || !(v.number > 0.0)) { return "expected a positive number"; }
+            field = v.number;
+            return {};
+        };
+    }
+
+    // Rates here take 0 to mean "every step" (or, for downlink streams, "off")
+    Binding nonNegative(float& field)
+    {
+        return [&field](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || !(v.number >= 0.0)) { return "expected a non-negative number"; }
+            field = static_cast<float>(v.number);
+            return {};
+        };
+    }
+
+    Binding nonNegative(double& field)
+    {
+        return [&field](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || !(v.number >= 0.0)) { return "expected a non-negative number"; }
+            field = v.number;
+            return {};
+        };
+    }
+
+    Binding integer(int& field)
+    {
+        return [&field](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || v.number < 1.0 || v.number > INT_MAX || v.number != std::floor(v.number))
+                return "expected a positive integer";
+            field = static_cast<int>(v.number);
+            return {};
+        };
+    }
+
+    Binding boolean(bool& field)
+    {
+        return [&field](const Value& v) -> std::string {
+            if (v.kind != Value::BOOLEAN) { return "expected true or false"; }
+            field = v.boolean;
+            return {};
+        };
+    }
+
+    Binding text(std::string& field)
+    {
+        return [&field](const Value& v) -> std::string {
+            if (v.kind != Value::STRING) { return "expected a string"; }
+            field = v.text;
+            return {};
+        };
+    }
+
+    Binding vector3(glm::vec3& field, float scale = 1.0f, bool* set = nullptr)
+    {
+        return [&field, scale, set](const Value& v) -> std::string {
+            if (v.kind != Value::ARRAY || v.array.size() != 3) { return "expected an array of 3 numbers"; }
+            field = scale * glm::vec3(v.array[0], v.array[1], v.array[2]);
+            if (set) { *set = true; }
+            return {};
+        };
+    }
+
+    // A sensor's delay line must hold every sample taken during its latency. Sensors
+    // sampling every step are checked against the headless step only, as an interactive
+    // step depends on the frame rate.
+    std::string checkDelayLine(const Scenario& s, const char* key, float rate, float latency)
+    {
+        double interval { (rate > 0.0f) ? 1.0 / rate : (s.headless ? s.headlessStep : 0.0) };
+        if (interval <= 0.0 || latency / interval < SensorSuite::DELAY_CAPACITY) { return {}; }
+        return std::string(key) + ": more than " + std::to_string(SensorSuite::DELAY_CAPACITY)
+             + " samples in flight over the sensor's " + std::to_string(latency) + " s latency";
+    }
+
+    std::map<std::string, Binding> bindings(Scenario& s, double& altitude)
+    {
+        const double deg { glm::pi<double>() / 180.0 };
+        const float degF { glm::pi<float>() / 180.0f };
+
+        std::map<std::string, Binding> b;
+        b["simulation.epoch"] = nonNegative(s.epoch);
+        b["simulation.speed"] = positive(s.simSpeed);
+        b["simulation.substeps"] = integer(s.subSteps);
+        b["simulation.headless"] = boolean(s.headless);
+        b["simulation.duration"] = nonNegative(s.duration);
+        b["simulation.step"] = positive(s.headlessStep);
+        b["simulation.seed"] = [&s](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || v.number < 0.0) { return "expected a non-negative integer"; }
+            s.seed = static_cast<std::uint64_t>(v.number);
+            return {};
+        };
+
+        b["orbit.altitude_km"] = number(altitude, 1.0e3);
+        b["orbit.eccentricity"] = number(s.orbit.eccentricity);
+        b["orbit.inclination_deg"] = number(s.orbit.inclination, deg);
+        b["orbit.raan_deg"] = number(s.orbit.raan, deg);
+        b["orbit.arg_periapsis_deg"] = number(s.orbit.argPeriapsis, deg);
+        b["orbit.true_anomaly_deg"] = number(s.orbit.trueAnomaly, deg);
+
+        b["spacecraft.inertia"] = [&s](const Value& v) -> std::string {
+            if (v.kind != Value::ARRAY || (v.array.size() != 3 && v.array.size() != 9))
+                return "expected 3 principal moments or a 9 element row-major matrix";
+            if (v.array.size() == 3)
+            {
+                s.inertia = glm::mat3(0.0f);
+                for (int i = 0; i < 3; ++i)
+                    s.inertia[i][i] = static_cast<float>(v.array[i]);
+            }
+            else
+            {
+                for (int r = 0; r < 3; ++r)
+                    for (int c = 0; c < 3; ++c)
+                        s.inertia[c][r] = static_cast<float>(v.array[r * 3 + c]);
+            }
+            return {};
+        };
+        b["spacecraft.attitude_deg"] = vector3(s.attitude, degF);
+        b["spacecraft.body_rates_deg"] = vector3(s.bodyRates, degF, &s.bodyRatesSet);
+        b["spacecraft.mode"] = [&s](const Value& v) -> std::string {
+            for (AdcsMode mode : { AdcsMode::DETUMBLE, AdcsMode::SUN_ACQUIRE, AdcsMode::NADIR })
+            {
+                if (v.kind == Value::STRING && v.text == adcsModeName(mode))
+                {
+                    s.initialMode = mode;
+                    return {};
+                }
+            }
+            return "expected \"DETUMBLE\", \"SUN_ACQUIRE\" or \"NADIR\"";
+        };
+
+        b["wheels.inertia"] = positive(s.wheelInertia);
+        b["wheels.max_torque"] = positive(s.wheelMaxTorque);
+        b["wheels.max_speed_rpm"] = positive(s.wheelMaxSpeed, glm::two_pi<double>() / 60.0);
+
+        b["controller.rate"] = nonNegative(s.adcs.controlRate);
+        b["controller.bdot_gain"] = number(s.adcs.bdotGain);
+        b["controller.max_dipole"] = nonNegative(s.adcs.maxDipole);
+        b["controller.detumble_exit_rate_deg"] = number(s.adcs.detumbleExitRate, deg);
+        b["controller.detumble_entry_rate_deg"] = number(s.adcs.detumbleEntryRate, deg);
+        b["controller.sun_axis"] = vector3(s.adcs.sunAxisBody);
+        b["controller.sun_slew_gain"] = number(s.adcs.sunSlewGain);
+        b["controller.sun_slew_rate_deg"] = number(s.adcs.sunSlewRate, deg);
+        b["controller.sun_rate_gain"] = number(s.adcs.sunRateGain);
+        b["controller.sun_acquired_angle_deg"] = number(s.adcs.sunAcquiredAngle, deg);
+        b["controller.torque_limit"] = nonNegative(s.adcs.torqueLimit);
+        b["controller.dwell_time"] = nonNegative(s.adcs.dwellTime);
+        b["controller.wheel_speed_gain"] = number(s.adcs.wheelSpeedGain);
+
+        b["estimator.rate"] = nonNegative(s.estimator.rate);
+        b["estimator.closed_loop"] = boolean(s.estimator.closedLoop);
+
+        b["sensors.gyro_noise_density"] = nonNegative(s.sensors.gyro.noiseDensity);
+        b["sensors.gyro_bias_walk"] = nonNegative(s.sensors.gyro.biasRandomWalk);
+        b["sensors.gyro_rate"] = nonNegative(s.sensors.gyro.rate);
+        b["sensors.star_tracker_sigma"] = nonNegative(s.sensors.starTracker.noiseSigma);
+        b["sensors.star_tracker_rate"] = nonNegative(s.sensors.starTracker.rate);
+        b["sensors.sun_sensor_sigma"] = nonNegative(s.sensors.sunSensor.noiseSigma);
+        b["sensors.magnetometer_sigma"] = nonNegative(s.sensors.magnetometer.noiseSigma);
+
+        b["output.events"] = text(s.eventsCsv);
+        b["output.telemetry"] = text(s.telemetryPath);
+        b["output.telemetry_compress"] = boolean(s.telemetryCodec.compress);
+        b["output.telemetry_quantum"] = [&s](const Value& v) -> std::string {
+            if (v.kind != Value::ARRAY || v.array.size() != 6) { return "expected an array of 6 numbers"; }
+            std::array<float, 6> groups {};
+            for (std::size_t i = 0; i < 6; ++i)
+            {
+                if (v.array[i] < 0.0) { return "quanta must not be negative"; }
+                groups[i] = static_cast<float>(v.array[i]);
+            }
+            setQuantumGroups(s.telemetryCodec, groups);
+            return {};
+        };
+        b["output.checkpoint"] = text(s.checkpointPath);
+        b["output.checkpoint_interval"] = positive(s.checkpointInterval);
+        b["output.trace"] = text(s.tracePath);
+
+        auto apid = [](DownlinkStream& stream) -> Binding {
+            return [&stream](const Value& v) -> std::string {
+                if (v.kind != Value::NUMBER || v.number < 0.0 || v.number >= CCSDS_IDLE_APID)
+                    return "expected an APID from 0 to 2046";
+                stream.apid = static_cast<std::uint16_t>(v.number);
+                return {};
+            };
+        };
+        b["downlink.host"] = text(s.downlink.host);
+        b["downlink.port"] = [&s](const Value& v) -> std::string {
+            if (v.kind != Value::NUMBER || v.number < 0.0 || v.number > 65535.0) { return "expected a port, 0 to disable"; }
+            s.downlink.port = static_cast<int>(v.number);
+            return {};
+        };
+        b["downlink.housekeeping_apid"] = apid(s.downlink.streams[0]);
+        b["downlink.housekeeping_rate"] = nonNegative(s.downlink.streams[0].rate);
+        b["downlink.attitude_apid"] = apid(s.downlink.streams[1]);
+        b["downlink.attitude_rate"] = nonNegative(s.downlink.streams[1].rate);
+
+        b["telecommand.socket"] = text(s.telecommandSocket);
+        return b;
+    }
+}
+
+Scenario::Scenario()
+{
+    SimulationState nominal;
+    nominal.cubesatVel = calculateCubesatVel();
+    orbit = stateToElements(orbitSampleFromState(nominal));
+}
+
+bool readConfigFile(const std::string& path, std::vector<ConfigEntry>& entries, std::string& error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    std::string section;
+    std::string raw;
+    for (int lineNo = 1; std::getline(in, raw); ++lineNo)
+    {
+        std::string line { trim(stripComment(raw)) };
+        if (line.empty()) { continue; }
+
+        std::string where { path + ":" + std::to_string(lineNo) };
+        if (line.front() == '[')
+        {
+            if (line.back() != ']')
+            {
+                error = where + ": unterminated table header";
+                return false;
+            }
+            section = trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+
+        std::size_t eq { line.find('=') };
+        if (eq == std::string::npos)
+        {
+            error = where + ": expected key = value";
+            return false;
+        }
+        std::string key { trim(line.substr(0, eq)) };
+        entries.push_back({ section.empty() ? key : section + "." + key, trim(line.substr(eq + 1)), where });
+    }
+    return true;
+}
+
+bool applyScenarioSettings(const std::vector<ConfigEntry>& entries, Scenario& scenario, std::string& error)
+{
+    // Applied to a copy so a bad entry leaves `scenario` as it was
+    Scenario parsed = scenario;
+    double altitude { -1.0 };
+    double inertiaScale { 1.0 };
+    std::map<std::string, Binding> table = bindings(parsed, altitude);
+    table["spacecraft.inertia_scale"] = positive(inertiaScale);
+
+    for (const ConfigEntry& entry : entries)
+    {
+        auto binding = table.find(entry.key);
+        if (binding == table.end())
+        {
+            error = entry.where + ": unknown key " + entry.key;
+            return false;
+        }
+
+        Value value;
+        std::string problem { parseValue(entry.value, value) ? binding->second(value) : "cannot parse value" };
+        if (!problem.empty())
+        {
+            error = entry.where + ": " + entry.key + ": " + problem;
+            return false;
+        }
+    }
+
+    // Both apply after every other key, so their meaning does not depend on line order.
+    // The altitude is of the periapsis, so it composes with any eccentricity.
+    if (altitude >= 0.0)
+        parsed.orbit.semiMajorAxis = (Orbit::EARTH_RADIUS + altitude) / (1.0 - parsed.orbit.eccentricity);
+    parsed.inertia *= static_cast<float>(inertiaScale);
+
+    if (parsed.orbit.eccentricity < 0.0 || parsed.orbit.eccentricity >= 1.0)
+    {
+        error = "orbit.eccentricity must be in [0, 1)";
+        return false;
+    }
+
+    // The attitude dynamics divide by it (see SimulationState::inverseInertia)
+    if (!(glm::determinant(parsed.inertia) > 0.0f))
+    {
+        error = "spacecraft.inertia must have a positive determinant";
+        return false;
+    }
+
+    // The sun sensor and magnetometer rates are fixed, and fit
+    const SensorConfig& sensors = parsed.sensors;
+    for (std::string problem : { checkDelayLine(parsed, "sensors.gyro_rate", sensors.gyro.rate, sensors.gyro.latency),
+                                 checkDelayLine(parsed, "sensors.star_tracker_rate", sensors.starTracker.rate,
+                                                sensors.starTracker.latency) })
+    {
+        if (!problem.empty())
+        {
+            error = problem;
+            return false;
+        }
+    }
+
+    scenario = parsed;
+    return true;
+}
+
+bool loadScenario(const std::string& path, Scenario& scenario, std::string& error)
+{
+    std::vector<ConfigEntry> entries;
+    return readConfigFile(path, entries, error) && applyScenarioSettings(entries, scenario, error);
+}
+
+void applyScenario(const Scenario& scenario, SimulationState& state)
+{
+    OrbitSample start = elementsToState(scenario.orbit, scenario.epoch);
+    state.cubesatPos = glm::vec3(start.pos * static_cast<double>(SCALE_FACTOR));
+    state.cubesatVel = glm::vec3(start.vel);
+    state.simElapsedTime = scenario.epoch;
+
+    state.inertia = scenario.inertia;
+    state.inverseInertia = glm::inverse(scenario.inertia);
+    state.wheels = ReactionWheelSystem(scenario.wheelInertia, scenario.wheelMaxTorque, scenario.wheelMaxSpeed);
+    state.sensors = SensorSuite(scenario.sensors, scenario.seed);
+    state.estimator = AttitudeEstimator(scenario.estimator);
+    state.adcs = ModeManager(scenario.adcs);
+
+    // Orbit-rate rotation about the orbit normal, then the scenario's attitude and mode
+    initNadirPointing(state);
+    state.cubesatOrientation = glm::quat(scenario.attitude);
+    if (scenario.bodyRatesSet) { state.cubesatAngularVel = state.cubesatOrientation * scenario.bodyRates; }
+    state.adcs.setMode(scenario.initialMode);
+}
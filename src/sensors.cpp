@@ -0,0 +1,133 @@
+#include "sensors.h"
+#include "constants.h"
+#include "environment.h"
+#include "simulation_state.h"
+
+#include <cmath>
+
+namespace
+{
+    enum SensorStream { GYRO_STREAM, STAR_TRACKER_STREAM, SUN_SENSOR_STREAM, MAG_STREAM, NUM_STREAMS };
+
+    float quantize(float v, float lsb)
+    {
+        return (lsb > 0.0f) ? std::round(v / lsb) * lsb : v;
+    }
+
+    glm::vec3 quantize(const glm::vec3& v, float lsb)
+    {
+        return glm::vec3(quantize(v.x, lsb), quantize(v.y, lsb), quantize(v.z, lsb));
+    }
+}
+
+SensorSuite::SensorSuite(const SensorConfig& config, std::uint64_t seed, std::uint32_t spacecraftId)
+    : m_config { config },
+      m_gyroNoise { seed, std::uint64_t { spacecraftId } * NUM_STREAMS + GYRO_STREAM },
+      m_starTrackerNoise { seed, std::uint64_t { spacecraftId } * NUM_STREAMS + STAR_TRACKER_STREAM },
+      m_sunSensorNoise { seed, std::uint64_t { spacecraftId } * NUM_STREAMS + SUN_SENSOR_STREAM },
+      m_magNoise { seed, std::uint64_t { spacecraftId } * NUM_STREAMS + MAG_STREAM }
+{
+    m_gyroBias = noiseVec(m_gyroNoise, m_config.gyro.initialBiasSigma);
+    m_magBias = noiseVec(m_magNoise, m_config.magnetometer.initialBiasSigma);
+}
+
+void SensorSuite::reseed(std::uint64_t seed, std::uint32_t spacecraftId)
+{
+    m_gyroNoise = RandomStream(seed, std::uint64_t { spacecraftId } * NUM_STREAMS + GYRO_STREAM);
+    m_starTrackerNoise = RandomStream(seed, std::uint64_t { spacecraftId } * NUM_STREAMS + STAR_TRACKER_STREAM);
+    m_sunSensorNoise = RandomStream(seed, std::uint64_t { spacecraftId } * NUM_STREAMS + SUN_SENSOR_STREAM);
+    m_magNoise = RandomStream(seed, std::uint64_t { spacecraftId } * NUM_STREAMS + MAG_STREAM);
+}
+
+glm::vec3 SensorSuite::noiseVec(RandomStream& stream, float sigma)
+{
+    float n[3];
+    stream.fillNormal(n, 3);
+    return sigma * glm::vec3(n[0], n[1], n[2]);
+}
+
+bool SensorSuite::due(double& accumulator, float rate, float dt) const
+{
+    if (rate <= 0.0f) { return true; }
+
+    double period = 1.0 / rate;
+    accumulator += dt;
+    if (accumulator < period) { return false; }
+
+    accumulator = std::fmod(accumulator, period);
+    return true;
+}
+
+void SensorSuite::sample(const SimulationState& state, float dt)
+{
+    if (dt <= 0.0f) { return; }
+
+    // Samples are taken at the end of the step the caller is about to add to the clock
+    m_time = state.simElapsedTime + dt;
+
+    m_readings.gyro.fresh = false;
+    m_readings.starTracker.fresh = false;
+    m_readings.sunVector.fresh = false;
+    m_readings.magField.fresh = false;
+
+    const glm::quat& q = state.cubesatOrientation;
+    glm::quat qInv = glm::conjugate(q);
+    glm::vec3 posMeters = state.cubesatPos / SCALE_FACTOR;
+
+    // Gyro: body rates with drifting bias
+    if (due(m_gyroAccum, m_config.gyro.rate, dt))
+    {
+        const GyroConfig& cfg = m_config.gyro;
+        float interval = (cfg.rate > 0.0f) ? 1.0f / cfg.rate : dt;
+
+        m_gyroBias += noiseVec(m_gyroNoise, cfg.biasRandomWalk * std::sqrt(interval));
+
+        glm::vec3 bodyRate = qInv * state.cubesatAngularVel;
+        glm::vec3 measured = bodyRate + m_gyroBias
+                             + noiseVec(m_gyroNoise, cfg.noiseDensity / std::sqrt(interval));
+
+        m_gyroDelay.push({ quantize(measured, cfg.resolution), m_time, true, true });
+    }
+
+    // Star tracker: small-angle error applied in the body frame
+    if (due(m_starTrackerAccum, m_config.starTracker.rate, dt))
+    {
+        glm::vec3 dTheta = noiseVec(m_starTrackerNoise, m_config.starTracker.noiseSigma);
+        glm::quat dq = glm::normalize(glm::quat(1.0f, 0.5f * dTheta.x, 0.5f * dTheta.y, 0.5f * dTheta.z));
+
+        m_starTrackerDelay.push({ glm::normalize(q * dq), m_time, true, true });
+    }
+
+    // Sun sensor: no output in eclipse
+    if (due(m_sunSensorAccum, m_config.sunSensor.rate, dt))
+    {
+        glm::vec3 sunDir = sunDirection(state);
+        bool lit = !isInEclipse(posMeters, sunDir);
+
+        glm::vec3 measured = qInv * sunDir + noiseVec(m_sunSensorNoise, m_config.sunSensor.noiseSigma);
+        m_sunSensorDelay.push({ glm::normalize(measured), m_time, lit, true });
+    }
+
+    // Magnetometer: dipole field with constant hard-iron bias
+    if (due(m_magAccum, m_config.magnetometer.rate, dt))
+    {
+        const MagnetometerConfig& cfg = m_config.magnetometer;
+        glm::vec3 measured = qInv * magneticField(posMeters) + m_magBias
+                             + noiseVec(m_magNoise, cfg.noiseSigma);
+
+        m_magDelay.push({ quantize(measured, cfg.resolution), m_time, true, true });
+    }
+
+    m_gyroDelay.release(m_time, m_config.gyro.latency, m_readings.gyro);
+    m_starTrackerDelay.release(m_time, m_config.starTracker.latency, m_readings.starTracker);
+    m_sunSensorDelay.release(m_time, m_config.sunSensor.latency, m_readings.sunVector);
+    m_magDelay.release(m_time, m_config.magnetometer.latency, m_readings.magField);
+}
+
+const SensorReadings& SensorSuite::getReadings() const { return m_readings; }
+
+const SensorConfig& SensorSuite::getConfig() const { return m_config; }
+
+glm::vec3 SensorSuite::getGyroBias() const { return m_gyroBias; }
+
+glm::vec3 SensorSuite::getMagBias() const { return m_magBias; }
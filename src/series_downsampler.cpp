@@ -0,0 +1,263 @@
+#include "series_downsampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void lttbDownsample(const PlotPoint* points, std::size_t count, std::size_t target, std::vector<PlotPoint>& out)
+{
+    out.clear();
+    if (count == 0) { return; }
+    if (target >= count)
+    {
+        out.assign(points, points + count);
+        return;
+    }
+    if (target < 3)
+    {
+        out.push_back(points[0]);
+        if (target == 2) { out.push_back(points[count - 1]); }
+        return;
+    }
+
+    out.reserve(target);
+    out.push_back(points[0]);
+
+    const double every { static_cast<double>(count - 2) / static_cast<double>(target - 2) };
+    std::size_t kept { 0 };
+    for (std::size_t i = 0; i + 2 < target; ++i)
+    {
+        // Mean of the next bucket; for the last inner bucket that is the final point
+        std::size_t nextBegin { static_cast<std::size_t>((i + 1) * every) + 1 };
+        std::size_t nextEnd { std::min(static_cast<std::size_t>((i + 2) * every) + 1, count) };
+        double meanTime { 0.0 }, meanValue { 0.0 };
+        for (std::size_t j = nextBegin; j < nextEnd; ++j)
+        {
+            meanTime += points[j].time;
+            meanValue += points[j].value;
+        }
+        double n { static_cast<double>(nextEnd - nextBegin) };
+        meanTime /= n;
+        meanValue /= n;
+
+        const PlotPoint& a = points[kept];
+        std::size_t begin { static_cast<std::size_t>(i * every) + 1 };
+        std::size_t end { static_cast<std::size_t>((i + 1) * every) + 1 };
+        double bestArea { -1.0 };
+        for (std::size_t j = begin; j < end; ++j)
+        {
+            // Twice the triangle area; only the comparison matters
+            double area { std::abs((a.time - meanTime) * (points[j].value - a.value)
+                                   - (a.time - points[j].time) * (meanValue - a.value)) };
+            if (area > bestArea)
+            {
+                bestArea = area;
+                kept = j;
+            }
+        }
+        out.push_back(points[kept]);
+    }
+
+    out.push_back(points[count - 1]);
+}
+
+SeriesDownsampler::SeriesDownsampler(double baseWidth, std::size_t rawCapacity)
+    : m_baseWidth { baseWidth }, m_raw(std::max<std::size_t>(1, rawCapacity))
+{
+}
+
+SeriesDownsampler::Bucket SeriesDownsampler::emptyBucket()
+{
+    return { std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), false };
+}
+
+SeriesDownsampler::Bucket SeriesDownsampler::combine(const Bucket& earlier, const Bucket& later)
+{
+    bool minLater { later.min < earlier.min };
+    bool maxLater { later.max > earlier.max };
+
+    Bucket b;
+    b.min = minLater ? later.min : earlier.min;
+    b.max = maxLater ? later.max : earlier.max;
+    b.minLast = (minLater == maxLater) ? (minLater ? later.minLast : earlier.minLast) : minLater;
+    return b;
+}
+
+void SeriesDownsampler::clear()
+{
+    m_samples = 0;
+    m_rawNext = 0;
+    m_rawCount = 0;
+    m_levels.clear();
+}
+
+void SeriesDownsampler::append(double time, float value)
+{
+    if (std::isnan(value)) { return; }
+    if (m_samples > 0 && time < m_last) { clear(); }
+    if (m_samples == 0) { m_origin = time; }
+    m_last = time;
+    ++m_samples;
+
+    m_raw[m_rawNext] = { time, value };
+    m_rawNext = (m_rawNext + 1 == m_raw.size()) ? 0 : m_rawNext + 1;
+    m_rawCount = std::min(m_rawCount + 1, m_raw.size());
+
+    addToLevel(0, static_cast<std::size_t>((time - m_origin) / m_baseWidth), value);
+}
+
+void SeriesDownsampler::addToLevel(std::size_t level, std::size_t index, float value)
+{
+    for (;; ++level, index >>= 1)
+    {
+        if (m_levels.empty())
+        {
+            m_levels.emplace_back();
+        }
+        else if (level == m_levels.size())
+        {
+            // New top level: fold the pairs of the one below, which already hold `value`
+            const std::vector<Bucket>& below = m_levels.back();
+            std::vector<Bucket> merged((below.size() + 1) / 2, emptyBucket());
+            for (std::size_t i = 0; i < below.size(); i += 2)
+                merged[i / 2] = combine(below[i], (i + 1 < below.size()) ? below[i + 1] : emptyBucket());
+            m_levels.push_back(std::move(merged));
+        }
+
+        std::vector<Bucket>& buckets = m_levels[level];
+        if (buckets.size() <= index) { buckets.resize(index + 1, emptyBucket()); }
+
+        Bucket& b = buckets[index];
+        bool changed { false };
+        if (value < b.min)
+        {
+            b.min = value;
+            b.minLast = true;
+            changed = true;
+        }
+        if (value > b.max)
+        {
+            b.max = value;
+            b.minLast = false;
+            changed = true;
+        }
+
+        // A bucket the value did not extend already bounds it for every level above
+        if (!changed) { return; }
+        if (level + 1 == m_levels.size() && buckets.size() == 1) { return; }
+    }
+}
+
+const SeriesDownsampler::RawSample& SeriesDownsampler::raw(std::size_t i) const
+{
+    std::size_t oldest { (m_rawNext + m_raw.size() - m_rawCount) % m_raw.size() };
+    return m_raw[(oldest + i) % m_raw.size()];
+}
+
+bool SeriesDownsampler::rawCovers(double t0) const
+{
+    return m_rawCount == m_samples || (m_rawCount > 0 && raw(0).time <= t0);
+}
+
+void SeriesDownsampler::query(double t0, double t1, std::size_t maxPoints, std::vector<PlotPoint>& out) const
+{
+    out.clear();
+    m_candidates.clear();
+    if (m_samples == 0 || !(t1 > t0) || maxPoints == 0) { return; }
+
+    // Coarsest level with enough buckets in range for the preselection
+    const std::size_t wanted { maxPoints * PRESELECT_RATIO };
+    std::size_t level { 0 };
+    bool levelFound { false };
+    for (std::size_t k = m_levels.size(); k-- > 0;)
+    {
+        double width { std::ldexp(m_baseWidth, static_cast<int>(k)) };
+        if (2.0 * (t1 - t0) / width >= static_cast<double>(wanted))
+        {
+            level = k;
+            levelFound = true;
+            break;
+        }
+    }
+
+    // The raw ring wins whenever it reaches back far enough and is not much denser:
+    // exact samples, and no worse than the pyramid's candidate count
+    bool useRaw { rawCovers(t0) };
+    if (useRaw && levelFound)
+    {
+        auto before = [this](double t) {
+            std::size_t lo { 0 }, hi { m_rawCount };
+            while (lo < hi)
+            {
+                std::size_t mid { (lo + hi) / 2 };
+                if (raw(mid).time < t) { lo = mid + 1; }
+                else { hi = mid; }
+            }
+            return lo;
+        };
+        useRaw = before(t1) - before(t0) <= wanted;
+    }
+
+    if (useRaw) { queryRaw(t0, t1); }
+    else { queryLevel(level, t0, t1); }
+
+    lttbDownsample(m_candidates.data(), m_candidates.size(), maxPoints, out);
+}
+
+void SeriesDownsampler::queryRaw(double t0, double t1) const
+{
+    std::size_t lo { 0 }, hi { m_rawCount };
+    while (lo < hi)
+    {
+        std::size_t mid { (lo + hi) / 2 };
+        if (raw(mid).time < t0) { lo = mid + 1; }
+        else { hi = mid; }
+    }
+
+    // One sample either side, so the line runs to the edges of the range
+    for (std::size_t i = (lo > 0) ? lo - 1 : 0; i < m_rawCount; ++i)
+    {
+        const RawSample& s = raw(i);
+        m_candidates.push_back({ static_cast<float>(s.time - t0), s.value });
+        if (s.time > t1) { break; }
+    }
+}
+
+void SeriesDownsampler::queryLevel(std::size_t level, double t0, double t1) const
+{
+    const std::vector<Bucket>& buckets = m_levels[level];
+    double width { std::ldexp(m_baseWidth, static_cast<int>(level)) };
+
+    double first { std::floor((t0 - m_origin) / width) };
+    double last { std::floor((t1 - m_origin) / width) };
+    std::size_t begin { static_cast<std::size_t>(std::max(0.0, first)) };
+    std::size_t end { std::min(buckets.size(), static_cast<std::size_t>(std::max(0.0, last)) + 1) };
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const Bucket& b = buckets[i];
+        if (b.min > b.max) { continue; }
+
+        // Sample times inside a bucket are not kept; the order of min and max is
+        float start { static_cast<float>(m_origin + static_cast<double>(i) * width - t0) };
+        float early { start + 0.25f * static_cast<float>(width) };
+        float late { start + 0.75f * static_cast<float>(width) };
+        if (b.min == b.max)
+        {
+            m_candidates.push_back({ early, b.min });
+            continue;
+        }
+        m_candidates.push_back({ early, b.minLast ? b.max : b.min });
+        m_candidates.push_back({ late, b.minLast ? b.min : b.max });
+    }
+}
+
+bool SeriesDownsampler::empty() const { return m_samples == 0; }
+
+double SeriesDownsampler::getStartTime() const { return m_origin; }
+
+double SeriesDownsampler::getEndTime() const { return m_last; }
+
+std::size_t SeriesDownsampler::getLevelCount() const { return m_levels.size(); }
+
+std::size_t SeriesDownsampler::getSampleCount() const { return m_samples; }
@@ -0,0 +1,98 @@
+#include "streaming_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+StreamingStats::StreamingStats(double histMin, double histMax, int numBins)
+    : m_histMin { histMin }, m_histMax { histMax },
+      m_logMin { std::log(histMin) },
+      m_logStep { (std::log(histMax) - std::log(histMin)) / numBins },
+      m_bins(numBins, 0)
+{
+}
+
+int StreamingStats::binIndex(double x) const
+{
+    if (x <= m_histMin) { return 0; }
+    if (x >= m_histMax) { return static_cast<int>(m_bins.size()) - 1; }
+
+    int idx = static_cast<int>((std::log(x) - m_logMin) / m_logStep);
+    return std::clamp(idx, 0, static_cast<int>(m_bins.size()) - 1);
+}
+
+double StreamingStats::binCenter(int idx) const
+{
+    return std::exp(m_logMin + (idx + 0.5) * m_logStep);
+}
+
+void StreamingStats::add(double x)
+{
+    if (m_count == 0)
+    {
+        m_min = x;
+        m_max = x;
+    }
+    m_min = std::min(m_min, x);
+    m_max = std::max(m_max, x);
+
+    ++m_count;
+    double delta = x - m_mean;
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (x - m_mean);
+
+    ++m_bins[binIndex(x)];
+}
+
+// Chan et al. parallel combination of mean and M2
+void StreamingStats::merge(const StreamingStats& other)
+{
+    if (other.m_count == 0) { return; }
+    if (m_count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    double n1 = static_cast<double>(m_count);
+    double n2 = static_cast<double>(other.m_count);
+    double delta = other.m_mean - m_mean;
+
+    m_mean += delta * n2 / (n1 + n2);
+    m_m2 += other.m_m2 + delta * delta * n1 * n2 / (n1 + n2);
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+
+    for (std::size_t i = 0; i < m_bins.size() && i < other.m_bins.size(); ++i)
+        m_bins[i] += other.m_bins[i];
+}
+
+std::uint64_t StreamingStats::count() const { return m_count; }
+
+double StreamingStats::mean() const { return m_mean; }
+
+double StreamingStats::stddev() const
+{
+    return (m_count > 1) ? std::sqrt(m_m2 / static_cast<double>(m_count - 1)) : 0.0;
+}
+
+double StreamingStats::min() const { return m_min; }
+
+double StreamingStats::max() const { return m_max; }
+
+double StreamingStats::percentile(double p) const
+{
+    if (m_count == 0) { return 0.0; }
+
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(p / 100.0 * static_cast<double>(m_count)));
+    target = std::clamp<std::uint64_t>(target, 1, m_count);
+
+    std::uint64_t seen { 0 };
+    for (std::size_t i = 0; i < m_bins.size(); ++i)
+    {
+        seen += m_bins[i];
+        if (seen >= target)
+            return std::clamp(binCenter(static_cast<int>(i)), m_min, m_max);
+    }
+    return m_max;
+}
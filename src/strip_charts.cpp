@@ -0,0 +1,381 @@
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+#include "constants.h"
+#include "profiler.h"
+#include "strip_charts.h"
+
+namespace
+{
+    constexpr float TITLE_SCALE { 0.35f };
+    constexpr float MARGIN { 12.0f };               // px
+    constexpr float PANEL_WIDTH_FRACTION { 0.28f };
+    constexpr float PANEL_HEIGHT_FRACTION { 0.1f };
+    constexpr double MIN_SPAN { 1.0 };              // s
+    constexpr double MAX_SPAN { 1.0e6 };
+    constexpr double REBASE_AFTER { 1.0e5 };        // s of drift past the span before m_origin moves up
+
+    const glm::vec3 FRAME_COLOR { 0.45f, 0.45f, 0.45f };
+    const glm::vec3 TITLE_COLOR { 0.85f, 0.85f, 0.85f };
+
+    // Panel outline as (time, value) with time and value ranges of (0, 1)
+    constexpr PlotPoint FRAME_VERTICES[] { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f } };
+    constexpr int FRAME_VERTEX_COUNT { 5 };
+}
+
+StripCharts::StripCharts(Shader& plotShader, TextRenderer& textRenderer, Shader& textShader,
+                         std::size_t capacity, double span)
+    : m_plotShader { plotShader }, m_textRenderer { textRenderer }, m_textShader { textShader },
+      m_capacity { std::max<std::size_t>(capacity, FRAME_VERTEX_COUNT) },
+      m_span { std::clamp(span, MIN_SPAN, MAX_SPAN) }
+{
+}
+
+StripCharts::~StripCharts()
+{
+    if (m_vbo != 0) { glDeleteBuffers(1, &m_vbo); }
+    if (m_vao != 0) { glDeleteVertexArrays(1, &m_vao); }
+}
+
+int StripCharts::addPanel(std::string_view title)
+{
+    if (m_vbo != 0 || m_series.size() + m_panels.size() + 1 > MAX_PLOT_SLOTS) { return -1; }
+    m_panels.push_back({ std::string(title), 0.0f, 1.0f });
+    return static_cast<int>(m_panels.size()) - 1;
+}
+
+void StripCharts::addSeries(int panel, const glm::vec3& color)
+{
+    if (m_vbo != 0 || panel < 0 || panel >= static_cast<int>(m_panels.size())) { return; }
+    if (m_series.size() + m_panels.size() + 1 > MAX_PLOT_SLOTS) { return; }
+    m_series.push_back({ panel, color, SeriesDownsampler {}, {}, {}, 0, 0, 0 });
+}
+
+void StripCharts::collatePlots()
+{
+    const glm::vec3 xColor { 1.0f, 0.35f, 0.35f };
+    const glm::vec3 yColor { 0.4f, 1.0f, 0.4f };
+    const glm::vec3 zColor { 0.45f, 0.6f, 1.0f };
+    const glm::vec3 scalarColor { 1.0f, 0.85f, 0.3f };
+
+    int wheels { addPanel("RW Speed (rad/s)") };
+    addSeries(wheels, xColor);
+    addSeries(wheels, yColor);
+    addSeries(wheels, zColor);
+
+    int torque { addPanel("RW Torque (Nm)") };
+    addSeries(torque, xColor);
+    addSeries(torque, yColor);
+    addSeries(torque, zColor);
+
+    addSeries(addPanel("Pointing Error (deg)"), scalarColor);
+    addSeries(addPanel("Altitude (km)"), scalarColor);
+}
+
+void StripCharts::createBuffers()
+{
+    const std::size_t stride { 2 * m_capacity };
+    const std::size_t slots { m_series.size() + m_panels.size() };
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(slots * stride * sizeof(PlotPoint)), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PlotPoint), nullptr);
+
+    // Frames never change; they sit in the regions after the series
+    for (std::size_t p = 0; p < m_panels.size(); ++p)
+    {
+        GLintptr offset { static_cast<GLintptr>((m_series.size() + p) * stride * sizeof(PlotPoint)) };
+        glBufferSubData(GL_ARRAY_BUFFER, offset, sizeof(FRAME_VERTICES), FRAME_VERTICES);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    for (Series& s : m_series)
+    {
+        s.times.assign(m_capacity, 0.0f);
+        s.values.assign(m_capacity, 0.0f);
+    }
+    m_staging.resize(m_capacity);
+}
+
+void StripCharts::reset(double time)
+{
+    m_origin = time;
+    m_now = time;
+    m_lastVertex = time;
+    m_started = true;
+    for (Series& s : m_series)
+    {
+        s.written = 0;
+        s.uploaded = 0;
+        s.end = 0;
+    }
+}
+
+void StripCharts::upload()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    for (std::size_t i = 0; i < m_series.size(); ++i)
+    {
+        Series& s = m_series[i];
+        std::size_t fresh { s.written - s.uploaded };
+        if (fresh == 0) { continue; }
+
+        // Out of room: start the region over with everything that is drawn
+        std::size_t first { s.end };
+        if (fresh >= m_capacity || s.end + fresh > 2 * m_capacity)
+        {
+            fresh = std::min(s.written, m_capacity);
+            first = 0;
+        }
+
+        for (std::size_t j = 0; j < fresh; ++j)
+        {
+            std::size_t slot { (s.written - fresh + j) % m_capacity };
+            m_staging[j] = { s.times[slot], s.values[slot] };
+        }
+        GLintptr offset { static_cast<GLintptr>((i * 2 * m_capacity + first) * sizeof(PlotPoint)) };
+        glBufferSubData(GL_ARRAY_BUFFER, offset, static_cast<GLsizeiptr>(fresh * sizeof(PlotPoint)), m_staging.data());
+
+        s.end = first + fresh;
+        s.uploaded = s.written;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StripCharts::append(double time, const float* values)
+{
+    if (m_series.empty()) { return; }
+    if (m_vbo == 0) { createBuffers(); }
+    if (!m_started || time < m_now) { reset(time); }
+    m_now = time;
+
+    for (std::size_t i = 0; i < m_series.size(); ++i)
+        m_series[i].history.append(time, values[i]);
+
+    // Vertex times lose precision as they grow, so every so often move the origin up to
+    // the start of the window and refill the rings from the history
+    if (time - m_origin > m_span + REBASE_AFTER)
+    {
+        rebuild();
+        return;
+    }
+
+    // Two spans across the ring; finer detail than that is below a pixel anyway
+    const double interval { m_span / static_cast<double>(m_capacity / 2) };
+    if (m_series[0].written > 0 && time - m_lastVertex < interval) { return; }
+    m_lastVertex = time;
+
+    // Staged only; render() uploads whatever arrived since the last frame
+    const float t { static_cast<float>(time - m_origin) };
+    for (std::size_t i = 0; i < m_series.size(); ++i)
+    {
+        Series& s = m_series[i];
+        if (std::isnan(values[i])) { continue; }
+        std::size_t slot { s.written % m_capacity };
+        s.times[slot] = t;
+        s.values[slot] = values[i];
+        ++s.written;
+    }
+}
+
+void StripCharts::rebuild()
+{
+    if (m_vbo == 0 || !m_started) { return; }
+
+    // Re-based on the start of the window, so vertex times stay within a span of zero
+    const double t0 { m_now - m_span };
+    m_origin = t0;
+    std::vector<PlotPoint> points;
+
+    // Refill the CPU rings; the next render uploads each as one range
+    for (Series& s : m_series)
+    {
+        s.history.query(t0, m_now, m_capacity / 2, points);
+        for (std::size_t j = 0; j < points.size(); ++j)
+        {
+            s.times[j] = points[j].time;
+            s.values[j] = points[j].value;
+        }
+        s.written = points.size();
+        s.uploaded = 0;
+        s.end = 0;
+    }
+    m_lastVertex = m_now;
+}
+
+void StripCharts::autoScale()
+{
+    const float shownFrom { static_cast<float>(m_now - m_span - m_origin) };
+
+    for (Panel& panel : m_panels)
+    {
+        panel.min = std::numeric_limits<float>::infinity();
+        panel.max = -std::numeric_limits<float>::infinity();
+    }
+
+    for (const Series& s : m_series)
+    {
+        Panel& panel = m_panels[s.panel];
+        std::size_t n { std::min(s.written, m_capacity) };
+        for (std::size_t k = s.written - n; k < s.written; ++k)
+        {
+            std::size_t slot { k % m_capacity };
+            if (s.times[slot] < shownFrom) { continue; }
+            panel.min = std::min(panel.min, s.values[slot]);
+            panel.max = std::max(panel.max, s.values[slot]);
+        }
+    }
+
+    for (Panel& panel : m_panels)
+    {
+        if (panel.min > panel.max)
+        {
+            panel.min = 0.0f;
+            panel.max = 1.0f;
+            continue;
+        }
+
+        // A flat line sits mid-panel rather than on an edge
+        float magnitude { std::max(std::abs(panel.min), std::abs(panel.max)) };
+        float pad { 0.05f * (panel.max - panel.min) };
+        if (pad <= 1.0e-6f * magnitude) { pad = 0.1f * magnitude + 1.0e-6f; }
+        panel.min -= pad;
+        panel.max += pad;
+    }
+}
+
+glm::vec4 StripCharts::panelRect(std::size_t panel, int windowWidth, int windowHeight) const
+{
+    const float width { PANEL_WIDTH_FRACTION * static_cast<float>(windowWidth) };
+    const float height { PANEL_HEIGHT_FRACTION * static_cast<float>(windowHeight) };
+    const float titleHeight { FONT_SIZE * TITLE_SCALE + 8.0f };
+
+    // First panel on top, the stack in the bottom-right corner
+    std::size_t fromBottom { m_panels.size() - 1 - panel };
+    float x { static_cast<float>(windowWidth) - width - MARGIN };
+    float y { MARGIN + static_cast<float>(fromBottom) * (height + titleHeight + MARGIN) };
+    return { x, y, width, height };
+}
+
+void StripCharts::render(int windowWidth, int windowHeight)
+{
+    if (!m_visible || m_vbo == 0 || !m_started) { return; }
+
+    upload();
+    autoScale();
+
+    const std::size_t seriesCount { m_series.size() };
+    const std::size_t slots { seriesCount + m_panels.size() };
+    const int stride { static_cast<int>(2 * m_capacity) };
+
+    std::array<glm::vec4, MAX_PLOT_SLOTS> rects {};
+    std::array<glm::vec2, MAX_PLOT_SLOTS> ranges {};
+    std::array<glm::vec3, MAX_PLOT_SLOTS> colors {};
+    m_firsts.clear();
+    m_counts.clear();
+
+    for (std::size_t i = 0; i < seriesCount; ++i)
+    {
+        const Series& s = m_series[i];
+        const Panel& panel = m_panels[s.panel];
+        rects[i] = panelRect(s.panel, windowWidth, windowHeight);
+        ranges[i] = { panel.min, panel.max };
+        colors[i] = s.color;
+
+        // Newest vertices, which end where the last upload did
+        std::size_t n { std::min(s.written, m_capacity) };
+        m_firsts.push_back(static_cast<int>(i) * stride + static_cast<int>(s.end - n));
+        m_counts.push_back(static_cast<int>(n));
+    }
+    for (std::size_t p = 0; p < m_panels.size(); ++p)
+    {
+        std::size_t slot { seriesCount + p };
+        rects[slot] = panelRect(p, windowWidth, windowHeight);
+        ranges[slot] = { 0.0f, 1.0f };
+        colors[slot] = FRAME_COLOR;
+        m_firsts.push_back(static_cast<int>(slot) * stride);
+        m_counts.push_back(FRAME_VERTEX_COUNT);
+    }
+
+    m_plotShader.use();
+    m_plotShader.setMat4("projection", glm::ortho(0.0f, static_cast<float>(windowWidth), 0.0f, static_cast<float>(windowHeight)));
+    m_plotShader.setInt("slotStride", stride);
+    glUniform4fv(glGetUniformLocation(m_plotShader.ID, "panelRect"), static_cast<GLsizei>(slots), glm::value_ptr(rects[0]));
+    glUniform2fv(glGetUniformLocation(m_plotShader.ID, "valueRange"), static_cast<GLsizei>(slots), glm::value_ptr(ranges[0]));
+    glUniform3fv(glGetUniformLocation(m_plotShader.ID, "slotColor"), static_cast<GLsizei>(slots), glm::value_ptr(colors[0]));
+
+    GLboolean depthTest { glIsEnabled(GL_DEPTH_TEST) };
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(m_vao);
+
+    float now { static_cast<float>(m_now - m_origin) };
+    m_plotShader.setVec2("timeRange", now - static_cast<float>(m_span), now);
+    glMultiDrawArrays(GL_LINE_STRIP, m_firsts.data(), m_counts.data(), static_cast<GLsizei>(seriesCount));
+
+    m_plotShader.setVec2("timeRange", 0.0f, 1.0f);
+    glMultiDrawArrays(GL_LINE_STRIP, m_firsts.data() + seriesCount, m_counts.data() + seriesCount,
+                      static_cast<GLsizei>(m_panels.size()));
+
+    glBindVertexArray(0);
+
+    for (std::size_t p = 0; p < m_panels.size(); ++p)
+    {
+        const Panel& panel = m_panels[p];
+        glm::vec4 rect { panelRect(p, windowWidth, windowHeight) };
+
+        std::ostringstream title;
+        title << panel.title << "  " << std::setprecision(3) << panel.min << " .. " << panel.max
+              << "  (" << m_span << " s)";
+        m_textRenderer.RenderText(m_textShader, title.str(), rect.x, rect.y + rect.w + 6.0f, TITLE_SCALE, TITLE_COLOR);
+    }
+
+    if (depthTest) { glEnable(GL_DEPTH_TEST); }
+}
+
+void StripCharts::updateAndRender(const TelemetryFrame& frame, float pointingError, int windowWidth, int windowHeight)
+{
+    PROFILE_ZONE("StripCharts::updateAndRender");
+
+    const float altitude { glm::length(glm::vec3(frame.position[0], frame.position[1], frame.position[2]))
+                           - Physics::EARTH_RADIUS };
+
+    // Same order as collatePlots()
+    const float values[] {
+        frame.wheelSpeeds[0], frame.wheelSpeeds[1], frame.wheelSpeeds[2],
+        frame.reactionTorque[0], frame.reactionTorque[1], frame.reactionTorque[2],
+        pointingError,
+        altitude / 1000.0f,
+    };
+    if (m_series.size() != std::size(values)) { return; }
+
+    append(frame.time, values);
+    render(windowWidth, windowHeight);
+}
+
+void StripCharts::setSpan(double seconds)
+{
+    double span { std::clamp(seconds, MIN_SPAN, MAX_SPAN) };
+    if (span == m_span) { return; }
+    m_span = span;
+    rebuild();
+}
+
+double StripCharts::getSpan() const { return m_span; }
+
+void StripCharts::toggleVisible() { m_visible = !m_visible; }
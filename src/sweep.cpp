@@ -0,0 +1,263 @@
+#include "sweep.h"
+#include "monte_carlo.h"
+#include "parallel.h"
+#include "simulation_state.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    std::string trimmed(const std::string& s)
+    {
+        std::size_t b { s.find_first_not_of(" \t") };
+        if (b == std::string::npos) { return {}; }
+        return s.substr(b, s.find_last_not_of(" \t") - b + 1);
+    }
+
+    std::string unquoted(const std::string& s)
+    {
+        return (s.size() >= 2 && s.front() == '"' && s.back() == '"') ? s.substr(1, s.size() - 2) : s;
+    }
+
+    std::string jobPath(const SweepSpec& spec, std::size_t index)
+    {
+        return (std::filesystem::path(spec.outputDir) / ("job_" + std::to_string(index) + ".csv")).string();
+    }
+
+    std::vector<ConfigEntry> jobEntries(const SweepSpec& spec, std::size_t index)
+    {
+        std::vector<std::string> values = sweepJobValues(spec, index);
+        std::vector<ConfigEntry> entries;
+        for (std::size_t a = 0; a < spec.axes.size(); ++a)
+            entries.push_back({ spec.axes[a].key, values[a], "job " + std::to_string(index) });
+        return entries;
+    }
+
+    bool writeJobResult(const SweepSpec& spec, std::size_t index, const RunMetrics& m,
+                        const StreamingStats& steadyError, AdcsMode finalMode)
+    {
+        std::ostringstream row;
+        row << "job";
+        for (const SweepAxis& axis : spec.axes)
+            row << ',' << axis.key;
+        row << ",settling_time_s,nadir_entry_s,peak_wheel_radps,final_error_deg,steady_error_mean_deg,final_mode\n";
+
+        row << index;
+        for (const std::string& v : sweepJobValues(spec, index))
+            row << ',' << v;
+        row << std::setprecision(6) << ',' << m.settlingTime << ',' << m.nadirEntryTime << ',' << m.peakWheelSpeed
+            << ',' << glm::degrees(m.finalPointingError) << ',' << steadyError.mean() << ','
+            << adcsModeName(finalMode) << '\n';
+
+        std::string path = jobPath(spec, index);
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::trunc);
+            if (!out) { return false; }
+            out << row.str();
+            if (!out.flush()) { return false; }
+        }
+        return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+    }
+}
+
+bool loadSweep(const std::string& path, SweepSpec& spec, std::string& error)
+{
+    std::vector<ConfigEntry> entries;
+    if (!readConfigFile(path, entries, error)) { return false; }
+
+    SweepSpec parsed;
+    for (const ConfigEntry& e : entries)
+    {
+        if (e.key == "sweep.template")
+        {
+            parsed.templatePath = unquoted(e.value);
+        }
+        else if (e.key == "sweep.output")
+        {
+            parsed.outputDir = unquoted(e.value);
+        }
+        else if (e.key == "sweep.threads")
+        {
+            char* end { nullptr };
+            long threads { std::strtol(e.value.c_str(), &end, 10) };
+            if (end == e.value.c_str() || *end != '\0' || threads < 0 || threads > 65535)
+            {
+                error = e.where + ": sweep.threads: expected a non-negative integer, 0 for all hardware threads";
+                return false;
+            }
+            parsed.threads = static_cast<unsigned int>(threads);
+        }
+        else if (e.key.rfind("axes.", 0) == 0)
+        {
+            if (e.value.size() < 2 || e.value.front() != '[' || e.value.back() != ']')
+            {
+                error = e.where + ": an axis takes an array of values";
+                return false;
+            }
+            SweepAxis axis { e.key.substr(5), {} };
+            std::stringstream items(e.value.substr(1, e.value.size() - 2));
+            for (std::string item; std::getline(items, item, ',');)
+            {
+                if (!trimmed(item).empty()) { axis.values.push_back(trimmed(item)); }
+            }
+            if (axis.values.empty())
+            {
+                error = e.where + ": axis " + axis.key + " has no values";
+                return false;
+            }
+            parsed.axes.push_back(axis);
+        }
+        else
+        {
+            error = e.where + ": unknown key " + e.key;
+            return false;
+        }
+    }
+
+    // The template and output directory are found relative to the sweep file, so every
+    // machine, and every shard whatever its working directory, resolves them alike
+    auto besideSweep = [&path](const std::string& p) {
+        std::filesystem::path resolved(p);
+        if (resolved.is_relative()) { resolved = std::filesystem::path(path).parent_path() / resolved; }
+        return resolved.string();
+    };
+    parsed.outputDir = besideSweep(parsed.outputDir);
+    if (!parsed.templatePath.empty())
+    {
+        parsed.templatePath = besideSweep(parsed.templatePath);
+        if (!loadScenario(parsed.templatePath, parsed.base, error)) { return false; }
+    }
+
+    // Every axis value is tried once now, so a bad key or value fails before any job runs
+    for (const SweepAxis& axis : parsed.axes)
+    {
+        for (const std::string& v : axis.values)
+        {
+            Scenario probe = parsed.base;
+            if (!applyScenarioSettings({ { axis.key, v, path + ": axes." + axis.key } }, probe, error)) { return false; }
+        }
+    }
+
+    spec = parsed;
+    return true;
+}
+
+std::size_t sweepJobCount(const SweepSpec& spec)
+{
+    std::size_t count { 1 };
+    for (const SweepAxis& axis : spec.axes)
+        count *= axis.values.size();
+    return count;
+}
+
+std::vector<std::string> sweepJobValues(const SweepSpec& spec, std::size_t index)
+{
+    std::vector<std::string> values(spec.axes.size());
+    for (std::size_t a = spec.axes.size(); a-- > 0;)
+    {
+        const std::vector<std::string>& axisValues = spec.axes[a].values;
+        values[a] = axisValues[index % axisValues.size()];
+        index /= axisValues.size();
+    }
+    return values;
+}
+
+bool parseSweepShard(const std::string& text, SweepShard& shard)
+{
+    std::size_t slash { text.find('/') };
+    if (slash == std::string::npos) { return false; }
+
+    char* end { nullptr };
+    unsigned long long index { std::strtoull(text.c_str(), &end, 10) };
+    if (end != text.c_str() + slash) { return false; }
+    unsigned long long count { std::strtoull(text.c_str() + slash + 1, &end, 10) };
+    if (*end != '\0' || count == 0 || index >= count) { return false; }
+
+    shard.index = static_cast<std::size_t>(index);
+    shard.count = static_cast<std::size_t>(count);
+    return true;
+}
+
+SweepReport runSweep(const SweepSpec& spec, const SweepShard& shard)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(spec.outputDir, ec);
+
+    std::vector<std::size_t> jobs;
+    for (std::size_t j = shard.index; j < sweepJobCount(spec); j += shard.count)
+        jobs.push_back(j);
+
+    std::atomic<std::size_t> run { 0 }, skipped { 0 }, failed { 0 };
+    parallelFor(jobs.size(), spec.threads, [&](std::size_t i, unsigned int) {
+        std::size_t job { jobs[i] };
+        if (std::filesystem::exists(jobPath(spec, job)))
+        {
+            ++skipped;
+            return;
+        }
+
+        Scenario scenario = spec.base;
+        std::string error;
+        if (!applyScenarioSettings(jobEntries(spec, job), scenario, error))
+        {
+            ++failed;
+            return;
+        }
+
+        SimulationState state;
+        applyScenario(scenario, state);
+
+        DispersionConfig scoring;
+        scoring.duration = scenario.duration;
+        scoring.dt = scenario.headlessStep;
+        StreamingStats steadyError(1.0e-4, 180.0);
+        RunMetrics metrics = simulateAndScore(state, scoring, &steadyError);
+
+        if (writeJobResult(spec, job, metrics, steadyError, state.adcs.getMode())) { ++run; }
+        else { ++failed; }
+    });
+
+    return { run.load(), skipped.load(), failed.load() };
+}
+
+bool mergeSweep(const SweepSpec& spec, std::size_t& merged, std::size_t& missing, std::string& error)
+{
+    std::string summaryPath = (std::filesystem::path(spec.outputDir) / "summary.csv").string();
+    std::ofstream out(summaryPath);
+    if (!out)
+    {
+        error = "Cannot open " + summaryPath;
+        return false;
+    }
+
+    merged = 0;
+    missing = 0;
+    bool headerWritten { false };
+    for (std::size_t j = 0; j < sweepJobCount(spec); ++j)
+    {
+        std::ifstream in(jobPath(spec, j));
+        std::string header, row;
+        if (!in || !std::getline(in, header) || !std::getline(in, row))
+        {
+            ++missing;
+            continue;
+        }
+        if (!headerWritten)
+        {
+            out << header << '\n';
+            headerWritten = true;
+        }
+        out << row << '\n';
+        ++merged;
+    }
+    return static_cast<bool>(out);
+}
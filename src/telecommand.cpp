@@ -0,0 +1,453 @@
+#include "telecommand.h"
+#include "adcs_mode.h"
+#include "simulation_state.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    // How long the I/O thread sleeps in poll() before checking for close()
+    constexpr int POLL_INTERVAL_MS { 100 };
+
+    constexpr float MAX_SIM_SPEED { 1.0e6f };
+
+    struct CommandName
+    {
+        const char* name;
+        TelecommandOpcode opcode;
+        int args;
+    };
+
+    constexpr std::array<CommandName, 9> COMMAND_NAMES { {
+        { "mode", TelecommandOpcode::SET_MODE, 1 },
+        { "target", TelecommandOpcode::SET_TARGET_ATTITUDE, 4 },
+        { "clear-target", TelecommandOpcode::CLEAR_TARGET_ATTITUDE, 0 },
+        { "wheels", TelecommandOpcode::SET_WHEEL_SPEEDS, 3 },
+        { "clear-wheels", TelecommandOpcode::CLEAR_WHEEL_SPEEDS, 0 },
+        { "speed", TelecommandOpcode::SET_SIM_SPEED, 1 },
+        { "pause", TelecommandOpcode::PAUSE, 0 },
+        { "resume", TelecommandOpcode::RESUME, 0 },
+        { "step", TelecommandOpcode::STEP, 1 },
+    } };
+
+    bool parseFloat(const std::string& s, double& out)
+    {
+        if (s.empty()) { return false; }
+        char* end { nullptr };
+        out = std::strtod(s.c_str(), &end);
+        return end == s.c_str() + s.size();
+    }
+
+    bool allFinite(const float* values, int count)
+    {
+        return std::all_of(values, values + count, [](float v) { return std::isfinite(v); });
+    }
+
+    bool makeUnixAddress(const std::string& path, sockaddr_un& addr, std::string& error)
+    {
+        addr = sockaddr_un {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            error = "Telecommand socket path too long: " + path;
+            return false;
+        }
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        return true;
+    }
+}
+
+const char* telecommandStatusName(TelecommandStatus status)
+{
+    switch (status)
+    {
+        case TelecommandStatus::ACCEPTED:   return "ACCEPTED";
+        case TelecommandStatus::REJECTED:   return "REJECTED";
+        case TelecommandStatus::QUEUE_FULL: return "QUEUE_FULL";
+    }
+    return "UNKNOWN";
+}
+
+bool validateTelecommand(const TelecommandPacket& packet, std::string& error)
+{
+    if (!std::isfinite(packet.executeAt))
+    {
+        error = "execution time is not finite";
+        return false;
+    }
+
+    switch (static_cast<TelecommandOpcode>(packet.opcode))
+    {
+        case TelecommandOpcode::SET_MODE:
+        {
+            float mode { packet.args[0] };
+            if (mode != 0.0f && mode != 1.0f && mode != 2.0f) { error = "mode must be 0, 1 or 2"; }
+            break;
+        }
+        case TelecommandOpcode::SET_TARGET_ATTITUDE:
+        {
+            float norm2 { packet.args[0] * packet.args[0] + packet.args[1] * packet.args[1]
+                          + packet.args[2] * packet.args[2] + packet.args[3] * packet.args[3] };
+            if (!allFinite(packet.args, 4) || !(norm2 > 1.0e-6f)) { error = "target is not a quaternion"; }
+            break;
+        }
+        case TelecommandOpcode::SET_WHEEL_SPEEDS:
+            if (!allFinite(packet.args, 3)) { error = "wheel speeds are not finite"; }
+            break;
+        case TelecommandOpcode::SET_SIM_SPEED:
+            if (!(packet.args[0] > 0.0f && packet.args[0] <= MAX_SIM_SPEED)) { error = "speed must be in (0, 1e6]"; }
+            break;
+        case TelecommandOpcode::STEP:
+            if (!(packet.args[0] > 0.0f && std::isfinite(packet.args[0]))) { error = "step must be positive"; }
+            break;
+        case TelecommandOpcode::CLEAR_TARGET_ATTITUDE:
+        case TelecommandOpcode::CLEAR_WHEEL_SPEEDS:
+        case TelecommandOpcode::PAUSE:
+        case TelecommandOpcode::RESUME:
+            break;
+        default:
+            error = "unknown opcode " + std::to_string(packet.opcode);
+            break;
+    }
+    return error.empty();
+}
+
+bool parseTelecommand(const std::vector<std::string>& words, TelecommandPacket& packet, std::string& error)
+{
+    packet = TelecommandPacket {};
+    packet.magic = TELECOMMAND_MAGIC;
+
+    auto command = std::find_if(COMMAND_NAMES.begin(), COMMAND_NAMES.end(),
+                                [&words](const CommandName& c) { return !words.empty() && words[0] == c.name; });
+    if (command == COMMAND_NAMES.end())
+    {
+        error = "expected one of mode, target, clear-target, wheels, clear-wheels, speed, pause, resume, step";
+        return false;
+    }
+    packet.opcode = static_cast<std::uint8_t>(command->opcode);
+
+    std::size_t argEnd { 1 + static_cast<std::size_t>(command->args) };
+    bool timed { words.size() == argEnd + 2 && words[argEnd] == "at" };
+    if (words.size() != argEnd && !timed)
+    {
+        error = std::string(command->name) + " takes " + std::to_string(command->args) + " argument(s), then optionally `at <s>`";
+        return false;
+    }
+
+    for (std::size_t i = 1; i < argEnd; ++i)
+    {
+        double value { 0.0 };
+        bool named { false };
+        if (command->opcode == TelecommandOpcode::SET_MODE)
+        {
+            for (AdcsMode mode : { AdcsMode::DETUMBLE, AdcsMode::SUN_ACQUIRE, AdcsMode::NADIR })
+            {
+                if (words[i] != adcsModeName(mode)) { continue; }
+                value = static_cast<double>(mode);
+                named = true;
+            }
+        }
+        if (!named && !parseFloat(words[i], value))
+        {
+            error = (command->opcode == TelecommandOpcode::SET_MODE) ? "expected DETUMBLE, SUN_ACQUIRE or NADIR, got "
+                                                                      : "expected a number, got ";
+            error += words[i];
+            return false;
+        }
+        packet.args[i - 1] = static_cast<float>(value);
+    }
+
+    if (timed && !parseFloat(words[argEnd + 1], packet.executeAt))
+    {
+        error = "expected a time after `at`, got " + words[argEnd + 1];
+        return false;
+    }
+    return validateTelecommand(packet, error);
+}
+
+TelecommandQueue::TelecommandQueue(float simSpeed, std::size_t capacity)
+    : m_ring { capacity }
+{
+    m_pending.reserve(m_ring.capacity());
+    m_control.simSpeed = simSpeed;
+}
+
+bool TelecommandQueue::push(const TelecommandPacket& packet) { return m_ring.tryPush(packet); }
+
+bool TelecommandQueue::beginStep(SimulationState& state, float dt)
+{
+    const TelecommandPacket* first { nullptr };
+    for (std::size_t n = m_ring.peek(first); n > 0; n = m_ring.peek(first))
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto at = std::upper_bound(m_pending.begin(), m_pending.end(), first[i].executeAt,
+                                       [](double t, const TelecommandPacket& p) { return t < p.executeAt; });
+            m_pending.insert(at, first[i]);
+        }
+        m_ring.consume(n);
+    }
+
+    double now { state.simElapsedTime };
+    std::size_t due { 0 };
+    while (due < m_pending.size() && m_pending[due].executeAt <= now)
+        apply(m_pending[due++], state);
+    m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(due));
+
+    if (!m_control.paused) { return true; }
+    if (m_control.stepRemaining <= 0.5f * dt)
+    {
+        m_control.stepRemaining = 0.0f;
+        return false;
+    }
+    m_control.stepRemaining -= dt;
+    return true;
+}
+
+void TelecommandQueue::apply(const TelecommandPacket& packet, SimulationState& state)
+{
+    const float* a = packet.args;
+    switch (static_cast<TelecommandOpcode>(packet.opcode))
+    {
+        case TelecommandOpcode::SET_MODE:
+            state.adcs.setMode(static_cast<AdcsMode>(static_cast<int>(a[0])));
+            break;
+        case TelecommandOpcode::SET_TARGET_ATTITUDE:
+            state.adcs.setAttitudeTarget(glm::quat(a[0], a[1], a[2], a[3]));
+            break;
+        case TelecommandOpcode::CLEAR_TARGET_ATTITUDE:
+            state.adcs.clearAttitudeTarget();
+            break;
+        case TelecommandOpcode::SET_WHEEL_SPEEDS:
+            state.adcs.setWheelSpeedTarget(glm::vec3(a[0], a[1], a[2]));
+            break;
+        case TelecommandOpcode::CLEAR_WHEEL_SPEEDS:
+            state.adcs.clearWheelSpeedTarget();
+            break;
+        case TelecommandOpcode::SET_SIM_SPEED:
+            m_control.simSpeed = a[0];
+            break;
+        case TelecommandOpcode::PAUSE:
+            m_control.paused = true;
+            m_control.stepRemaining = 0.0f;
+            break;
+        case TelecommandOpcode::RESUME:
+            m_control.paused = false;
+            m_control.stepRemaining = 0.0f;
+            break;
+        case TelecommandOpcode::STEP:
+            m_control.paused = true;
+            m_control.stepRemaining += a[0];
+            break;
+    }
+    ++m_applied;
+}
+
+const SimulationControl& TelecommandQueue::getControl() const { return m_control; }
+
+bool TelecommandQueue::isHeld() const { return m_control.paused && m_control.stepRemaining <= 0.0f; }
+
+std::uint64_t TelecommandQueue::getApplied() const { return m_applied; }
+
+TelecommandServer::TelecommandServer(std::string socketPath, TelecommandQueue& queue)
+    : m_socketPath { std::move(socketPath) }, m_queue { queue }
+{
+}
+
+TelecommandServer::~TelecommandServer()
+{
+    close();
+}
+
+bool TelecommandServer::open(std::string& error)
+{
+    sockaddr_un addr;
+    if (!makeUnixAddress(m_socketPath, addr, error)) { return false; }
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0)
+    {
+        error = std::string("Telecommand socket() failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    ::unlink(m_socketPath.c_str());
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(m_listenFd, 4) < 0)
+    {
+        error = "Telecommand bind/listen on " + m_socketPath + " failed: " + std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    m_running.store(true);
+    m_thread = std::thread(&TelecommandServer::run, this);
+    std::cout << "Accepting telecommands on " << m_socketPath << '\n';
+    return true;
+}
+
+void TelecommandServer::close()
+{
+    m_running.store(false);
+    if (m_thread.joinable()) { m_thread.join(); }
+    if (m_listenFd >= 0)
+    {
+        ::close(m_listenFd);
+        ::unlink(m_socketPath.c_str());
+    }
+    m_listenFd = -1;
+}
+
+std::uint64_t TelecommandServer::getReceived() const { return m_received.load(std::memory_order_relaxed); }
+
+std::uint64_t TelecommandServer::getRejected() const { return m_rejected.load(std::memory_order_relaxed); }
+
+TelecommandStatus TelecommandServer::handle(const TelecommandPacket& packet)
+{
+    m_received.fetch_add(1, std::memory_order_relaxed);
+
+    std::string error;
+    TelecommandStatus status { TelecommandStatus::ACCEPTED };
+    if (!validateTelecommand(packet, error))
+    {
+        std::cerr << "Telecommand " << packet.sequence << " rejected: " << error << '\n';
+        status = TelecommandStatus::REJECTED;
+    }
+    else if (!m_queue.push(packet))
+    {
+        status = TelecommandStatus::QUEUE_FULL;
+    }
+
+    if (status != TelecommandStatus::ACCEPTED) { m_rejected.fetch_add(1, std::memory_order_relaxed); }
+    return status;
+}
+
+void TelecommandServer::run()
+{
+    constexpr std::size_t BATCH { 64 };
+    std::array<std::uint8_t, BATCH * sizeof(TelecommandPacket)> rx {};
+    std::array<TelecommandAck, BATCH> acks {};
+    std::size_t fill { 0 };
+    int client { -1 };
+
+    auto dropClient = [&client, &fill] {
+        ::close(client);
+        client = -1;
+        fill = 0;
+    };
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        pollfd pfd { (client >= 0) ? client : m_listenFd, POLLIN, 0 };
+        int ready = ::poll(&pfd, 1, POLL_INTERVAL_MS);
+        if (ready <= 0) { continue; }
+
+        // One client at a time; others wait in the listen backlog
+        if (client < 0)
+        {
+            client = ::accept(m_listenFd, nullptr, nullptr);
+            fill = 0;
+            continue;
+        }
+
+        ssize_t n = ::recv(client, rx.data() + fill, rx.size() - fill, 0);
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0)
+        {
+            dropClient();
+            continue;
+        }
+        fill += static_cast<std::size_t>(n);
+
+        std::size_t used { 0 };
+        std::size_t ackCount { 0 };
+        bool desync { false };
+        while (fill - used >= sizeof(TelecommandPacket))
+        {
+            TelecommandPacket packet;
+            std::memcpy(&packet, rx.data() + used, sizeof(packet));
+            used += sizeof(packet);
+
+            if (packet.magic != TELECOMMAND_MAGIC)
+            {
+                desync = true;
+                break;
+            }
+
+            TelecommandAck& ack = acks[ackCount++];
+            ack = TelecommandAck {};
+            ack.magic = TELECOMMAND_ACK_MAGIC;
+            ack.sequence = packet.sequence;
+            ack.status = static_cast<std::uint8_t>(handle(packet));
+        }
+
+        // Acks for everything one recv delivered go out in one send; the socket is
+        // blocking, so a client that never reads its acks stalls only this thread
+        if (ackCount > 0 && ::send(client, acks.data(), ackCount * sizeof(TelecommandAck), MSG_NOSIGNAL) < 0)
+            desync = true;
+
+        if (desync)
+        {
+            std::cerr << "Telecommand client dropped (bad magic or send failure)\n";
+            dropClient();
+            continue;
+        }
+
+        std::memmove(rx.data(), rx.data() + used, fill - used);
+        fill -= used;
+    }
+
+    if (client >= 0) { ::close(client); }
+}
+
+bool sendTelecommand(const std::string& socketPath, const TelecommandPacket& packet, TelecommandStatus& status,
+                     std::string& error, int timeoutMs)
+{
+    sockaddr_un addr;
+    if (!makeUnixAddress(socketPath, addr, error)) { return false; }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        error = "Cannot connect to " + socketPath + ": " + std::strerror(errno);
+        if (fd >= 0) { ::close(fd); }
+        return false;
+    }
+
+    bool ok { ::send(fd, &packet, sizeof(packet), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(packet)) };
+
+    TelecommandAck ack {};
+    std::size_t got { 0 };
+    while (ok && got < sizeof(ack))
+    {
+        pollfd pfd { fd, POLLIN, 0 };
+        if (::poll(&pfd, 1, timeoutMs) <= 0)
+        {
+            ok = false;
+            break;
+        }
+        ssize_t n = ::recv(fd, reinterpret_cast<std::uint8_t*>(&ack) + got, sizeof(ack) - got, 0);
+        if (n <= 0) { ok = false; }
+        else { got += static_cast<std::size_t>(n); }
+    }
+    ::close(fd);
+
+    if (!ok || ack.magic != TELECOMMAND_ACK_MAGIC || ack.sequence != packet.sequence)
+    {
+        error = "No valid acknowledgement from " + socketPath;
+        return false;
+    }
+    status = static_cast<TelecommandStatus>(ack.status);
+    return true;
+}
@@ -0,0 +1,299 @@
+#include "telemetry_codec.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<std::uint8_t>& out) : m_out { out } {}
+
+        // Most significant bit first
+        void write(std::uint64_t value, int bits)
+        {
+            if (bits > 32)
+            {
+                write(value >> 32, bits - 32);
+                write(value & 0xFFFFFFFFull, 32);
+                return;
+            }
+            if (bits == 0) { return; }
+            m_acc = (m_acc << bits) | (value & ((1ull << bits) - 1));
+            m_bits += bits;
+            while (m_bits >= 8)
+            {
+                m_bits -= 8;
+                m_out.push_back(static_cast<std::uint8_t>(m_acc >> m_bits));
+            }
+        }
+
+        void finish()
+        {
+            if (m_bits > 0) { m_out.push_back(static_cast<std::uint8_t>(m_acc << (8 - m_bits))); }
+            m_bits = 0;
+        }
+
+    private:
+        std::vector<std::uint8_t>& m_out;
+        std::uint64_t m_acc { 0 };
+        int m_bits { 0 }; // Pending bits in the low end of m_acc, always < 8 between calls
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const std::uint8_t* data, std::size_t size) : m_data { data }, m_size { size } {}
+
+        std::uint64_t read(int bits)
+        {
+            if (bits > 32)
+            {
+                std::uint64_t high { read(bits - 32) };
+                return (high << 32) | read(32);
+            }
+            if (bits == 0) { return 0; }
+            while (m_bits < bits)
+            {
+                std::uint8_t byte { 0 };
+                if (m_pos < m_size) { byte = m_data[m_pos++]; }
+                else { m_overrun = true; }
+                m_acc = (m_acc << 8) | byte;
+                m_bits += 8;
+            }
+            m_bits -= bits;
+            return (m_acc >> m_bits) & ((1ull << bits) - 1);
+        }
+
+        bool bit() { return read(1) != 0; }
+        bool ok() const { return !m_overrun; }
+
+    private:
+        const std::uint8_t* m_data;
+        std::size_t m_size;
+        std::size_t m_pos { 0 };
+        std::uint64_t m_acc { 0 };
+        int m_bits { 0 };
+        bool m_overrun { false };
+    };
+
+    std::uint64_t zigzag(std::int64_t v) { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+
+    std::int64_t unzigzag(std::uint64_t v) { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+
+    // Gorilla-style buckets: 0 | 10 + 7 bits | 110 + 12 | 1110 + 20 | 1111 + 64
+    struct Bucket
+    {
+        std::uint64_t prefix;
+        int prefixBits;
+        int valueBits;
+    };
+    constexpr Bucket BUCKETS[] { { 0b10, 2, 7 }, { 0b110, 3, 12 }, { 0b1110, 4, 20 }, { 0b1111, 4, 64 } };
+
+    void writeDelta(BitWriter& out, std::int64_t dod)
+    {
+        if (dod == 0)
+        {
+            out.write(0, 1);
+            return;
+        }
+        std::uint64_t z { zigzag(dod) };
+        for (const Bucket& b : BUCKETS)
+        {
+            if (b.valueBits == 64 || z < (1ull << b.valueBits))
+            {
+                out.write(b.prefix, b.prefixBits);
+                out.write(z, b.valueBits);
+                return;
+            }
+        }
+    }
+
+    std::int64_t readDelta(BitReader& in)
+    {
+        if (!in.bit()) { return 0; }
+        int bucket { 0 };
+        while (bucket < 3 && in.bit())
+            ++bucket;
+        return unzigzag(in.read(BUCKETS[bucket].valueBits));
+    }
+
+    // Arguments are never zero except where noted
+    int leadingZeros(std::uint32_t v) { return __builtin_clz(v); }
+
+    int trailingZeros(std::uint64_t v) { return (v == 0) ? 64 : __builtin_ctzll(v); }
+
+    // Delta-of-delta over integers, shared by time bit patterns and quantized values.
+    // Layout: 6 bits shift, 64 bits first value, then one bucketed dod per value, where
+    // deltas are taken in units of 2^shift.
+    void encodeIntegers(const std::uint64_t* v, std::size_t count, BitWriter& out)
+    {
+        int shift { 63 };
+        for (std::size_t i = 1; i < count; ++i)
+            shift = std::min(shift, trailingZeros(v[i] - v[i - 1]));
+
+        out.write(static_cast<std::uint64_t>(shift), 6);
+        if (count == 0) { return; }
+        out.write(v[0], 64);
+
+        std::int64_t previousDelta { 0 };
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            // Wrapping subtraction; the arithmetic shift keeps the sign of the delta
+            std::int64_t delta { static_cast<std::int64_t>(v[i] - v[i - 1]) >> shift };
+            writeDelta(out, static_cast<std::int64_t>(static_cast<std::uint64_t>(delta) - static_cast<std::uint64_t>(previousDelta)));
+            previousDelta = delta;
+        }
+    }
+
+    bool decodeIntegers(BitReader& in, std::size_t count, std::uint64_t* v)
+    {
+        int shift { static_cast<int>(in.read(6)) };
+        if (count == 0) { return in.ok(); }
+        v[0] = in.read(64);
+
+        std::uint64_t delta { 0 };
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            delta += static_cast<std::uint64_t>(readDelta(in));
+            v[i] = v[i - 1] + (delta << shift);
+        }
+        return in.ok();
+    }
+
+    float dequantize(std::int64_t k, float step) { return static_cast<float>(static_cast<double>(k) * step); }
+}
+
+void encodeTimeColumn(const double* times, std::size_t count, std::vector<std::uint8_t>& out)
+{
+    std::vector<std::uint64_t> bits(count);
+    std::memcpy(bits.data(), times, count * sizeof(double));
+
+    BitWriter writer(out);
+    encodeIntegers(bits.data(), count, writer);
+    writer.finish();
+}
+
+bool decodeTimeColumn(const std::uint8_t* data, std::size_t bytes, std::size_t count, double* times)
+{
+    std::vector<std::uint64_t> bits(count);
+    BitReader reader(data, bytes);
+    if (!decodeIntegers(reader, count, bits.data())) { return false; }
+    std::memcpy(times, bits.data(), count * sizeof(double));
+    return true;
+}
+
+void encodeFloatColumn(const float* values, std::size_t count, std::vector<std::uint8_t>& out)
+{
+    BitWriter writer(out);
+    if (count == 0)
+    {
+        writer.finish();
+        return;
+    }
+
+    std::uint32_t previous { 0 };
+    std::memcpy(&previous, &values[0], sizeof(previous));
+    writer.write(previous, 32);
+
+    int windowLeading { 33 }, windowTrailing { 0 }; // No window yet
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        std::uint32_t current { 0 };
+        std::memcpy(&current, &values[i], sizeof(current));
+        std::uint32_t x { current ^ previous };
+        previous = current;
+
+        if (x == 0)
+        {
+            writer.write(0, 1);
+            continue;
+        }
+
+        int leading { std::min(leadingZeros(x), 31) };
+        int trailing { trailingZeros(x) };
+        if (leading >= windowLeading && trailing >= windowTrailing)
+        {
+            // Fits the previous window: 10 + the window's bits
+            writer.write(0b10, 2);
+            writer.write(x >> windowTrailing, 32 - windowLeading - windowTrailing);
+            continue;
+        }
+
+        // New window: 11 + 5 bits leading zeros + 5 bits (length - 1) + the bits
+        int length { 32 - leading - trailing };
+        writer.write(0b11, 2);
+        writer.write(static_cast<std::uint64_t>(leading), 5);
+        writer.write(static_cast<std::uint64_t>(length - 1), 5);
+        writer.write(x >> trailing, length);
+        windowLeading = leading;
+        windowTrailing = trailing;
+    }
+    writer.finish();
+}
+
+bool decodeFloatColumn(const std::uint8_t* data, std::size_t bytes, std::size_t count, float* values)
+{
+    if (count == 0) { return true; }
+
+    BitReader reader(data, bytes);
+    std::uint32_t previous { static_cast<std::uint32_t>(reader.read(32)) };
+    std::memcpy(&values[0], &previous, sizeof(previous));
+
+    int windowLeading { 0 }, windowTrailing { 0 };
+    bool haveWindow { false };
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        if (reader.bit())
+        {
+            if (reader.bit())
+            {
+                windowLeading = static_cast<int>(reader.read(5));
+                int length { static_cast<int>(reader.read(5)) + 1 };
+                windowTrailing = 32 - windowLeading - length;
+                if (windowTrailing < 0) { return false; }
+                haveWindow = true;
+            }
+            else if (!haveWindow)
+            {
+                return false;
+            }
+            previous ^= static_cast<std::uint32_t>(reader.read(32 - windowLeading - windowTrailing) << windowTrailing);
+        }
+        std::memcpy(&values[i], &previous, sizeof(previous));
+    }
+    return reader.ok();
+}
+
+void quantizeAndEncodeColumn(float* values, std::size_t count, float step, std::vector<std::uint8_t>& out)
+{
+    std::vector<std::uint64_t> k(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::int64_t q { std::llround(static_cast<double>(values[i]) / step) };
+        k[i] = static_cast<std::uint64_t>(q);
+        values[i] = dequantize(q, step);
+    }
+
+    BitWriter writer(out);
+    std::uint32_t stepBits { 0 };
+    std::memcpy(&stepBits, &step, sizeof(stepBits));
+    writer.write(stepBits, 32);
+    encodeIntegers(k.data(), count, writer);
+    writer.finish();
+}
+
+bool decodeQuantizedColumn(const std::uint8_t* data, std::size_t bytes, std::size_t count, float* values)
+{
+    BitReader reader(data, bytes);
+    std::uint32_t stepBits { static_cast<std::uint32_t>(reader.read(32)) };
+    float step { 0.0f };
+    std::memcpy(&step, &stepBits, sizeof(step));
+
+    std::vector<std::uint64_t> k(count);
+    if (!decodeIntegers(reader, count, k.data())) { return false; }
+    for (std::size_t i = 0; i < count; ++i)
+        values[i] = dequantize(static_cast<std::int64_t>(k[i]), step);
+    return true;
+}
@@ -0,0 +1,624 @@
+#include "telemetry_columns.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr int COLUMNS_PER_CHUNK { 1 + TELEMETRY_CHANNELS }; // Time, then every channel
+    constexpr std::size_t HEADER_SIZE { 16 };
+    constexpr std::size_t TRAILER_SIZE { 12 };
+    constexpr std::uint64_t COLUMN_ALIGNMENT { 8 };
+
+    constexpr const char* CHANNEL_NAMES[TELEMETRY_CHANNELS] {
+        "pos_x", "pos_y", "pos_z",
+        "vel_x", "vel_y", "vel_z",
+        "q_w", "q_x", "q_y", "q_z",
+        "rate_x", "rate_y", "rate_z",
+        "wheel_0", "wheel_1", "wheel_2",
+        "torque_x", "torque_y", "torque_z",
+        "mode"
+    };
+
+    // The float fields of TelemetryFrame are contiguous and in channel order
+    std::size_t floatOffset(TelemetryChannel channel)
+    {
+        return offsetof(TelemetryFrame, position) + static_cast<std::size_t>(channel) * sizeof(float);
+    }
+
+    template <typename T>
+    void updateStats(const T* values, std::size_t count, ColumnarColumnInfo& info)
+    {
+        double lo { std::numeric_limits<double>::infinity() };
+        double hi { -std::numeric_limits<double>::infinity() };
+        double sum { 0.0 };
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            double v { static_cast<double>(values[i]) };
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+            sum += v;
+        }
+        info.min = lo;
+        info.max = hi;
+        info.sum = sum;
+    }
+}
+
+namespace
+{
+    // Encodes one chunk's channel in place (quantization rounds `values`); returns RAW
+    // when compression is off or would not pay
+    ColumnEncoding encodeChannel(std::vector<float>& values, float quantum, bool compress,
+                                 std::vector<std::uint8_t>& out)
+    {
+        out.clear();
+        if (!compress) { return ColumnEncoding::RAW; }
+        if (quantum > 0.0f)
+        {
+            // Raw storage of the rounded values keeps the same error bound
+            quantizeAndEncodeColumn(values.data(), values.size(), quantum, out);
+            return (out.size() < values.size() * sizeof(float)) ? ColumnEncoding::QUANTIZED : ColumnEncoding::RAW;
+        }
+        encodeFloatColumn(values.data(), values.size(), out);
+        return (out.size() < values.size() * sizeof(float)) ? ColumnEncoding::DELTA : ColumnEncoding::RAW;
+    }
+
+    ColumnEncoding encodeTimes(const std::vector<double>& times, bool compress, std::vector<std::uint8_t>& out)
+    {
+        out.clear();
+        if (!compress) { return ColumnEncoding::RAW; }
+        encodeTimeColumn(times.data(), times.size(), out);
+        return (out.size() < times.size() * sizeof(double)) ? ColumnEncoding::DELTA : ColumnEncoding::RAW;
+    }
+}
+
+void setQuantumGroups(ColumnarCodec& codec, const std::array<float, 6>& groups)
+{
+    constexpr int firstChannel[7] { 0, 3, 6, 10, 13, 16, 19 }; // Group boundaries; MODE stays exact
+    for (int g = 0; g < 6; ++g)
+        for (int c = firstChannel[g]; c < firstChannel[g + 1]; ++c)
+            codec.quantum[static_cast<std::size_t>(c)] = groups[static_cast<std::size_t>(g)];
+}
+
+static_assert(offsetof(TelemetryFrame, mode) - offsetof(TelemetryFrame, position)
+                  == (TELEMETRY_CHANNELS - 1) * sizeof(float),
+              "Channel order must follow the frame layout");
+
+const char* telemetryChannelName(TelemetryChannel channel)
+{
+    int i { static_cast<int>(channel) };
+    return (i >= 0 && i < TELEMETRY_CHANNELS) ? CHANNEL_NAMES[i] : "unknown";
+}
+
+bool telemetryChannelFromName(std::string_view name, TelemetryChannel& channel)
+{
+    for (int i = 0; i < TELEMETRY_CHANNELS; ++i)
+    {
+        if (name == CHANNEL_NAMES[i])
+        {
+            channel = static_cast<TelemetryChannel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+float channelValue(const TelemetryFrame& frame, TelemetryChannel channel)
+{
+    if (channel == TelemetryChannel::MODE) { return static_cast<float>(frame.mode); }
+    float value { 0.0f };
+    std::memcpy(&value, reinterpret_cast<const char*>(&frame) + floatOffset(channel), sizeof(value));
+    return value;
+}
+
+void setChannelValue(TelemetryFrame& frame, TelemetryChannel channel, float value)
+{
+    if (channel == TelemetryChannel::MODE)
+    {
+        frame.mode = static_cast<std::uint8_t>(value);
+        return;
+    }
+    std::memcpy(reinterpret_cast<char*>(&frame) + floatOffset(channel), &value, sizeof(value));
+}
+
+bool TelemetryColumnWriter::open(const std::string& path, std::uint32_t chunkFrames, const ColumnarCodec& codec)
+{
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) { return false; }
+
+    m_chunkFrames = std::max<std::uint32_t>(1, chunkFrames);
+    m_codec = codec;
+    m_offset = 0;
+    m_frames = 0;
+    m_time.clear();
+    m_time.reserve(m_chunkFrames);
+    m_columns.assign(TELEMETRY_CHANNELS, {});
+    for (std::vector<float>& column : m_columns)
+        column.reserve(m_chunkFrames);
+    m_chunks.clear();
+    m_columnInfo.clear();
+
+    const std::uint32_t channels { TELEMETRY_CHANNELS };
+    m_file.write("CTLC", 4);
+    m_file.write(reinterpret_cast<const char*>(&COLUMNAR_FILE_VERSION), sizeof(COLUMNAR_FILE_VERSION));
+    m_file.write(reinterpret_cast<const char*>(&m_chunkFrames), sizeof(m_chunkFrames));
+    m_file.write(reinterpret_cast<const char*>(&channels), sizeof(channels));
+    m_offset = HEADER_SIZE;
+    return true;
+}
+
+void TelemetryColumnWriter::append(const TelemetryFrame* frames, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const TelemetryFrame& f = frames[i];
+        m_time.push_back(f.time);
+        for (int c = 0; c < TELEMETRY_CHANNELS; ++c)
+            m_columns[static_cast<std::size_t>(c)].push_back(channelValue(f, static_cast<TelemetryChannel>(c)));
+
+        if (m_time.size() == m_chunkFrames) { flushChunk(); }
+    }
+    m_frames += count;
+}
+
+void TelemetryColumnWriter::writeColumn(const void* data, std::size_t bytes, ColumnEncoding encoding,
+                                        ColumnarColumnInfo& info)
+{
+    static const char padding[COLUMN_ALIGNMENT] {};
+    std::uint64_t pad { (COLUMN_ALIGNMENT - m_offset % COLUMN_ALIGNMENT) % COLUMN_ALIGNMENT };
+    m_file.write(padding, static_cast<std::streamsize>(pad));
+    m_offset += pad;
+
+    m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    info.offset = m_offset;
+    info.bytes = static_cast<std::uint32_t>(bytes);
+    info.encoding = static_cast<std::uint32_t>(encoding);
+    m_offset += bytes;
+}
+
+void TelemetryColumnWriter::flushChunk()
+{
+    if (m_time.empty()) { return; }
+
+    ColumnarChunkInfo chunk {};
+    chunk.firstTime = m_time.front();
+    chunk.lastTime = m_time.back();
+    chunk.frames = static_cast<std::uint32_t>(m_time.size());
+    m_chunks.push_back(chunk);
+
+    ColumnarColumnInfo info {};
+    updateStats(m_time.data(), m_time.size(), info);
+    if (encodeTimes(m_time, m_codec.compress, m_encoded) == ColumnEncoding::DELTA)
+        writeColumn(m_encoded.data(), m_encoded.size(), ColumnEncoding::DELTA, info);
+    else
+        writeColumn(m_time.data(), m_time.size() * sizeof(double), ColumnEncoding::RAW, info);
+    m_columnInfo.push_back(info);
+    m_time.clear();
+
+    for (std::size_t c = 0; c < m_columns.size(); ++c)
+    {
+        std::vector<float>& column = m_columns[c];
+        ColumnEncoding encoding { encodeChannel(column, m_codec.quantum[c], m_codec.compress, m_encoded) };
+        updateStats(column.data(), column.size(), info); // After any quantization
+        if (encoding == ColumnEncoding::RAW)
+            writeColumn(column.data(), column.size() * sizeof(float), encoding, info);
+        else
+            writeColumn(m_encoded.data(), m_encoded.size(), encoding, info);
+        m_columnInfo.push_back(info);
+        column.clear();
+    }
+}
+
+bool TelemetryColumnWriter::close()
+{
+    if (!m_file.is_open()) { return false; }
+    flushChunk();
+
+    static const char padding[COLUMN_ALIGNMENT] {};
+    std::uint64_t pad { (COLUMN_ALIGNMENT - m_offset % COLUMN_ALIGNMENT) % COLUMN_ALIGNMENT };
+    m_file.write(padding, static_cast<std::streamsize>(pad));
+    m_offset += pad;
+
+    const std::uint64_t footerOffset { m_offset };
+    m_file.write(reinterpret_cast<const char*>(m_chunks.data()),
+                 static_cast<std::streamsize>(m_chunks.size() * sizeof(ColumnarChunkInfo)));
+    m_file.write(reinterpret_cast<const char*>(m_columnInfo.data()),
+                 static_cast<std::streamsize>(m_columnInfo.size() * sizeof(ColumnarColumnInfo)));
+    m_file.write(reinterpret_cast<const char*>(&footerOffset), sizeof(footerOffset));
+    m_file.write("CTLC", 4);
+
+    bool ok { static_cast<bool>(m_file) };
+    m_file.close();
+    return ok;
+}
+
+bool TelemetryColumnWriter::good() const { return static_cast<bool>(m_file); }
+
+std::uint64_t TelemetryColumnWriter::getFrames() const { return m_frames; }
+
+std::uint64_t TelemetryColumnWriter::getFlushedFrames() const { return m_frames - m_time.size(); }
+
+TelemetryColumnReader::~TelemetryColumnReader() { close(); }
+
+void TelemetryColumnReader::close()
+{
+    if (m_map) { munmap(const_cast<std::uint8_t*>(m_map), m_size); }
+    m_map = nullptr;
+    m_size = 0;
+    m_frames = 0;
+    m_chunks.clear();
+    m_columnInfo = nullptr;
+    m_decoded.clear();
+}
+
+bool TelemetryColumnReader::open(const std::string& path, std::string& error)
+{
+    close();
+
+    int fd { ::open(path.c_str(), O_RDONLY) };
+    if (fd < 0)
+    {
+        error = "Cannot open " + path;
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(HEADER_SIZE + TRAILER_SIZE))
+    {
+        ::close(fd);
+        error = path + ": not a columnar telemetry file";
+        return false;
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    void* map { mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0) };
+    ::close(fd); // The mapping keeps the file alive
+    if (map == MAP_FAILED)
+    {
+        m_size = 0;
+        error = "Cannot map " + path;
+        return false;
+    }
+    m_map = static_cast<const std::uint8_t*>(map);
+
+    auto fail = [&](const std::string& why) {
+        close();
+        error = path + ": " + why;
+        return false;
+    };
+
+    std::uint32_t version { 0 }, channels { 0 };
+    std::memcpy(&version, m_map + 4, sizeof(version));
+    std::memcpy(&m_chunkFrames, m_map + 8, sizeof(m_chunkFrames));
+    std::memcpy(&channels, m_map + 12, sizeof(channels));
+    if (std::memcmp(m_map, "CTLC", 4) != 0 || std::memcmp(m_map + m_size - 4, "CTLC", 4) != 0)
+        return fail("not a columnar telemetry file (or it was not closed)");
+    if (version < 1 || version > COLUMNAR_FILE_VERSION)
+        return fail("unsupported version " + std::to_string(version));
+    if (channels != TELEMETRY_CHANNELS || m_chunkFrames == 0)
+        return fail("unexpected layout");
+
+    std::uint64_t footerOffset { 0 };
+    std::memcpy(&footerOffset, m_map + m_size - TRAILER_SIZE, sizeof(footerOffset));
+    const std::uint64_t footerBytes { m_size - TRAILER_SIZE - footerOffset };
+    const std::uint64_t perChunk { sizeof(ColumnarChunkInfo) + COLUMNS_PER_CHUNK * sizeof(ColumnarColumnInfo) };
+    if (footerOffset < HEADER_SIZE || footerOffset > m_size - TRAILER_SIZE || footerBytes % perChunk != 0)
+        return fail("corrupt footer");
+
+    const std::size_t chunks { static_cast<std::size_t>(footerBytes / perChunk) };
+    m_chunks.resize(chunks);
+    std::memcpy(m_chunks.data(), m_map + footerOffset, chunks * sizeof(ColumnarChunkInfo));
+    m_columnInfo = reinterpret_cast<const ColumnarColumnInfo*>(m_map + footerOffset + chunks * sizeof(ColumnarChunkInfo));
+
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+        if (m_chunks[c].frames == 0 || m_chunks[c].frames > m_chunkFrames
+            || (c + 1 < chunks && m_chunks[c].frames != m_chunkFrames))
+            return fail("corrupt chunk index");
+        for (int k = 0; k < COLUMNS_PER_CHUNK; ++k)
+        {
+            const ColumnarColumnInfo& info = column(c, k);
+            std::size_t width { (k == 0) ? sizeof(double) : sizeof(float) };
+            bool raw { info.encoding == static_cast<std::uint32_t>(ColumnEncoding::RAW) };
+            bool known { raw || info.encoding == static_cast<std::uint32_t>(ColumnEncoding::DELTA)
+                         || (k > 0 && info.encoding == static_cast<std::uint32_t>(ColumnEncoding::QUANTIZED)) };
+            if (!known || (raw && (info.bytes != m_chunks[c].frames * width || info.offset % width != 0))
+                || info.offset < HEADER_SIZE || info.offset + info.bytes > footerOffset)
+                return fail("corrupt column index");
+        }
+        m_frames += m_chunks[c].frames;
+    }
+    m_decoded.resize(COLUMNS_PER_CHUNK);
+    return true;
+}
+
+std::uint64_t TelemetryColumnReader::frameCount() const { return m_frames; }
+
+std::size_t TelemetryColumnReader::chunkCount() const { return m_chunks.size(); }
+
+double TelemetryColumnReader::startTime() const { return m_chunks.empty() ? 0.0 : m_chunks.front().firstTime; }
+
+double TelemetryColumnReader::endTime() const { return m_chunks.empty() ? 0.0 : m_chunks.back().lastTime; }
+
+const ColumnarColumnInfo& TelemetryColumnReader::column(std::size_t chunk, int column) const
+{
+    return m_columnInfo[chunk * COLUMNS_PER_CHUNK + static_cast<std::size_t>(column)];
+}
+
+const double* TelemetryColumnReader::timeColumn(std::size_t chunk) const
+{
+    const ColumnarColumnInfo& info = column(chunk, 0);
+    if (info.encoding == static_cast<std::uint32_t>(ColumnEncoding::RAW))
+        return reinterpret_cast<const double*>(m_map + info.offset);
+
+    DecodedColumn& cache = m_decoded[0];
+    if (cache.chunk != chunk)
+    {
+        cache.times.resize(m_chunks[chunk].frames);
+        // The footer was validated; a stream that still fails to decode reads as zeros
+        if (!decodeTimeColumn(m_map + info.offset, info.bytes, cache.times.size(), cache.times.data()))
+            std::fill(cache.times.begin(), cache.times.end(), 0.0);
+        cache.chunk = chunk;
+    }
+    return cache.times.data();
+}
+
+const float* TelemetryColumnReader::channelColumn(std::size_t chunk, TelemetryChannel channel) const
+{
+    const int k { 1 + static_cast<int>(channel) };
+    const ColumnarColumnInfo& info = column(chunk, k);
+    if (info.encoding == static_cast<std::uint32_t>(ColumnEncoding::RAW))
+        return reinterpret_cast<const float*>(m_map + info.offset);
+
+    DecodedColumn& cache = m_decoded[static_cast<std::size_t>(k)];
+    if (cache.chunk != chunk)
+    {
+        cache.values.resize(m_chunks[chunk].frames);
+        bool ok { (info.encoding == static_cast<std::uint32_t>(ColumnEncoding::QUANTIZED))
+                      ? decodeQuantizedColumn(m_map + info.offset, info.bytes, cache.values.size(), cache.values.data())
+                      : decodeFloatColumn(m_map + info.offset, info.bytes, cache.values.size(), cache.values.data()) };
+        if (!ok) { std::fill(cache.values.begin(), cache.values.end(), 0.0f); }
+        cache.chunk = chunk;
+    }
+    return cache.values.data();
+}
+
+std::size_t TelemetryColumnReader::chunkOf(std::uint64_t frame) const
+{
+    return static_cast<std::size_t>(frame / m_chunkFrames);
+}
+
+std::uint64_t TelemetryColumnReader::findFrame(double time) const
+{
+    if (m_chunks.empty()) { return 0; }
+
+    // Last chunk starting at or before `time`
+    auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), time,
+                               [](double t, const ColumnarChunkInfo& c) { return t < c.firstTime; });
+    if (it == m_chunks.begin()) { return 0; }
+    std::size_t chunk { static_cast<std::size_t>(it - m_chunks.begin()) - 1 };
+
+    const double* times = timeColumn(chunk);
+    const double* end = times + m_chunks[chunk].frames;
+    std::size_t within { static_cast<std::size_t>(std::upper_bound(times, end, time) - times) - 1 };
+    return static_cast<std::uint64_t>(chunk) * m_chunkFrames + within;
+}
+
+double TelemetryColumnReader::time(std::uint64_t frame) const
+{
+    return timeColumn(chunkOf(frame))[frame % m_chunkFrames];
+}
+
+float TelemetryColumnReader::value(TelemetryChannel channel, std::uint64_t frame) const
+{
+    return channelColumn(chunkOf(frame), channel)[frame % m_chunkFrames];
+}
+
+TelemetryFrame TelemetryColumnReader::frame(std::uint64_t frame) const
+{
+    TelemetryFrame f {};
+    f.time = time(frame);
+    for (int c = 0; c < TELEMETRY_CHANNELS; ++c)
+    {
+        TelemetryChannel channel { static_cast<TelemetryChannel>(c) };
+        setChannelValue(f, channel, value(channel, frame));
+    }
+    return f;
+}
+
+ChannelSummary TelemetryColumnReader::summarize(TelemetryChannel channel, double t0, double t1) const
+{
+    ChannelSummary summary;
+    summary.min = std::numeric_limits<double>::infinity();
+    summary.max = -std::numeric_limits<double>::infinity();
+    double sum { 0.0 };
+
+    const int k { 1 + static_cast<int>(channel) };
+    for (std::size_t c = 0; c < m_chunks.size(); ++c)
+    {
+        const ColumnarChunkInfo& chunk = m_chunks[c];
+        if (chunk.lastTime < t0) { continue; }
+        if (chunk.firstTime > t1) { break; }
+
+        if (chunk.firstTime >= t0 && chunk.lastTime <= t1)
+        {
+            const ColumnarColumnInfo& info = column(c, k);
+            summary.count += chunk.frames;
+            summary.min = std::min(summary.min, info.min);
+            summary.max = std::max(summary.max, info.max);
+            sum += info.sum;
+            continue;
+        }
+
+        // Edge chunk: only the frames inside the range
+        ++summary.chunksScanned;
+        const double* times = timeColumn(c);
+        const float* values = channelColumn(c, channel);
+        std::size_t begin { static_cast<std::size_t>(std::lower_bound(times, times + chunk.frames, t0) - times) };
+        std::size_t end { static_cast<std::size_t>(std::upper_bound(times, times + chunk.frames, t1) - times) };
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            double v { static_cast<double>(values[i]) };
+            summary.min = std::min(summary.min, v);
+            summary.max = std::max(summary.max, v);
+            sum += v;
+        }
+        summary.count += end - begin;
+    }
+
+    if (summary.count == 0)
+    {
+        summary.min = summary.max = 0.0;
+        return summary;
+    }
+    summary.mean = sum / static_cast<double>(summary.count);
+    return summary;
+}
+
+namespace
+{
+    bool openRecording(std::ifstream& in, const std::string& rawPath, std::string& error)
+    {
+        in.open(rawPath, std::ios::binary);
+        if (!in)
+        {
+            error = "Cannot open " + rawPath;
+            return false;
+        }
+
+        char magic[4] {};
+        std::uint32_t version { 0 }, frameSize { 0 };
+        in.read(magic, 4);
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&frameSize), sizeof(frameSize));
+        if (!in || std::memcmp(magic, "CTLM", 4) != 0 || version != TELEMETRY_FILE_VERSION
+            || frameSize != sizeof(TelemetryFrame))
+        {
+            error = rawPath + ": not a version " + std::to_string(TELEMETRY_FILE_VERSION) + " telemetry recording";
+            return false;
+        }
+        return true;
+    }
+}
+
+bool readTelemetryFrames(const std::string& rawPath, std::vector<TelemetryFrame>& frames, std::string& error)
+{
+    std::ifstream in;
+    if (!openRecording(in, rawPath, error)) { return false; }
+
+    frames.clear();
+    TelemetryFrame f {};
+    while (in.read(reinterpret_cast<char*>(&f), sizeof(f)))
+        frames.push_back(f);
+    return true;
+}
+
+bool convertTelemetryToColumns(const std::string& rawPath, const std::string& columnarPath,
+                               std::uint32_t chunkFrames, const ColumnarCodec& codec, std::string& error)
+{
+    std::ifstream in;
+    if (!openRecording(in, rawPath, error)) { return false; }
+
+    TelemetryColumnWriter writer;
+    if (!writer.open(columnarPath, chunkFrames, codec))
+    {
+        error = "Cannot open " + columnarPath;
+        return false;
+    }
+
+    std::vector<TelemetryFrame> block(4096);
+    while (in)
+    {
+        in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(TelemetryFrame)));
+        // A trailing partial frame (recording cut short) is ignored
+        std::size_t frames { static_cast<std::size_t>(in.gcount()) / sizeof(TelemetryFrame) };
+        writer.append(block.data(), frames);
+    }
+
+    if (!writer.close())
+    {
+        error = "Cannot write " + columnarPath;
+        return false;
+    }
+    return true;
+}
+
+CodecBenchmark benchmarkTelemetryCodec(const std::vector<TelemetryFrame>& frames, const ColumnarCodec& codec,
+                                       std::uint32_t chunkFrames)
+{
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+
+    CodecBenchmark result;
+    result.frames = frames.size();
+    chunkFrames = std::max<std::uint32_t>(1, chunkFrames);
+
+    std::vector<double> times, decodedTimes;
+    std::vector<std::vector<float>> input(TELEMETRY_CHANNELS), stored(TELEMETRY_CHANNELS);
+    std::vector<float> decoded;
+    std::vector<std::vector<std::uint8_t>> encoded(COLUMNS_PER_CHUNK);
+    std::vector<ColumnEncoding> encodings(COLUMNS_PER_CHUNK);
+
+    for (std::size_t first = 0; first < frames.size(); first += chunkFrames)
+    {
+        std::size_t n { std::min<std::size_t>(chunkFrames, frames.size() - first) };
+        times.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+            times[i] = frames[first + i].time;
+        for (int c = 0; c < TELEMETRY_CHANNELS; ++c)
+        {
+            std::vector<float>& column = input[static_cast<std::size_t>(c)];
+            column.resize(n);
+            for (std::size_t i = 0; i < n; ++i)
+                column[i] = channelValue(frames[first + i], static_cast<TelemetryChannel>(c));
+            stored[static_cast<std::size_t>(c)] = column;
+        }
+        result.rawBytes += n * (sizeof(double) + TELEMETRY_CHANNELS * sizeof(float));
+
+        auto encodeStart = Clock::now();
+        encodings[0] = encodeTimes(times, codec.compress, encoded[0]);
+        for (std::size_t c = 0; c < stored.size(); ++c)
+            encodings[c + 1] = encodeChannel(stored[c], codec.quantum[c], codec.compress, encoded[c + 1]);
+        result.encodeSeconds += seconds(Clock::now() - encodeStart);
+
+        result.encodedBytes += (encodings[0] == ColumnEncoding::RAW) ? n * sizeof(double) : encoded[0].size();
+        for (std::size_t c = 0; c < stored.size(); ++c)
+            result.encodedBytes += (encodings[c + 1] == ColumnEncoding::RAW) ? n * sizeof(float) : encoded[c + 1].size();
+
+        decodedTimes.resize(n);
+        decoded.resize(n);
+        if (encodings[0] == ColumnEncoding::DELTA)
+        {
+            auto decodeStart = Clock::now();
+            result.roundTrip &= decodeTimeColumn(encoded[0].data(), encoded[0].size(), n, decodedTimes.data());
+            result.decodeSeconds += seconds(Clock::now() - decodeStart);
+            result.roundTrip &= std::memcmp(decodedTimes.data(), times.data(), n * sizeof(double)) == 0;
+        }
+        for (std::size_t c = 0; c < stored.size(); ++c)
+        {
+            const std::vector<std::uint8_t>& bytes = encoded[c + 1];
+            if (encodings[c + 1] == ColumnEncoding::RAW) { continue; }
+
+            auto decodeStart = Clock::now();
+            result.roundTrip &= (encodings[c + 1] == ColumnEncoding::QUANTIZED)
+                ? decodeQuantizedColumn(bytes.data(), bytes.size(), n, decoded.data())
+                : decodeFloatColumn(bytes.data(), bytes.size(), n, decoded.data());
+            result.decodeSeconds += seconds(Clock::now() - decodeStart);
+            result.roundTrip &= std::memcmp(decoded.data(), stored[c].data(), n * sizeof(float)) == 0;
+        }
+
+        for (std::size_t c = 0; c < stored.size(); ++c)
+            for (std::size_t i = 0; i < n; ++i)
+                result.maxError[c] = std::max(result.maxError[c],
+                                              std::abs(static_cast<double>(stored[c][i]) - input[c][i]));
+    }
+    return result;
+}
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "constants.h"
+#include "profiler.h"
 #include "telemetry_display.h"
 
 TelemetryDisplay::TelemetryDisplay(TextRenderer& textRenderer, Shader& shader, float scale)
@@ -98,6 +99,8 @@ void TelemetryDisplay::renderSection(TelemetryPosition pos, int windowWidth, int
 void TelemetryDisplay::updateAndRender(const glm::vec3& torque, float angVelX, float angVelY, float angVelZ,
                                        float altitude, float elapsedTime, float winWidth, float winHeight) 
 { 
+    PROFILE_ZONE("TelemetryDisplay::updateAndRender");
+
     auto addSpace = [](float v) {
 
         if (std::abs(v) < 1e-7f) { v = 0.0f; } // use epislon value to treat small negative nums as +0
@@ -0,0 +1,193 @@
+#include "telemetry_downlink.h"
+#include "ccsds.h"
+#include "constants.h"
+#include "simulation_state.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double altitudeOf(const TelemetryFrame& frame)
+    {
+        return glm::length(glm::vec3(frame.position[0], frame.position[1], frame.position[2])) - Physics::EARTH_RADIUS;
+    }
+}
+
+std::size_t writeDownlinkPacket(std::uint8_t* out, DownlinkContent content, std::uint16_t apid,
+                                std::uint16_t sequenceCount, const TelemetryFrame& frame)
+{
+    // User data goes straight into its final place after the headers
+    std::uint8_t* data { out + CCSDS_HEADERS_SIZE };
+    std::size_t size { 0 };
+    if (content == DownlinkContent::HOUSEKEEPING)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            putBigEndian(data + 4 * i, frame.reactionTorque[i]);
+            putBigEndian(data + 12 + 4 * i, frame.wheelSpeeds[i]);
+        }
+        putBigEndian(data + 24, static_cast<float>(altitudeOf(frame)));
+        size = HOUSEKEEPING_DATA_SIZE;
+    }
+    else
+    {
+        for (int i = 0; i < 4; ++i)
+            putBigEndian(data + 4 * i, frame.attitude[i]);
+        for (int i = 0; i < 3; ++i)
+            putBigEndian(data + 16 + 4 * i, frame.bodyRates[i]);
+        data[28] = frame.mode;
+        data[29] = data[30] = data[31] = 0;
+        size = ATTITUDE_DATA_SIZE;
+    }
+    return writeSpacePacket(out, apid, sequenceCount, frame.time, data, size);
+}
+
+TelemetryDownlink::TelemetryDownlink(const DownlinkConfig& config)
+    : m_config { config }, m_sender { config.batchSize, CCSDS_HEADERS_SIZE + ATTITUDE_DATA_SIZE }
+{
+    for (const DownlinkStream& stream : config.streams)
+    {
+        if (stream.rate > 0.0f) { m_streams.push_back({ stream }); }
+    }
+}
+
+bool TelemetryDownlink::open(std::string& error) { return m_sender.open(m_config.host, m_config.port, error); }
+
+void TelemetryDownlink::update(const SimulationState& state)
+{
+    const double now { state.simElapsedTime };
+    bool haveFrame { false };
+    TelemetryFrame frame {};
+
+    for (StreamState& s : m_streams)
+    {
+        if (!s.started)
+        {
+            s.nextTime = now;
+            s.started = true;
+        }
+        if (now < s.nextTime) { continue; }
+
+        if (!haveFrame)
+        {
+            frame = makeTelemetryFrame(state);
+            haveFrame = true;
+        }
+        m_sender.commit(writeDownlinkPacket(m_sender.slot(), s.stream.content, s.stream.apid, s.sequence, frame));
+        s.sequence = static_cast<std::uint16_t>((s.sequence + 1) & CCSDS_SEQUENCE_MASK);
+
+        // One packet per step at most; a stream faster than the physics step runs at the step rate
+        const double period { 1.0 / s.stream.rate };
+        s.nextTime = std::max(s.nextTime + period, now);
+    }
+    m_sender.flush();
+}
+
+const UdpSender& TelemetryDownlink::getSender() const { return m_sender; }
+
+DownlinkLoadReport runDownlinkLoadTest(const DownlinkConfig& config, const std::vector<OrbitSample>& constellation,
+                                       std::uint16_t firstApid, double rate, double seconds)
+{
+    DownlinkLoadReport report;
+    UdpSender sender(config.batchSize, CCSDS_HEADERS_SIZE + HOUSEKEEPING_DATA_SIZE);
+    std::string error;
+    if (constellation.empty() || !sender.open(config.host, config.port, error)) { return report; }
+
+    std::vector<KeplerPropagator> orbits;
+    orbits.reserve(constellation.size());
+    for (const OrbitSample& s : constellation)
+        orbits.emplace_back(s);
+
+    const std::size_t satellites { constellation.size() };
+    const double epoch { constellation.front().time };
+    const bool paced { rate > 0.0 };
+    const double nominalRate { paced ? rate : 1.0 };
+
+    auto start = Clock::now();
+    auto elapsed = [&start] { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    std::uint64_t sent { 0 };
+    double now { 0.0 };
+    while ((now = elapsed()) < seconds)
+    {
+        // Everything due by now, round-robin over the satellites; unpaced runs a batch at a time
+        std::uint64_t due { paced ? static_cast<std::uint64_t>(now * rate * static_cast<double>(satellites))
+                                  : sent + config.batchSize };
+        if (sent >= due)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            continue;
+        }
+        if (paced)
+        {
+            double scheduled { static_cast<double>(sent) / (rate * static_cast<double>(satellites)) };
+            report.lateSeconds = std::max(report.lateSeconds, now - scheduled);
+        }
+
+        for (; sent < due; ++sent)
+        {
+            std::size_t index { static_cast<std::size_t>(sent % satellites) };
+            std::uint64_t count { sent / satellites };
+            double time { epoch + static_cast<double>(count) / nominalRate };
+
+            OrbitSample s = orbits[index].state(time);
+            TelemetryFrame frame {};
+            frame.time = time;
+            for (int i = 0; i < 3; ++i)
+            {
+                frame.position[i] = static_cast<float>(s.pos[i]);
+                frame.velocity[i] = static_cast<float>(s.vel[i]);
+            }
+            frame.attitude[0] = 1.0f;
+
+            auto apid = static_cast<std::uint16_t>((firstApid + index) % CCSDS_IDLE_APID);
+            auto sequence = static_cast<std::uint16_t>(count & CCSDS_SEQUENCE_MASK);
+            sender.commit(writeDownlinkPacket(sender.slot(), DownlinkContent::HOUSEKEEPING, apid, sequence, frame));
+        }
+    }
+    sender.flush();
+
+    report.seconds = elapsed();
+    report.packets = sender.getPackets();
+    report.bytes = sender.getBytes();
+    report.syscalls = sender.getSyscalls();
+    report.dropped = sender.getDropped();
+    return report;
+}
+
+bool listenDownlink(int port, double seconds, DownlinkListenReport& report, std::string& error)
+{
+    UdpReceiver receiver;
+    if (!receiver.open(port, error)) { return false; }
+
+    std::map<std::uint16_t, std::uint16_t> nextSequence;
+    auto handle = [&](const std::uint8_t* data, std::size_t size) {
+        CcsdsPacketInfo info;
+        if (!parseSpacePacket(data, size, info) || info.packetSize != size)
+        {
+            ++report.malformed;
+            return;
+        }
+        ++report.packets;
+        report.bytes += size;
+        ++report.perApid[info.apid];
+
+        auto it = nextSequence.find(info.apid);
+        if (it != nextSequence.end())
+            report.sequenceGaps += (info.sequenceCount - it->second) & CCSDS_SEQUENCE_MASK;
+        nextSequence[info.apid] = static_cast<std::uint16_t>((info.sequenceCount + 1) & CCSDS_SEQUENCE_MASK);
+    };
+
+    auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    while (Clock::now() < end)
+    {
+        int remainingMs { static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - Clock::now()).count()) };
+        receiver.receive(std::clamp(remainingMs, 0, 100), handle);
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#include "telemetry_recorder.h"
+#include "simulation_state.h"
+#include "telemetry_columns.h"
+
+#include <chrono>
+#include <string_view>
+
+TelemetryFrame makeTelemetryFrame(const SimulationState& state)
+{
+    const glm::vec3 position = state.cubesatPos / SCALE_FACTOR;
+    const glm::quat& q = state.cubesatOrientation;
+    const glm::vec3 bodyRates = glm::conjugate(q) * state.cubesatAngularVel;
+    const std::array<float, 3> wheelSpeeds = state.wheels.getSpeeds();
+    const glm::vec3 torque = state.wheels.getTorque();
+
+    TelemetryFrame f {};
+    f.time = state.simElapsedTime;
+    f.attitude[0] = q.w;
+    for (int i = 0; i < 3; ++i)
+    {
+        f.position[i] = position[i];
+        f.velocity[i] = state.cubesatVel[i];
+        f.attitude[i + 1] = q[i];
+        f.bodyRates[i] = bodyRates[i];
+        f.wheelSpeeds[i] = wheelSpeeds[static_cast<std::size_t>(i)];
+        f.reactionTorque[i] = torque[i];
+    }
+    f.mode = static_cast<std::uint8_t>(state.adcs.getMode());
+    return f;
+}
+
+TelemetryRecorder::TelemetryRecorder(std::size_t capacity)
+    : m_ring { capacity }
+{
+}
+
+TelemetryRecorder::~TelemetryRecorder() { stop(); }
+
+bool TelemetryRecorder::open(const std::string& path) { return open(path, ColumnarCodec {}); }
+
+bool TelemetryRecorder::open(const std::string& path, const ColumnarCodec& codec)
+{
+    constexpr std::string_view columnarExtension { ".tlc" };
+    bool columnar { path.size() >= columnarExtension.size()
+                    && path.compare(path.size() - columnarExtension.size(), columnarExtension.size(),
+                                    columnarExtension) == 0 };
+    if (columnar)
+    {
+        m_columns = std::make_unique<TelemetryColumnWriter>();
+        if (!m_columns->open(path, COLUMNAR_DEFAULT_CHUNK, codec))
+        {
+            m_columns.reset();
+            return false;
+        }
+    }
+    else
+    {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file) { return false; }
+
+        const std::uint32_t frameSize { sizeof(TelemetryFrame) };
+        m_file.write("CTLM", 4);
+        m_file.write(reinterpret_cast<const char*>(&TELEMETRY_FILE_VERSION), sizeof(TELEMETRY_FILE_VERSION));
+        m_file.write(reinterpret_cast<const char*>(&frameSize), sizeof(frameSize));
+    }
+
+    m_path = path;
+    m_error.clear();
+    m_failed = false;
+    m_running = true;
+    m_writer = std::thread(&TelemetryRecorder::writerLoop, this);
+    return true;
+}
+
+void TelemetryRecorder::record(const SimulationState& state)
+{
+    if (!m_running.load(std::memory_order_relaxed)) { return; }
+
+    ++m_recorded;
+    if (m_failed.load(std::memory_order_relaxed) || !m_ring.tryPush(makeTelemetryFrame(state))) { ++m_dropped; }
+}
+
+void TelemetryRecorder::writerLoop()
+{
+    // Keeps going after stop() is requested until the ring is empty
+    while (true)
+    {
+        bool stopping { !m_running.load(std::memory_order_acquire) };
+
+        const TelemetryFrame* frames { nullptr };
+        std::size_t count { m_ring.peek(frames) };
+        if (count > 0)
+        {
+            if (m_columns) { m_columns->append(frames, count); }
+            else { m_file.write(reinterpret_cast<const char*>(frames), static_cast<std::streamsize>(count * sizeof(TelemetryFrame))); }
+            m_ring.consume(count);
+
+            if (m_columns ? !m_columns->good() : !m_file)
+            {
+                // Stop at the first failure; record() drops everything after it
+                m_error = "Cannot write " + m_path;
+                m_failed.store(true, std::memory_order_relaxed);
+                break;
+            }
+            if (m_columns) { m_written.store(m_columns->getFlushedFrames(), std::memory_order_relaxed); }
+            else { m_written.fetch_add(count, std::memory_order_relaxed); }
+            continue;
+        }
+        if (stopping) { break; }
+
+        // Nothing to write; a short nap costs the writer far less than spinning
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    bool closed { m_columns ? m_columns->close() : static_cast<bool>(m_file.flush()) };
+    if (!closed && m_error.empty())
+    {
+        m_error = "Cannot write " + m_path;
+        m_failed.store(true, std::memory_order_relaxed);
+    }
+    else if (closed && m_columns)
+    {
+        m_written.store(m_columns->getFrames(), std::memory_order_relaxed);
+    }
+}
+
+bool TelemetryRecorder::stop()
+{
+    if (m_writer.joinable())
+    {
+        m_running.store(false, std::memory_order_release);
+        m_writer.join();
+        m_file.close();
+    }
+    return !m_failed.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TelemetryRecorder::getRecorded() const { return m_recorded; }
+
+std::uint64_t TelemetryRecorder::getDropped() const { return m_dropped; }
+
+std::uint64_t TelemetryRecorder::getWritten() const { return m_written.load(std::memory_order_relaxed); }
+
+const std::string& TelemetryRecorder::getError() const { return m_error; }
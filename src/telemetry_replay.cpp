@@ -0,0 +1,143 @@
+#include "telemetry_replay.h"
+#include "simulation_state.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    glm::dvec3 vec(const float* v) { return glm::dvec3(v[0], v[1], v[2]); }
+
+    void store(const glm::dvec3& v, float* out)
+    {
+        for (int i = 0; i < 3; ++i)
+            out[i] = static_cast<float>(v[i]);
+    }
+
+    glm::quat attitudeOf(const TelemetryFrame& f)
+    {
+        return glm::quat(f.attitude[0], f.attitude[1], f.attitude[2], f.attitude[3]);
+    }
+
+    bool endsWith(const std::string& s, const std::string& suffix)
+    {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+bool TelemetryReplay::open(const std::string& path, std::string& error)
+{
+    m_frames.clear();
+    m_columnar = endsWith(path, ".tlc");
+    if (m_columnar)
+    {
+        if (!m_columns.open(path, error)) { return false; }
+    }
+    else if (!readTelemetryFrames(path, m_frames, error))
+    {
+        return false;
+    }
+
+    if (frameCount() == 0)
+    {
+        error = path + ": no frames";
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t TelemetryReplay::frameCount() const
+{
+    return m_columnar ? m_columns.frameCount() : m_frames.size();
+}
+
+double TelemetryReplay::startTime() const { return frame(0).time; }
+
+double TelemetryReplay::endTime() const { return frame(frameCount() - 1).time; }
+
+TelemetryFrame TelemetryReplay::frame(std::uint64_t index) const
+{
+    return m_columnar ? m_columns.frame(index) : m_frames[static_cast<std::size_t>(index)];
+}
+
+std::uint64_t TelemetryReplay::findFrame(double time) const
+{
+    if (m_columnar) { return m_columns.findFrame(time); }
+
+    auto it = std::upper_bound(m_frames.begin(), m_frames.end(), time,
+                               [](double t, const TelemetryFrame& f) { return t < f.time; });
+    return (it == m_frames.begin()) ? 0 : static_cast<std::uint64_t>(it - m_frames.begin()) - 1;
+}
+
+TelemetryFrame TelemetryReplay::sample(double time) const
+{
+    std::uint64_t i { findFrame(time) };
+    const TelemetryFrame a = frame(i);
+    if (i + 1 >= frameCount() || time <= a.time) { return a; }
+
+    const TelemetryFrame b = frame(i + 1);
+    const double h { b.time - a.time };
+    if (h <= 0.0) { return a; }
+    const double s { std::clamp((time - a.time) / h, 0.0, 1.0) };
+
+    TelemetryFrame f = a;
+    f.time = time;
+
+    // Hermite basis; velocities are per second, so scale the tangents by the interval
+    double s2 { s * s }, s3 { s2 * s };
+    double h00 { 2.0 * s3 - 3.0 * s2 + 1.0 }, h10 { s3 - 2.0 * s2 + s };
+    double h01 { -2.0 * s3 + 3.0 * s2 }, h11 { s3 - s2 };
+    store(h00 * vec(a.position) + h10 * h * vec(a.velocity) + h01 * vec(b.position) + h11 * h * vec(b.velocity),
+          f.position);
+
+    store(glm::mix(vec(a.velocity), vec(b.velocity), s), f.velocity);
+    store(glm::mix(vec(a.bodyRates), vec(b.bodyRates), s), f.bodyRates);
+    store(glm::mix(vec(a.wheelSpeeds), vec(b.wheelSpeeds), s), f.wheelSpeeds);
+    store(glm::mix(vec(a.reactionTorque), vec(b.reactionTorque), s), f.reactionTorque);
+
+    glm::quat q = glm::normalize(glm::slerp(attitudeOf(a), attitudeOf(b), static_cast<float>(s)));
+    f.attitude[0] = q.w;
+    f.attitude[1] = q.x;
+    f.attitude[2] = q.y;
+    f.attitude[3] = q.z;
+    return f;
+}
+
+void applyTelemetryFrame(const TelemetryFrame& frame, SimulationState& state)
+{
+    state.simElapsedTime = frame.time;
+    state.cubesatPos = glm::vec3(frame.position[0], frame.position[1], frame.position[2]) * SCALE_FACTOR;
+    state.cubesatVel = glm::vec3(frame.velocity[0], frame.velocity[1], frame.velocity[2]);
+    state.cubesatOrientation = attitudeOf(frame);
+    state.cubesatAngularVel = state.cubesatOrientation * glm::vec3(frame.bodyRates[0], frame.bodyRates[1], frame.bodyRates[2]);
+}
+
+ReplayClock::ReplayClock(double startTime, double endTime, double speed)
+    : m_start { startTime }, m_end { endTime }, m_time { speed < 0.0 ? endTime : startTime }, m_speed { speed }
+{
+}
+
+void ReplayClock::advance(double wallSeconds)
+{
+    if (m_paused) { return; }
+
+    m_time += wallSeconds * m_speed;
+    if (m_time <= m_start || m_time >= m_end)
+    {
+        m_time = std::clamp(m_time, m_start, m_end);
+        m_paused = true;
+    }
+}
+
+void ReplayClock::seek(double time) { m_time = std::clamp(time, m_start, m_end); }
+
+void ReplayClock::setSpeed(double speed) { m_speed = speed; }
+
+void ReplayClock::togglePause() { m_paused = !m_paused; }
+
+double ReplayClock::getTime() const { return m_time; }
+
+double ReplayClock::getSpeed() const { return m_speed; }
+
+bool ReplayClock::isPaused() const { return m_paused; }
@@ -0,0 +1,212 @@
+#include "udp_downlink.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace
+{
+    bool resolve(const std::string& host, int port, sockaddr_in& addr)
+    {
+        addrinfo hints {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* found { nullptr };
+        if (::getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || found == nullptr) { return false; }
+
+        std::memcpy(&addr, found->ai_addr, sizeof(addr));
+        addr.sin_port = htons(static_cast<std::uint16_t>(port));
+        ::freeaddrinfo(found);
+        return true;
+    }
+}
+
+UdpSender::UdpSender(std::size_t batchSize, std::size_t maxDatagram)
+    : m_batchSize { std::max<std::size_t>(1, batchSize) }, m_maxDatagram { maxDatagram },
+      m_arena(m_batchSize * maxDatagram), m_sizes(m_batchSize)
+{
+}
+
+UdpSender::~UdpSender() { close(); }
+
+bool UdpSender::open(const std::string& host, int port, std::string& error)
+{
+    sockaddr_in addr {};
+    if (port <= 0 || port > 65535 || !resolve(host, port, addr))
+    {
+        error = "Bad downlink address " + host + ":" + std::to_string(port);
+        return false;
+    }
+
+    m_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_fd < 0 || ::connect(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        error = "Downlink socket to " + host + ":" + std::to_string(port) + " failed: " + std::strerror(errno);
+        close();
+        return false;
+    }
+
+    // A deep send buffer absorbs bursts from the load test
+    int buffer { 4 << 20 };
+    ::setsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+    return true;
+}
+
+void UdpSender::close()
+{
+    if (m_fd >= 0)
+    {
+        flush();
+        ::close(m_fd);
+    }
+    m_fd = -1;
+}
+
+std::uint8_t* UdpSender::slot() { return m_arena.data() + m_queued * m_maxDatagram; }
+
+void UdpSender::commit(std::size_t size)
+{
+    m_sizes[m_queued++] = size;
+    if (m_queued == m_batchSize) { flush(); }
+}
+
+void UdpSender::flush()
+{
+    if (m_queued == 0) { return; }
+    if (m_fd < 0)
+    {
+        m_dropped += m_queued;
+        m_queued = 0;
+        return;
+    }
+
+    std::size_t next { 0 };
+#if defined(__linux__)
+    mmsghdr messages[256];
+    iovec vectors[256];
+    while (next < m_queued)
+    {
+        unsigned int count { static_cast<unsigned int>(std::min<std::size_t>(m_queued - next, 256)) };
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            vectors[i].iov_base = m_arena.data() + (next + i) * m_maxDatagram;
+            vectors[i].iov_len = m_sizes[next + i];
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent { ::sendmmsg(m_fd, messages, count, 0) };
+        ++m_syscalls;
+        if (sent < 0)
+        {
+            if (errno == EINTR) { continue; }
+            ++m_dropped; // Refused or no buffer space: skip the datagram that failed
+            ++next;
+            continue;
+        }
+        for (int i = 0; i < sent; ++i)
+            m_bytes += m_sizes[next + static_cast<std::size_t>(i)];
+        m_packets += static_cast<std::uint64_t>(sent);
+        next += static_cast<std::size_t>(sent);
+    }
+#else
+    for (; next < m_queued; ++next)
+    {
+        ssize_t n { ::send(m_fd, m_arena.data() + next * m_maxDatagram, m_sizes[next], 0) };
+        ++m_syscalls;
+        if (n < 0)
+        {
+            ++m_dropped;
+            continue;
+        }
+        m_bytes += m_sizes[next];
+        ++m_packets;
+    }
+#endif
+    m_queued = 0;
+}
+
+std::size_t UdpSender::getMaxDatagram() const { return m_maxDatagram; }
+
+std::uint64_t UdpSender::getPackets() const { return m_packets; }
+
+std::uint64_t UdpSender::getBytes() const { return m_bytes; }
+
+std::uint64_t UdpSender::getSyscalls() const { return m_syscalls; }
+
+std::uint64_t UdpSender::getDropped() const { return m_dropped; }
+
+UdpReceiver::UdpReceiver(std::size_t batchSize, std::size_t maxDatagram)
+    : m_batchSize { std::max<std::size_t>(1, batchSize) }, m_maxDatagram { maxDatagram },
+      m_arena(m_batchSize * maxDatagram)
+{
+}
+
+UdpReceiver::~UdpReceiver() { close(); }
+
+bool UdpReceiver::open(int port, std::string& error)
+{
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+
+    m_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    int buffer { 8 << 20 };
+    if (m_fd >= 0) { ::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer)); }
+    if (m_fd < 0 || ::bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        error = "Cannot listen on UDP port " + std::to_string(port) + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpReceiver::close()
+{
+    if (m_fd >= 0) { ::close(m_fd); }
+    m_fd = -1;
+}
+
+std::size_t UdpReceiver::receive(int timeoutMs, const std::function<void(const std::uint8_t*, std::size_t)>& handler)
+{
+    pollfd pfd { m_fd, POLLIN, 0 };
+    if (m_fd < 0 || ::poll(&pfd, 1, timeoutMs) <= 0) { return 0; }
+
+#if defined(__linux__)
+    std::vector<mmsghdr> messages(m_batchSize);
+    std::vector<iovec> vectors(m_batchSize);
+    for (std::size_t i = 0; i < m_batchSize; ++i)
+    {
+        vectors[i].iov_base = m_arena.data() + i * m_maxDatagram;
+        vectors[i].iov_len = m_maxDatagram;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    int received { ::recvmmsg(m_fd, messages.data(), static_cast<unsigned int>(m_batchSize), MSG_DONTWAIT, nullptr) };
+    if (received <= 0) { return 0; }
+    for (int i = 0; i < received; ++i)
+        handler(m_arena.data() + static_cast<std::size_t>(i) * m_maxDatagram, messages[static_cast<std::size_t>(i)].msg_len);
+    return static_cast<std::size_t>(received);
+#else
+    std::size_t received { 0 };
+    while (received < m_batchSize)
+    {
+        ssize_t n { ::recv(m_fd, m_arena.data(), m_maxDatagram, MSG_DONTWAIT) };
+        if (n < 0) { break; }
+        handler(m_arena.data(), static_cast<std::size_t>(n));
+        ++received;
+    }
+    return received;
+#endif
+}